@@ -26,11 +26,54 @@
 #include "inttype.h"
 #include "shellsymbol.h"
 #include "sqints.h"
+#include "kernelregistry.h"
 using namespace infor;
 using namespace inttype;
 using namespace sqints;
+using namespace kernelregistry;
 
-void codeGen(const Infor& infor, const int& oper) 
+/**
+ * generate the variants of the given 4 body integral function (sqints is
+ * the plain one), each variant which could be formed is added to the
+ * registry. The table is in the order the variants are generated: the 
+ * erf one, the same center ones (ab, cd and abcd), the symmetry reduced 
+ * ones and then the ones in their own registries
+ */
+static void variantCodeGen(const Infor& infor, const SQInts& sqints, const int& L1, 
+		const int& L2, const int& L3, const int& L4, const int& oper, KernelRegistry& registry)
+{
+	const int nVar = 15;
+	int kinds[nVar] = {VARIANT_ERF_ONLY, VARIANT_PLAIN, VARIANT_PLAIN, VARIANT_PLAIN, 
+		VARIANT_PLAIN, VARIANT_PLAIN, VARIANT_PLAIN, VARIANT_PLAIN, VARIANT_PLAIN, 
+		VARIANT_GENERAL_CONTRACTION, VARIANT_SIG_PAIR_LIST, VARIANT_PAIR_DATA, 
+		VARIANT_KET_LIST, VARIANT_RANGE_SEPARATED, VARIANT_GEMINAL};
+	int sameCenters[nVar] = {0, SAME_CENTER_BRA, SAME_CENTER_KET, SAME_CENTER_BRA|SAME_CENTER_KET, 
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+	int syms[nVar] = {0, 0, 0, 0, SYM_BRA|SYM_KET|SYM_BRAKET, SYM_BRA|SYM_KET, SYM_BRAKET, 
+		SYM_BRA, SYM_KET, 0, 0, 0, 0, 0, 0};
+	for(int iVar=0; iVar<nVar; iVar++) {
+		SQIntsVariant variant(kinds[iVar],sameCenters[iVar],syms[iVar]);
+
+		// the identical shells of the symmetry reduced variant share
+		// the center, so the same center form is used too
+		if ((variant.symmetry & SYM_BRA) && 
+				sqints.canDoVariant(SQIntsVariant(VARIANT_PLAIN,SAME_CENTER_BRA))) {
+			variant.sameCenter |= SAME_CENTER_BRA;
+		}
+		if ((variant.symmetry & SYM_KET) && 
+				sqints.canDoVariant(SQIntsVariant(VARIANT_PLAIN,SAME_CENTER_KET))) {
+			variant.sameCenter |= SAME_CENTER_KET;
+		}
+
+		// now generate codes
+		if (! sqints.canDoVariant(variant)) continue;
+		SQInts sqintsVariant(infor,L1,L2,L3,L4,oper,variant);
+		sqintsVariant.codeGeneration();
+		registry.addKernel(sqintsVariant.getKernelRecord());
+	}
+}
+
+void codeGen(const Infor& infor, const int& oper, KernelRegistry& registry) 
 {
 	// get the max L from infor
 	int max_L = infor.maxL;
@@ -75,6 +118,9 @@ void codeGen(const Infor& infor, const int& oper)
 				// now generate codes
 				SQInts sqints(infor,L1,S,L2,S,ERI);
 				sqints.codeGeneration();
+				registry.addKernel(sqints.getKernelRecord());
+
+				variantCodeGen(infor,sqints,L1,S,L2,S,ERI,registry);
 			}
 		}
 		return;
@@ -109,6 +155,9 @@ void codeGen(const Infor& infor, const int& oper)
 					// now generate codes
 					SQInts sqints(infor,L1,L2,L3,S,ERI);
 					sqints.codeGeneration();
+					registry.addKernel(sqints.getKernelRecord());
+
+					variantCodeGen(infor,sqints,L1,L2,L3,S,ERI,registry);
 				}
 			}
 		}
@@ -132,6 +181,7 @@ void codeGen(const Infor& infor, const int& oper)
 			// now generate codes
 			SQInts sqints(infor,L1,oper);
 			sqints.codeGeneration();
+			registry.addKernel(sqints.getKernelRecord());
 		}
 	}
 
@@ -168,6 +218,7 @@ void codeGen(const Infor& infor, const int& oper)
 						// now generate codes
 						SQInts sqints(infor,L1,L2,L,oper);
 						sqints.codeGeneration();
+						registry.addKernel(sqints.getKernelRecord());
 					}
 				}
 			}
@@ -190,6 +241,7 @@ void codeGen(const Infor& infor, const int& oper)
 					// now generate codes
 					SQInts sqints(infor,L1,L2,oper);
 					sqints.codeGeneration();
+					registry.addKernel(sqints.getKernelRecord());
 				}
 			}
 		}
@@ -224,6 +276,7 @@ void codeGen(const Infor& infor, const int& oper)
 					// now generate codes
 					SQInts sqints(infor,L1,L2,L3,oper);
 					sqints.codeGeneration();
+					registry.addKernel(sqints.getKernelRecord());
 				}
 			}
 		}
@@ -270,6 +323,9 @@ void codeGen(const Infor& infor, const int& oper)
 				// ahead
 				if (sqints.isFileExist()) continue;
 				sqints.codeGeneration();
+				registry.addKernel(sqints.getKernelRecord());
+
+				variantCodeGen(infor,sqints,L1,L2,L3,L4,oper,registry);
 			}
 		}
 	}
@@ -161,6 +161,15 @@ void HRRInfor::formSubFiles(const SQIntsInfor& infor, const RR& hrr)
 		nLHSLimit = nLHSForHRR2Split;
 	}
 
+	// firstly let's try to cut the rrsq list where the least integrals
+	// are passed between the sub files, see subfilerecord.h
+	const list<RRSQ>& rrsqList = hrr.getRRSQList();
+	bool withMinCut = false;
+	if (minCutSplit) {
+		withMinCut = formSubFilesByMinCut(section,rrsqList,outputSQList,
+				nLHSLimit,splitBalance,subFilesList);
+	}
+
 	//
 	// here we will form the sub file according to the printing order of rrsq list
 	// basically, it's reverse order of rrsqlist
@@ -169,9 +178,11 @@ void HRRInfor::formSubFiles(const SQIntsInfor& infor, const RR& hrr)
 	// this is because the sub file input/output can be only formed when we have
 	// all of sub files formed
 	//
-	const list<RRSQ>& rrsqList = hrr.getRRSQList();
 	for(list<RRSQ>::const_reverse_iterator it=rrsqList.rbegin(); it!=rrsqList.rend(); ++it) {
 
+		// the sub files are already formed
+		if (withMinCut) break;
+
 		// add this RRSQ
 		record.updateFromRRSQ(*it);
 
@@ -279,7 +290,7 @@ void HRRInfor::formSubFiles(const SQIntsInfor& infor, const RR& hrr)
 
 		// now let's see whether we have global result
 		if (hasABCD) {
-			arg = arg + "Double* abcd";
+			arg = arg + infor.getResultArgList();
 		}
 
 		// finally we have to check the ","
@@ -320,6 +331,7 @@ void HRRInfor::formSubFiles(const SQIntsInfor& infor, const RR& hrr)
 }
 
 HRRInfor::HRRInfor(const SQIntsInfor& infor, const RR& hrr):Infor(infor),hrrFileSplit(false),
+	hrrTemplate(infor.useHRRTemplate()),
 	section(hrr.getSection()),nextSection(infor.nextSection(section)),oper(infor.getOper()),
 	side(hrr.getSide()),inputSQList(hrr.getHRRBottomSQList()),outputSQList(hrr.getRRResultSQList()),
 	inputSQStatus(inputSQList.size(),VARIABLE_SQ),outputSQStatus(outputSQList.size(),VARIABLE_SQ),
@@ -338,8 +350,10 @@ HRRInfor::HRRInfor(const SQIntsInfor& infor, const RR& hrr):Infor(infor),hrrFile
 	}
 
 	// now let's determine
+	// for the template kernels the HRR code is merely a function 
+	// call, so it's never split
 	hrrFileSplit = false;
-	if (nLHS>nLHSLimit) {
+	if (nLHS>nLHSLimit && ! hrrTemplate) {
 		hrrFileSplit = true;
 	}
 
@@ -382,7 +396,7 @@ HRRInfor::HRRInfor(const SQIntsInfor& infor, const RR& hrr):Infor(infor),hrrFile
 void HRRInfor::updateFileSplit()
 {
 	// reset the file split status
-	if (hrrFileSplit) return;
+	if (hrrFileSplit || hrrTemplate) return;
 	hrrFileSplit = true;
 	for(int iSQ=0; iSQ<(int)outputSQStatus.size(); iSQ++) {
 		if (outputSQStatus[iSQ] == VARIABLE_SQ) {
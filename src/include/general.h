@@ -71,6 +71,33 @@
 #define VRR_FUNC_STATEMENT     73
 #define VRR_CONT_STATEMENT     74
 
+// define the permutational symmetry of the symmetry reduced integral
+// functions, they could be combined:
+// SYM_BRA     : (ab|cd) = (ba|cd), the two bra shells are identical
+// SYM_KET     : (ab|cd) = (ab|dc), the two ket shells are identical
+// SYM_BRAKET  : (ab|cd) = (cd|ab), the bra pair is identical with ket pair
+#define SYM_BRA                1
+#define SYM_KET                2
+#define SYM_BRAKET             4
+
+// define the sides of the same center integral functions, they could
+// be combined:
+// SAME_CENTER_BRA : A == B
+// SAME_CENTER_KET : C == D
+#define SAME_CENTER_BRA        1
+#define SAME_CENTER_KET        2
+
+// define how the erf(omega*r12)/r12 operator is handled in the integral
+// function, see SQIntsInfor::setVariant:
+// ERF_RUNTIME : omega is tested at run time, omega = 0 is the plain operator
+// ERF_NONE    : only the plain operator, omega is not used
+// ERF_ONLY    : only the erf(omega*r12)/r12 operator
+// ERF_COMBINED: coulFac*(1/r12)+erfFac*erf(omega*r12)/r12
+#define ERF_RUNTIME            0
+#define ERF_NONE               1
+#define ERF_ONLY               2
+#define ERF_COMBINED           3
+
 // define the operator (100-999)
 // MOM is the moment integrals
 // esp is the electrostatic potential
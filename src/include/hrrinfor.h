@@ -57,6 +57,7 @@ namespace hrrinfor {
 		private:
 
 			bool hrrFileSplit;                 ///< does the hrr part of code in sub files?
+			bool hrrTemplate;                  ///< is the HRR done by the template kernels?
 			int section;                       ///< is this the HRR1 or HRR2?
 			int nextSection;                   ///< which is the next section of VRR
 			int oper;                          ///< we still need operator information
@@ -35,6 +35,7 @@
 #define TBB_VEC                3   // we use std vector with TBB allocator
 #define STD_VEC                4   // we use std vector with STD allocator
 #define USE_SCR_VEC            5   // the vector is provided by scratch memory management class
+#define USE_STACK_ARRAY        6   // the vector is aligned fixed size array on the stack
 
 namespace infor {
 
@@ -147,6 +148,8 @@ namespace infor {
 			double VRRSplitCoefs;  ///< the coefs used to scale VRR nLHS so to see whether have multiple VRR files
 			double nonRRArrayToVarCoef; ///< the coefs used to see whether have array->var for non-RR in print function 
 			double totalLHSScaleFac;    ///< the scale factor for nLHS of main cpp file
+			bool minCutSplit;      ///< whether the HRR sub files are cut where least integrals cross
+			double splitBalance;   ///< the allowed deviation of sub file nLHS from the limit in min cut split
 
 			//
 			// for the derivatives case, we will explore the number of intermediate 
@@ -166,6 +169,28 @@ namespace infor {
 			int maxL;              ///< maximum angular momentum in integral generation
 			int auxMaxL;           ///< maximum angular momentum for integral with aux shell
 			int vec_form;          ///< what kind of vector form we use? See above definition for TBB_VEC etc.
+			bool stridedResult;    ///< whether the result abcd is accumulated through caller's layout descriptor
+			bool scrMemPlan;       ///< whether the arrays share one memory frame according to their life time
+			bool threadLocalScr;   ///< whether the integral function draws the scr from the thread local pool
+			bool kernelRegistry;   ///< whether we print the registry table and entry function for each operator
+			bool sharedByLSum;     ///< whether the registry loads the integral functions from shared objects per L sum
+			bool kernelBenchmark;  ///< whether we print the benchmark driver together with the registry
+			bool stageTiming;      ///< whether we report the time spent in each stage of code generation
+			bool dryRun;           ///< whether we only plan the codes and report the cost without printing
+			bool kernelManifest;   ///< whether we print the JSON manifest for each integral function
+			int vrrLoopMinL;       ///< the VRR shell quartets with L sum from it are printed in loop form
+			bool rrByteCode;       ///< whether the RR program is also written into the bytecode file
+			bool hrrTemplate;      ///< whether the HRR is done by calling the template kernels
+			int hrrMatrixMinL;     ///< the HRR kernel with L1+L2 from it uses the transfer matrix form
+			bool sameCenterKernels;///< whether we also generate the same center (A==B, C==D) variants
+			bool symmetryKernels;  ///< whether we also generate the permutational symmetry reduced variants
+			bool gcKernels;        ///< whether we also generate the general contraction variants
+			bool sigPairKernels;   ///< whether we also generate the significant pair list variants
+			bool pairDataKernels;  ///< whether we also generate the shell pair data variants
+			bool ketListKernels;   ///< whether we also generate the ket list variants
+			bool erfKernels;       ///< whether the erf(omega*r12)/r12 operator is in its own variants
+			bool rsKernels;        ///< whether we also generate the range separated variants
+			bool geminalKernels;   ///< whether we also generate the multi-Gaussian geminal variants
 			int M_limit;           ///< in calculating fmt function, what is the M limit?
 			int fmt_error;         ///< the fmt function error associating with fmt function
 			string hrr_method;     ///< HRR method
@@ -207,12 +232,51 @@ namespace infor {
 			///
 			bool useSTDVec() const { return (vec_form == STD_VEC); };
 
+			///
+			/// whether the program use the aligned fixed size array on stack?
+			///
+			bool useStackArray() const { return (vec_form == USE_STACK_ARRAY); };
+
+			///
+			/// whether the arrays are placed in one memory frame by the 
+			/// memory planner? This only works for the scr and stack form
+			///
+			/// in this case the array is declared with a place holder like
+			/// "Double* name = SCR_PLAN(n);", and after the whole cpp file is 
+			/// assembled the SQInts::planArrayMemory() computes the life time 
+			/// of the arrays and replaces the place holder with the offset in
+			/// the memory frame, arrays do not alive at the same time share 
+			/// the same memory
+			///
+			bool usePlannedArray() const { 
+				if (! scrMemPlan) return false;
+				return (useSCRVec() || useStackArray()); 
+			};
+
+			///
+			/// whether the integral function takes the scr from the thread 
+			/// local memory pool rather than the argument list?
+			///
+			/// in this case the LocalMemScr object is not passed in, the function
+			/// fetches the arena of the calling thread by threadLocalMemScr(n) 
+			/// where n is the exact scr length the function requires (see the 
+			/// SQInts::recordSCRLength()). This only works with the scr form
+			///
+			bool useThreadLocalSCR() const { 
+				if (! threadLocalScr) return false;
+				return useSCRVec(); 
+			};
+
 			///
 			/// according to the vector usage type, return the vector type
 			///
 			string getArrayType() const {
-				if (useSCRVec()) {
+				if (usePlannedArray()) {
+					return "Double* ";
+				}else if (useSCRVec()) {
 					return "Double* ";
+				}else if (useStackArray()) {
+					return "alignas(64) Double ";
 				}else{
 					return "DoubleVec ";
 				}
@@ -223,14 +287,187 @@ namespace infor {
 			/// getNewMemPos is the member function for oject of "scr" in LocalMemScr class
 			/// it will return a pointer for the given length of memory
 			///
-			string getArrayDeclare(const string& nInts) const {
-				if (useSCRVec()) {
-					return " = scr.getNewMemPos(" + nInts +");";
+			/// the array length is always compile time constant, therefore for the
+			/// stack form we use fixed size array. needInit indicates whether the 
+			/// array is accumulated (like the VRR contraction result), so that it
+			/// must be zero initialized. For the others every element is assigned
+			/// before it's used, so the scr/stack form does not initialize them
+			///
+			string getArrayDeclare(const string& nInts, bool needInit = false) const {
+				if (usePlannedArray()) {
+					if (needInit) {
+						return " = SCR_PLAN_INIT(" + nInts +");";
+					}else{
+						return " = SCR_PLAN(" + nInts +");";
+					}
+				}else if (useSCRVec()) {
+					if (needInit) {
+						return " = scr.getNewMemPos(" + nInts +");";
+					}else{
+						return " = scr.getRawMemPos(" + nInts +");";
+					}
+				}else if (useStackArray()) {
+					if (needInit) {
+						return "[" + nInts + "] = {0.0E0};";
+					}else{
+						return "[" + nInts + "];";
+					}
 				}else{
 					return "(" + nInts + ",0.0E0);";
 				}
 			};
 
+			///
+			/// whether the result array is written through the caller's 
+			/// layout descriptor?
+			///
+			/// in the strided result layout, the kernel does not write a dense
+			/// block into abcd. Instead, each result integral is accumulated as
+			/// abcd[i1*s[0]+i2*s[1]+i3*s[2]+i4*s[3]+iDeriv*s[4]+iGrid*s[5]] += scale*value
+			/// where s is the abcdStride array passed in by the caller. Therefore
+			/// any permutation of the four shell indices and any leading dimension
+			/// could be expressed by the caller through the stride array 
+			///
+			bool withStridedResult() const { return stridedResult; };
+
+			///
+			/// whether we print the registry of integral functions?
+			/// see the kernelregistry.h for more details
+			///
+			bool withKernelRegistry() const { return kernelRegistry; };
+
+			///
+			/// whether the integral functions are packaged into shared objects
+			/// for each L sum, and the registry loads them on the first use?
+			/// see the kernelregistry.h for more details
+			///
+			bool packageByLSum() const { 
+				if (! kernelRegistry) return false;
+				return sharedByLSum; 
+			};
+
+			///
+			/// whether we print the benchmark driver for all of integral 
+			/// functions in the registry? see the kernelregistry.h 
+			///
+			bool withKernelBenchmark() const { 
+				if (! kernelRegistry) return false;
+				return kernelBenchmark; 
+			};
+
+			///
+			/// whether we report the time spent in each stage of code 
+			/// generation? see the stagetimer.h
+			///
+			bool withStageTiming() const { return stageTiming; };
+
+			///
+			/// whether this is a dry run? for dry run we only do the
+			/// RR and split planning, and report the cost of each function
+			///
+			bool isDryRun() const { return dryRun; };
+
+			///
+			/// whether we print the manifest together with each
+			/// integral function? see the KernelRecord::printManifest
+			///
+			bool withKernelManifest() const { return kernelManifest; };
+
+			///
+			/// whether the VRR shell quartet with the given L sum 
+			/// is printed in loop form? see the RRSQ::printLoopForm
+			///
+			bool withVRRLoopForm(const int& LSum) const { 
+				return (vrrLoopMinL >= 0 && LSum >= vrrLoopMinL); 
+			};
+
+			///
+			/// whether we write the RR program of each integral
+			/// function into bytecode? see the RRByteCode class
+			///
+			bool withRRByteCode() const { return rrByteCode; };
+
+			///
+			/// whether the HRR is done by the template kernels in
+			/// hrrkernel.h? see SQIntsInfor::useHRRTemplate
+			///
+			bool withHRRTemplate() const { return hrrTemplate; };
+
+			///
+			/// whether the HRR kernel on the side with given L1+L2 
+			/// is done as the transfer matrix product (hrrkernel::hrrMatrix)?
+			/// this is only used together with the template kernels
+			///
+			bool withHRRMatrixForm(const int& LSum) const { 
+				return (hrrMatrixMinL >= 0 && LSum >= hrrMatrixMinL); 
+			};
+
+			///
+			/// whether we generate the same center variants of the
+			/// integral functions? see SQIntsVariant
+			///
+			bool withSameCenterKernels() const { return sameCenterKernels; };
+
+			///
+			/// whether we generate the variants which only compute the unique
+			/// integrals of a symmetric block? see SQIntsVariant
+			///
+			bool withSymmetryKernels() const { return symmetryKernels; };
+
+			///
+			/// whether we generate the variants which take many contracted 
+			/// functions on the same primitives? see VARIANT_GENERAL_CONTRACTION
+			///
+			bool withGeneralContractionKernels() const { return gcKernels; };
+
+			///
+			/// whether we generate the variants which loop over the given lists
+			/// of significant primitive pairs? see VARIANT_SIG_PAIR_LIST
+			///
+			bool withSigPairKernels() const { return sigPairKernels; };
+
+			///
+			/// whether we generate the variants which take the precomputed
+			/// shell pair records? see VARIANT_PAIR_DATA
+			///
+			bool withPairDataKernels() const { return pairDataKernels; };
+
+			///
+			/// whether we generate the variants which take one bra pair and a 
+			/// list of ket pairs? see VARIANT_KET_LIST
+			///
+			bool withKetListKernels() const { return ketListKernels; };
+
+			///
+			/// whether the erf(omega*r12)/r12 operator is generated in its own
+			/// variants rather than tested at run time? see VARIANT_ERF_ONLY
+			///
+			bool withErfKernels() const { return erfKernels; };
+
+			///
+			/// whether we also generate the range separated variants (1/r12 and
+			/// erf(omega*r12)/r12 together)? see VARIANT_RANGE_SEPARATED
+			///
+			bool withRangeSeparatedKernels() const { return rsKernels; };
+
+			///
+			/// whether we also generate the EXPR12 variants for the sum of 
+			/// Gaussian geminals? see VARIANT_GEMINAL
+			///
+			bool withGeminalKernels() const { return geminalKernels; };
+
+			///
+			/// return the argument list for the result array, this is used
+			/// both in the top function and the sub functions
+			///
+			string getResultArgList() const {
+				if (withStridedResult()) {
+					return "Double* abcd, const UInt* abcdStride, const Double& abcdScale";
+				}else{
+					return "Double* abcd";
+				}
+			};
+
 			///
 			/// get the VRR method
 			///
@@ -0,0 +1,327 @@
+/**
+ *
+ * CPPINTS: A C++ Program to Generate Analytical Integrals Based on Gaussian
+ * Form Primitive Functions
+ *
+ * Copyright (C) 2015 The State University of New York at Buffalo
+ * This softare uses the MIT license as below:
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining 
+ *	a copy of this software and associated documentation files (the "Software"), 
+ *	to deal in the Software without restriction, including without limitation 
+ *	the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+ *	and/or sell copies of the Software, and to permit persons to whom the Software 
+ *	is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all 
+ * copies or substantial portions of the Software.
+ *						    
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, 
+ *	INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR 
+ *	PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE 
+ *	FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, 
+ *	ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * \file    kernelregistry.h
+ * \brief   registry of the generated integral functions for each operator
+ * \author  Fenglai Liu
+ */
+#ifndef KERNELREGISTRY_H
+#define KERNELREGISTRY_H
+#include <map>
+#include "general.h"
+#include "infor.h"
+#include "sqintsvariant.h"
+using namespace infor;
+using namespace sqintsvariant;
+
+namespace kernelregistry {
+
+	/**
+	 * \class SectionCost
+	 *
+	 * the planning result of one code section (VRR, HRR1 etc.) in the
+	 * integral function, it's formed before printing the code so that
+	 * the dry run could use it too. The FLOPs are counted on the RR 
+	 * expressions: each RHS term takes one multiplication and one 
+	 * addition, so the section takes 2*nRHS-nLHS operations. For VRR 
+	 * it's per primitive loop, for the other sections it's per 
+	 * contracted integral function.
+	 *
+	 * The bottom integrals are the integrals the section takes from
+	 * its previous section (for VRR they are the fundamental integrals
+	 * like (SS|SS)^m), and the max M is the largest M value among the
+	 * shell quartets in the section.
+	 */
+	class SectionCost {
+
+		public:
+
+			int section;                   ///< the code section 
+			long long nLHS;                ///< number of LHS integrals
+			long long nRHS;                ///< number of RHS integral terms
+			long long nArrayInts;          ///< number of LHS integrals kept in array
+			long long nVarInts;            ///< number of LHS integrals kept in variable
+			int nSubFiles;                 ///< number of sub files the section is split into
+			long long nBottomInts;         ///< number of bottom integrals the section takes
+			int maxM;                      ///< the max M value among the shell quartets
+			vector<string> arraySQList;    ///< names of shell quartets in ARRAY_SQ form
+
+			/**
+			 * constructor - in default all of elements are empty
+			 */
+			SectionCost():section(-1),nLHS(0),nRHS(0),nArrayInts(0),nVarInts(0),nSubFiles(0),
+			nBottomInts(0),maxM(0) { };
+
+			/**
+			 * destructor
+			 */
+			~SectionCost() { };
+
+			/**
+			 * the estimated FLOPs of the section
+			 */
+			long long getFlops() const {
+				if (2*nRHS < nLHS) return 0;
+				return 2*nRHS-nLHS;
+			};
+	};
+
+	/**
+	 * \class KernelRecord
+	 *
+	 * the information of one generated integral function, which is
+	 * collected by the SQInts after the cpp file is assembled 
+	 */
+	class KernelRecord {
+
+		public:
+
+			int oper;                      ///< operator of the integral function
+			string funcName;               ///< the integral function name
+			string argList;                ///< argument list of the integral function
+			vector<int> shellCodes;        ///< input shell codes, they form the L code
+			int nInts;                     ///< number of result integrals (for ESP it's per grid point)
+			map<int,int> scrBlocks;        ///< length and number of memory blocks taken from scr
+			long long nPrimFlops;          ///< estimated FLOPs for each loop over the primitives
+			long long nContFlops;          ///< estimated FLOPs out of the primitive loops
+			vector<string> fileNames;      ///< the cpp files of the function (main file first, no dir)
+			vector<SectionCost> sectionCosts; ///< planning result of each code section
+			SQIntsVariant variant;         ///< which variant the integral function is
+
+			/**
+			 * constructor - in default all of elements are empty
+			 */
+			KernelRecord():oper(-1),nInts(0),nPrimFlops(0),nContFlops(0),variant() { };
+
+			/**
+			 * the slot of same center variant in the registry entry:
+			 * 0 for A == B, 1 for C == D, 2 for both; -1 if it's not a variant
+			 */
+			int getSameCenterSlot() const {
+				if (variant.symmetry > 0) return -1;
+				if (variant.sameCenter == (SAME_CENTER_BRA|SAME_CENTER_KET)) return 2;
+				if (variant.sameCenter == SAME_CENTER_BRA) return 0;
+				if (variant.sameCenter == SAME_CENTER_KET) return 1;
+				return -1;
+			};
+
+			/**
+			 * the slot of symmetry reduced variant in the registry entry, the
+			 * slots are in the order that the entry function tries them:
+			 * (aa|aa), (aa|cc), (ab|ab), (aa|cd) and (ab|cc); -1 if it's not 
+			 * a variant
+			 */
+			int getSymmetrySlot() const {
+				int masks[] = {SYM_BRA|SYM_KET|SYM_BRAKET, SYM_BRA|SYM_KET, SYM_BRAKET, SYM_BRA, SYM_KET};
+				for(int i=0; i<5; i++) {
+					if (variant.symmetry == masks[i]) return i;
+				}
+				return -1;
+			};
+
+			/**
+			 * the variants with a different argument list are kept in their
+			 * own registry, the suffix is appended to the registry name:
+			 * _gc for the general contraction, _sig for the significant 
+			 * pair list, _pair for the shell pair data, _kets for the ket
+			 * list, _rs for the range separated and _gem for the geminal
+			 * variants; empty for the others
+			 */
+			string getRegistrySuffix() const {
+				if (variant.kind == VARIANT_GENERAL_CONTRACTION) return "_gc";
+				if (variant.kind == VARIANT_SIG_PAIR_LIST) return "_sig";
+				if (variant.kind == VARIANT_PAIR_DATA) return "_pair";
+				if (variant.kind == VARIANT_KET_LIST) return "_kets";
+				if (variant.kind == VARIANT_RANGE_SEPARATED) return "_rs";
+				if (variant.kind == VARIANT_GEMINAL) return "_gem";
+				return "";
+			};
+
+			/**
+			 * destructor
+			 */
+			~KernelRecord() { };
+
+			/**
+			 * the L code for the integral function, it's same with the 
+			 * codeSQ function in shellsymbol.h
+			 */
+			long long getLCode() const;
+
+			/**
+			 * the estimated size (in bytes) of the source code of the function,
+			 * which is based on the section costs
+			 */
+			long long getSourceSizeEstimate() const;
+
+			/**
+			 * print the manifest of the function in JSON, it's placed 
+			 * together with the cpp file (e.g. hgp_os_eri_d_d_p_s.json).
+			 * Besides the planning result of each section, it has the 
+			 * FLOPs counted on the printed code and the scr length in bytes
+			 */
+			void printManifest(const string& file) const;
+
+			/**
+			 * the sum of L for the input shells, for SP shell the L is 1.
+			 * this is the group of the function in the shared object package
+			 */
+			int getLSum() const;
+
+			/**
+			 * the scr length expression used in the generated code, like
+			 * "3*LocalMemScr::alignedLength(6)+LocalMemScr::alignedLength(9)"
+			 * the alignment is left to the LocalMemScr, see localmemscr.h
+			 */
+			string getSCRLengthExpr() const;
+
+			/**
+			 * the scr length in unit of Double for the given alignment 
+			 * unit (in unit of Double, too)
+			 */
+			long long getSCRLength(const int& unit) const;
+	};
+
+	/**
+	 * \class KernelRegistry
+	 *
+	 * The registry collects the records of all generated integral functions,
+	 * and for each operator it prints a head file and a cpp file (same name 
+	 * with the entry function, e.g. hgp_os/energy/hgp_os_eri.h and .cpp).
+	 *
+	 * The head file defines a dense table indexed by the L code. Each shell
+	 * code is mapped to a slot (S, SP, P, D, F etc.), and the table index is
+	 * slot1 + nSlots*(slot2 + nSlots*(slot3 + nSlots*slot4)). Each entry of
+	 * the table holds the function pointer, the number of result integrals,
+	 * the exact scr length and the FLOP estimate. The cpp file gives the 
+	 * table and the entry function which dispatches by the table, so it 
+	 * replaces the switch statement formed by the util/headfiles.py
+	 *
+	 * With kernel_package = shared_by_l the integral functions are grouped
+	 * by the L sum, and each group is built into its own shared object. The
+	 * table then records the group and the position in the group instead 
+	 * of the function pointer, and the entry function loads the group by 
+	 * dlopen on the first use (see test/include/kernelloader.h). Therefore
+	 * only the groups used by the basis set are mapped into the process.
+	 *
+	 * With same_center_kernels = true the same center variants of the ERI
+	 * functions (A == B, C == D and both) are kept in the entry of the plain
+	 * function, and the entry function routes the shell quartet to them by
+	 * comparing the centers.
+	 *
+	 * With symmetry_kernels = true the symmetry reduced variants are kept
+	 * in the entry too. The entry function takes the bra (ket) shells as 
+	 * identical when A == B (C == D), since the L is same the block is 
+	 * symmetric; the bra pair is identical with the ket pair when the 
+	 * centers and all of the pair data (icoe, iexp, ifac and P) are same.
+	 *
+	 * With erf_kernels = true the ERI functions above only compute the plain
+	 * operator, and the erf(omega*r12)/r12 variants (name_erf) are kept in 
+	 * the entry. The entry function calls the erf variant when omega is not
+	 * 0, in this case the same center and symmetry routing is skipped.
+	 *
+	 * With general_contraction_kernels = true the general contraction 
+	 * variants take the number of contracted functions in addition, so 
+	 * they are kept in their own registry (e.g. hgp_os_eri_gc.h and .cpp).
+	 * Its scr length does not count the work space of the contraction,
+	 * which is taken by gcontract::workSpace. It's same for the 
+	 * sig_pair_kernels = true, the registry is like hgp_os_eri_sig;
+	 * pair_data_kernels = true, the registry is like hgp_os_eri_pair;
+	 * ket_list_kernels = true, the registry is like hgp_os_eri_kets;
+	 * range_separated_kernels = true, the registry is like hgp_os_eri_rs; and
+	 * geminal_kernels = true, the registry is like hgp_os_expr12_gem.
+	 * The benchmark driver is only for the plain registry.
+	 *
+	 * With kernel_benchmark = true a benchmark driver (e.g. hgp_os_eri_bench.cpp)
+	 * is printed too. It times every function in the table with random 
+	 * geometries and reports ns/quartet, quartets/s and GFLOP/s in JSON
+	 */
+	class KernelRegistry {
+
+		private:
+
+			const Infor& infor;                               ///< information of the project
+			map<int,vector<KernelRecord> > kernelRecords;     ///< the records for each operator
+
+			/**
+			 * print the registry head file and cpp file for the given operator
+			 */
+			void printRegistry(const int& oper, const vector<KernelRecord>& records) const;
+
+			/**
+			 * print the wrappers for the functions in recList which do not
+			 * take the scr, so that all of functions in the table share the
+			 * same type
+			 */
+			void printEntryWrappers(const vector<KernelRecord>& records, const vector<int>& recList,
+					const string& arg, bool withSCRArg, ofstream& file) const;
+
+			/**
+			 * print the benchmark driver for all of functions in the table,
+			 * see the test/include/kernelbench.h for the options
+			 */
+			void printBenchmark(const int& oper, const string& name, const vector<KernelRecord>& records, 
+					const vector<int>& table, const string& arg, bool withSCRArg, const string& dir) const;
+
+			/**
+			 * for the shared object package, print the cpp file of function
+			 * table for each group and the makefile to build the shared objects
+			 */
+			void printGroupFiles(const string& name, const vector<KernelRecord>& records, 
+					const map<int,vector<int> >& groups, const string& arg, bool withSCRArg, 
+					const string& dir, const string& subDir) const;
+
+		public:
+
+			/**
+			 * constructor
+			 */
+			KernelRegistry(const Infor& infor0):infor(infor0) { };
+
+			/**
+			 * destructor
+			 */
+			~KernelRegistry() { };
+
+			/**
+			 * add in the record of a generated integral function
+			 */
+			void addKernel(const KernelRecord& record);
+
+			/**
+			 * print the registry files for all of operators
+			 */
+			void print() const;
+
+			/**
+			 * print the cost of all of integral functions formed in the dry
+			 * run, the summary goes to the screen and the details go into the
+			 * given file in JSON format
+			 */
+			void printCostReport(const string& file) const;
+	};
+
+}
+
+#endif
@@ -73,6 +73,12 @@ namespace nonrr {
 			vector<set<int> > unsolvedIntList; ///< the integral list corresponding to result SQ list
 			list<RRSQ> rrsqList;               ///< collecting the rrsq result
 
+			///
+			/// add the rrsq into the list, and merge its RHS into the 
+			/// result sq list and unsolved integral list
+			///
+			void appendRRSQ(const RRSQ& rrsq);
+
 		public:
 
 			///
@@ -92,6 +98,14 @@ namespace nonrr {
 			///
 			void buildRRSQList();
 
+			///
+			/// build the RRSQList for the same center variant of ERI, the 
+			/// (a,b|c,d) on the same center side is gathered from (a+b,S|
+			/// so the HRR on that side is not needed. The code section is
+			/// set to NON_RR. See SQIntsVariant
+			///
+			void buildSameCenterRRSQList(const bool& sameBra, const bool& sameKet);
+
 			///
 			/// return the rrsq list
 			///
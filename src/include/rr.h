@@ -159,6 +159,15 @@ namespace rr {
 			///
 			void updateHRRInfor(const HRRInfor& infor);
 
+			///
+			/// for VRR, set up the rrsq which will be printed in loop form
+			/// (see the vrr_loop_min_l keyword in infor). The loop form rrsq 
+			/// uses the loop array of the other loop form rrsq printed in 
+			/// the same function as its RHS; and its results are copied 
+			/// into variables only when they are needed outside 
+			///
+			void updateVRRLoopForm(const SQIntsInfor& infor, const VRRInfor& vrrinfor);
+
 		public:
 
 			/**
@@ -237,7 +246,7 @@ namespace rr {
 			///
 			/// print out the VRR codes
 			///
-			void vrrPrint(const SQIntsInfor& infor, const VRRInfor& vrrinfor) const;
+			void vrrPrint(const SQIntsInfor& infor, const VRRInfor& vrrinfor);
 
 			///
 			/// print HRR codes
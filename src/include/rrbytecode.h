@@ -0,0 +1,150 @@
+/**
+ *
+ * CPPINTS: A C++ Program to Generate Analytical Integrals Based on Gaussian
+ * Form Primitive Functions
+ *
+ * Copyright (C) 2015 The State University of New York at Buffalo
+ * This softare uses the MIT license as below:
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining
+ *	a copy of this software and associated documentation files (the "Software"),
+ *	to deal in the Software without restriction, including without limitation
+ *	the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *	and/or sell copies of the Software, and to permit persons to whom the Software
+ *	is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *	INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ *	PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ *	FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ *	ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * \file    rrbytecode.h
+ * \brief   serialize the planned RR program of an integral function into bytecode
+ * \author  Fenglai Liu
+ */
+#ifndef RRBYTECODE_H
+#define RRBYTECODE_H
+#include <map>
+#include "general.h"
+#include "shellquartet.h"
+using namespace shellquartet;
+
+namespace sqintsinfor {
+	class SQIntsInfor;
+}
+
+namespace rr {
+	class RR;
+}
+
+//
+// the bytecode file is a list of 32 bit integers, the layout is:
+//
+// magic number, version, number of results, number of primitive slots,
+// number of contracted slots, max M; then five sections, each of them
+// begins with its length (number of words):
+//
+// bottom : the slot of (SS|SS)^{m} for m = 0 to max M (-1 if not used)
+// vrr    : steps on the primitive slots
+// cont   : pairs of (contracted slot, primitive slot)
+// hrr    : steps on the contracted slots
+// output : pairs of (offset in abcd, contracted slot)
+//
+// if the hrr section is empty the results are added into abcd, else
+// they are assigned to abcd; same as the generated function does.
+//
+// each step is: lhs slot, number of terms, then (symbol, multiplier,
+// rhs slot) for each term. The symbol is one of the RR coefficients
+// listed below, the value is the multiplier*symbol*rhs. The symbol
+// list must be kept same with the interpreter in test/include/rrinterp.h
+//
+#define RR_BYTECODE_MAGIC      0x43425252
+#define RR_BYTECODE_VERSION    1
+
+namespace rrbytecode {
+
+	using namespace sqintsinfor;
+	using namespace rr;
+
+	/**
+	 * \class RRByteCode
+	 *
+	 * The RR program planned for the integral function (the bottom
+	 * integrals, VRR, contraction and HRR) is written into a compact
+	 * bytecode, so that the rarely used shell quartets could be shipped
+	 * as data and run by the interpreter in test/include/rrinterp.h,
+	 * rather than compiled into the library.
+	 *
+	 * Each integral (shell quartet name plus integral index) takes one
+	 * slot. The primitive slots hold the VRR integrals for each primitive
+	 * quartet, the contracted slots hold the contraction results and
+	 * the HRR integrals.
+	 *
+	 * Currently only the ERI energy integrals without composite shells
+	 * are supported; for the others isValid() returns false.
+	 */
+	class RRByteCode {
+
+		private:
+
+			bool valid;                          ///< whether the program is formed
+			int nInts;                           ///< number of result integrals
+			int maxM;                            ///< max M value of bottom integrals
+			map<string,int> primSlots;           ///< slots of primitive integrals
+			map<string,int> contSlots;           ///< slots of contracted integrals
+			map<string,ShellQuartet> contSQList; ///< shell quartets in the contracted slots
+			vector<int> bottomCode;              ///< bottom section
+			vector<int> vrrCode;                 ///< VRR section
+			vector<int> contCode;                ///< contraction section
+			vector<int> hrrCode;                 ///< HRR section
+			vector<int> outputCode;              ///< output section
+
+			/**
+			 * return the slot for the given integral, a new slot is
+			 * created if it's not there
+			 */
+			int getSlot(map<string,int>& slots, const ShellQuartet& sq, const int& index);
+
+			/**
+			 * record the slot of the given bottom integral (SS|SS)^{m}
+			 */
+			void updateBottom(const ShellQuartet& sq);
+
+			/**
+			 * append the rrsq list of the given RR into the code
+			 * return false if some coefficient can not be expressed
+			 */
+			bool appendRR(const RR& rr, bool isVRR, vector<int>& code);
+
+		public:
+
+			/**
+			 * form the bytecode from the planned RR
+			 * hrr1 and hrr2 are used only when the section is there
+			 */
+			RRByteCode(const SQIntsInfor& infor, const RR& vrr, const RR& hrr1, const RR& hrr2);
+
+			/**
+			 * destructor
+			 */
+			~RRByteCode() { };
+
+			/**
+			 * whether the bytecode is formed?
+			 */
+			bool isValid() const { return valid; };
+
+			/**
+			 * write the bytecode into the given file
+			 */
+			void print(const string& file) const;
+	};
+
+}
+
+#endif
+
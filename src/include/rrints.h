@@ -86,6 +86,13 @@ namespace rrints {
 	using namespace rrbuild;
 	using namespace sqintsinfor;
 
+	/**
+	 * split the coefficient of RR into the numerical multiplier and the
+	 * rest of expression, for example "-5*rhod2zsq" gives -5 and rhod2zsq.
+	 * For the coefficient which is merely a number, the expression is "1"
+	 */
+	void splitCoefficient(const string& coefficients, double& multiplier, string& expression);
+
 	/**
 	 * \class RRSQ
 	 *
@@ -114,12 +121,15 @@ namespace rrints {
 			int position;                  ///< where we are going to expand the RR?
 			int direction;                 ///< current x, y or z direction (use for 3 body KI etc.)
 			int lhsSQStatus;               ///< the lhs shell quartet status, in array form or variable form?
+			bool loopForm;                 ///< whether the rrsq is printed in loop form (VRR only)
+			bool loopUnpack;               ///< whether the loop form LHS is also needed in variable form
 
 			// RR integrals expression data
 			ShellQuartet oriSQ;            ///< original shell quartet, appearing on LHS
 			vector<int> sqPosList;         ///< record each non-null sq position
 			vector<ShellQuartet> sqlist;   ///< the shell quartets on the RHS, length is nitems
 			vector<int> rhsSQStatus;       ///< the right hand SQ status, in variable form or var form?
+			vector<bool> rhsInLoop;        ///< whether the RHS sq is the loop form rrsq in the same function
 			list<int>          LHS;        ///< LHS integral index, length is nInts
 			vector<list<int> > RHS;        ///< RHS integrals (nInts, nitems)
 			vector<list<string> > coe;     ///< coefficients for each terms (nInts, nitems)
@@ -168,6 +178,12 @@ namespace rrints {
 				return true;
 			};
 
+			/**
+			 * print the rrsq as a loop over the LHS integrals rather than 
+			 * the unrolled statements, see the comments inside for details
+			 */
+			void printLoopForm(const int& nSpace, ofstream& file) const;
+
 		public:
 
 			/**
@@ -183,6 +199,18 @@ namespace rrints {
 			RRSQ(const int& rrType0, const int& pos, const ShellQuartet& sq,
 					const set<int>& unsolvedIntegralList, int dir = NO_DERIV);
 
+			/**
+			 * build the RRSQ for the same center variant, which is a non-RR
+			 * work. On the same center side (a,b| is (a+b,S|, so each LHS
+			 * integral is just the corresponding one in the RHS shell quartet
+			 * \param sq      the input shell quartet
+			 * \param unsolvedIntegralList integral index list
+			 * \param sameBra  whether A == B
+			 * \param sameKet  whether C == D
+			 */
+			RRSQ(const ShellQuartet& sq, const set<int>& unsolvedIntegralList, 
+					const bool& sameBra, const bool& sameKet);
+
 			///
 			/// destructor
 			///
@@ -263,6 +291,11 @@ namespace rrints {
 			 */
 			const list<int>& getRHSIndexArray(const int& item) const { return RHS[item]; };
 
+			/**
+			 * get the coefficients for the given item
+			 */
+			const list<string>& getCoeArray(const int& item) const { return coe[item]; };
+
 			/**
 			 * update the LHS of this rrsq with the given 
 			 * unsolvedIntList. We do not check the LHS 
@@ -301,6 +334,23 @@ namespace rrints {
 			 */
 			void lhsArrayIndexTransform();
 
+			/**
+			 * set the rrsq to be printed in loop form, this is only for VRR
+			 * if unpack is true, the LHS results are also copied into 
+			 * variables after the loop
+			 */
+			void updateLoopForm(bool unpack) { 
+				loopForm   = true; 
+				loopUnpack = unpack;
+			};
+
+			/**
+			 * the given rrsq is in loop form and it's printed in the same 
+			 * function with this one, so for the corresponding RHS we 
+			 * transform the integral index into the index of loop array
+			 */
+			void rhsLoopIndexTransform(const RRSQ& rrsq);
+
 			///
 			/// this function is used to count every RHS integral (repeat one
 			/// also included inside) for the given recurrence relation
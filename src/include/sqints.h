@@ -30,7 +30,9 @@
 #define SQINTS_H
 #include "general.h"
 #include "sqintsinfor.h"
+#include "kernelregistry.h"
 using namespace sqintsinfor;
+using namespace kernelregistry;
 
 namespace sqints {
 
@@ -50,6 +52,7 @@ namespace sqints {
 			// convenient
 			//
 			SQIntsInfor infor;                 ///< information of the project
+			KernelRecord kernelRecord;         ///< information of the generated function for registry
 
 			///
 			/// this is the working function to generate the integral codes
@@ -89,6 +92,65 @@ namespace sqints {
 			///
 			void assembleCPPFiles() const;
 
+			///
+			/// for the assembled cpp file, place all of arrays into one memory
+			/// frame according to their life time. Arrays not alive at the 
+			/// same time share the same memory. This is only called when
+			/// the usePlannedArray() is true, see the infor.h
+			///
+			void planArrayMemory() const;
+
+			///
+			/// for the ket list and geminal variants, the body of the loop 
+			/// over kets (or Gaussian terms) is printed with the indentation
+			/// of the code outside; here it's indented for one more level.
+			/// The loop is given by its opening line, and the body ends at 
+			/// the matching closing brace
+			///
+			void indentLoop(const string& loop) const;
+
+			///
+			/// for the assembled cpp file, count all of memory blocks the 
+			/// function gets from the scr and print the scr length function 
+			/// "UInt funcName_scr_len()" in front of the integral function.
+			/// The length is used to size the LocalMemScr by the caller, or 
+			/// the thread local pool when useThreadLocalSCR() is true
+			///
+			/// the memory blocks are recorded in the kernelRecord
+			///
+			void recordSCRLength();
+
+			///
+			/// estimate the FLOPs of the assembled integral function by counting
+			/// the arithmetic operations in the code (including the sub files).
+			/// The code inside the primitive loops and the rest are counted 
+			/// separately, and the result is recorded in the kernelRecord
+			///
+			void countFlops();
+
+			///
+			/// count the arithmetic operations for the given line of code
+			///
+			long long countLineFlops(const string& line) const;
+
+			///
+			/// count the arithmetic operations for the sub file
+			///
+			long long countFileFlops(const string& file) const;
+
+			///
+			/// the trip count of the loop started on the given line, if the
+			/// bound is a literal number; else it's 1. The operations in the
+			/// loop body are scaled by it in counting the FLOPs
+			///
+			long long loopTripCount(const string& line) const;
+
+			///
+			/// collect the information of the generated integral function 
+			/// into the kernelRecord, it's used by the KernelRegistry
+			///
+			void formKernelRecord();
+
 			///
 			/// for the given section name, whether we have the files defined in the temp 
 			/// work dir?
@@ -126,11 +188,16 @@ namespace sqints {
 					const int& oper):infor(oper,infor0,bra1,bra2,ket1,NULL_POS) { };
 
 			/**
-			 * constructor for the 4 body shell quartet
+			 * constructor for the 4 body shell quartet, the variant tells
+			 * which form of the integral function is generated (see 
+			 * SQIntsVariant), in default it's the plain one
 			 */
 			SQInts(const Infor& infor0, const int& bra1, 
 					const int& bra2, const int& ket1, const int& ket2, 
-					const int& oper):infor(oper,infor0,bra1,bra2,ket1,ket2) { };
+					const int& oper, 
+					const SQIntsVariant& variant = SQIntsVariant()):infor(oper,infor0,bra1,bra2,ket1,ket2) { 
+				infor.setVariant(variant);
+			};
 
 			/**
 			 * destructor
@@ -148,6 +215,16 @@ namespace sqints {
 			 */
 			void codeGeneration();
 
+			/**
+			 * whether the given variant of the integral function could be formed?
+			 */
+			bool canDoVariant(const SQIntsVariant& variant) const { return infor.canDoVariant(variant); };
+
+			/**
+			 * return the information of the generated integral function
+			 */
+			const KernelRecord& getKernelRecord() const { return kernelRecord; };
+
 	};
 
 }
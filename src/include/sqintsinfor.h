@@ -33,11 +33,13 @@
 #include "shellquartet.h"
 #include "inttype.h"
 #include "derivinfor.h"
+#include "sqintsvariant.h"
 #include "boost/lexical_cast.hpp"
 using namespace infor;
 using namespace shellquartet;
 using namespace inttype;
 using namespace derivinfor;
+using namespace sqintsvariant;
 
 namespace sqintsinfor {
 
@@ -75,6 +77,8 @@ namespace sqintsinfor {
 			//
 			bool withArray;                    ///< whether the whole cpp file is going without array variable?
 			bool doHRRWork;                    ///< determine that whether we do HRR work
+			SQIntsVariant variant;             ///< which variant the integral function is
+			int erfMode;                       ///< how the erf(omega*r12)/r12 operator is handled (ERF_RUNTIME etc.)
 			vector<int> sectionInfor;          ///< section sequence information
 
 			// 
@@ -118,6 +122,29 @@ namespace sqintsinfor {
 			///
 			bool weDOHRRWork() const;
 
+			///
+			/// for the result shell quartet and it's index, we get the position
+			/// of the integral in each shell dimension (pos), the dimension of
+			/// the first three shells (dim) as well as the derivatives position
+			///
+			void formResultPos(const ShellQuartet& sq, const int& index, int& derivPos,
+					vector<int>& pos, vector<int>& dim) const;
+
+			///
+			/// whether the same center form could be done for the given
+			/// side? it's for the energy ERI without composite shells, and 
+			/// the side must have HRR work to drop
+			///
+			bool canDoSameCenter(const int& side) const;
+
+			///
+			/// whether the symmetry reduced form could be done? it's for
+			/// the energy ERI without composite shells, the shells must have
+			/// the same L and some integrals must be redundant. For SYM_BRAKET
+			/// it's either alone or with all of the others
+			///
+			bool canDoSymmetry(const int& sym) const;
+
 		public:
 
 			///
@@ -184,6 +211,130 @@ namespace sqintsinfor {
 				return false;
 			};
 
+			///
+			/// whether this shell quartet does HRR with the template
+			/// kernels? Currently it's for the energy ERI without 
+			/// composite shells, whose HRR results are the final ones
+			/// and written to abcd in integral order
+			///
+			bool useHRRTemplate() const {
+				return ((withHRRTemplate() || isGeneralContraction()) && oper == ERI && derivOrder == 0 && ! isComSQ() && 
+						! withStridedResult() && ! isSameCenterVariant() && ! isSymmetryVariant());
+			};
+
+			///
+			/// turn the integral function into the given variant, it must be
+			/// one that canDoVariant accepts. The kind of variant also decides
+			/// how the erf(omega*r12)/r12 operator is handled: with erf_kernels
+			/// = true the plain function (in any form) only computes the plain
+			/// operator (ERF_NONE), the erf and range separated variants are
+			/// ERF_ONLY and ERF_COMBINED; the other variants keep the run time 
+			/// test of omega (ERF_RUNTIME)
+			///
+			void setVariant(const SQIntsVariant& v);
+
+			///
+			/// whether the given variant could be formed for the shell quartet?
+			/// the same center and symmetry forms are only for the plain function
+			///
+			bool canDoVariant(const SQIntsVariant& v) const;
+
+			///
+			/// return the variant of the integral function
+			///
+			const SQIntsVariant& getVariant() const { return variant; };
+
+			///
+			/// whether the given side (BRA/KET) is on the same center?
+			///
+			bool isSameCenter(const int& side) const {
+				int mask = (side == BRA ? SAME_CENTER_BRA : SAME_CENTER_KET);
+				return ((variant.sameCenter & mask) > 0);
+			};
+
+			///
+			/// whether this is a same center variant?
+			///
+			bool isSameCenterVariant() const { return (variant.sameCenter > 0); };
+
+			///
+			/// whether the given RR coefficient is zero in the same center
+			/// variant? such terms are dropped in printing
+			///
+			bool isZeroCoefficient(const string& coe) const;
+
+			///
+			/// return the permutational symmetry of the variant
+			///
+			int getSymmetry() const { return variant.symmetry; };
+
+			///
+			/// whether this is a symmetry reduced variant?
+			///
+			bool isSymmetryVariant() const { return (variant.symmetry > 0); };
+
+			///
+			/// for the integral of the given index, return the index of the 
+			/// unique one it's copied from. It's the smallest index among the 
+			/// permutations of the integral; the index itself is returned if 
+			/// it's unique
+			///
+			int getSymmetryUniqueIndex(const ShellQuartet& sq, const int& index) const;
+
+			///
+			/// whether this is a general contraction variant?
+			///
+			bool isGeneralContraction() const { return (variant.kind == VARIANT_GENERAL_CONTRACTION); };
+
+			///
+			/// whether this is a significant pair list variant?
+			///
+			bool isSigPairList() const { return (variant.kind == VARIANT_SIG_PAIR_LIST); };
+
+			///
+			/// whether this is a shell pair data variant?
+			///
+			bool isPairData() const { return (variant.kind == VARIANT_PAIR_DATA); };
+
+			///
+			/// whether this is a ket list variant?
+			///
+			bool isKetList() const { return (variant.kind == VARIANT_KET_LIST); };
+
+			///
+			/// whether the function takes the shell pair records? it's 
+			/// for the shell pair data and ket list variants
+			///
+			bool withPairRecord() const { return (isPairData() || isKetList()); };
+
+			///
+			/// whether this is a range separated variant?
+			///
+			bool isRangeSeparated() const { return (erfMode == ERF_COMBINED); };
+
+			///
+			/// whether this is a geminal variant?
+			///
+			bool isGeminal() const { return (variant.kind == VARIANT_GEMINAL); };
+
+			///
+			/// return how the erf(omega*r12)/r12 operator is handled
+			///
+			int getErfMode() const { return erfMode; };
+
+			///
+			/// whether this is an erf variant?
+			///
+			bool isErfOnly() const { return (erfMode == ERF_ONLY); };
+
+			///
+			/// the VRR results taken by the HRR template kernels, in the kernel
+			/// order: (e,S|f,S) with e from La to La+Lb and f from Lc to Lc+Ld,
+			/// the bra side integrals are the fastest. Without HRR it's simply 
+			/// the result shell quartet in integral order
+			///
+			void getHRRKernelInput(vector<ShellQuartet>& sqList, vector<int>& indexList) const;
+
 			///
 			/// whether the input SQ are all bottom ones?
 			///
@@ -248,6 +399,14 @@ namespace sqintsinfor {
 			///
 			int getOffset(const ShellQuartet& sq, const int& index) const;
 
+			///
+			/// for the result shell quartet and it's index, return the index
+			/// expression for abcd in the strided result layout; see the 
+			/// withStridedResult() in infor.h. The ESP grid offset is 
+			/// included here, too
+			///
+			string getStridedOffset(const ShellQuartet& sq, const int& index) const;
+
 			///
 			/// for a given shell quartet, get it's coefficient 
 			/// array offset
@@ -327,7 +486,7 @@ namespace sqintsinfor {
 			 */
 			bool withDoubleVec() const {
 				if (withArray) {
-					if (! useSCRVec()) return true;
+					if (! useSCRVec() && ! useStackArray()) return true;
 				}
 				return false;
 			};
@@ -0,0 +1,161 @@
+/**
+ *
+ * CPPINTS: A C++ Program to Generate Analytical Integrals Based on Gaussian
+ * Form Primitive Functions
+ *
+ * Copyright (C) 2015 The State University of New York at Buffalo
+ * This softare uses the MIT license as below:
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining 
+ *	a copy of this software and associated documentation files (the "Software"), 
+ *	to deal in the Software without restriction, including without limitation 
+ *	the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+ *	and/or sell copies of the Software, and to permit persons to whom the Software 
+ *	is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all 
+ * copies or substantial portions of the Software.
+ *						    
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, 
+ *	INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR 
+ *	PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE 
+ *	FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, 
+ *	ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * \file    sqintsvariant.h
+ * \brief   describing which variant of the integral function is generated
+ * \author  Fenglai Liu
+ */
+#ifndef SQINTSVARIANT_H
+#define SQINTSVARIANT_H
+#include "general.h"
+
+namespace sqintsvariant {
+
+	///
+	/// the kinds of variant for the integral function. Each of them except
+	/// the plain one changes the argument list or the operator, so the 
+	/// function name is appended with a suffix and it goes to its own 
+	/// registry; see SQIntsInfor::canDoVariant for which shell quartets
+	/// they could be formed for
+	///
+	enum VariantKind {
+
+		///
+		/// the plain function. It could be further in the same center form
+		/// and the symmetry reduced form, see SQIntsVariant; such forms 
+		/// keep the argument list and the registry routes the shell 
+		/// quartets to them
+		///
+		VARIANT_PLAIN,
+
+		///
+		/// the general contraction variant. The icoe/jcoe hold nBraCont/nKetCont
+		/// columns of coefficients (icoe[ip2+k*inp2]), and the abcd holds 
+		/// nBraCont*nKetCont blocks of results, the block of (k,l) starts from
+		/// (k*nKetCont+l)*nInts. The VRR is done once for each primitive pair
+		/// without the coefficients, and the contraction on all of the contracted
+		/// functions is done by the kernels in gcontract.h; then the HRR template
+		/// kernels are called for each block. The function name is appended with _gc
+		///
+		VARIANT_GENERAL_CONTRACTION,
+
+		///
+		/// the significant pair list variant. It takes the lists of significant
+		/// primitive pairs on the bra and ket side (iSig[0..inSig) index the 
+		/// primitive pairs in 0..inp2, and jSig likewise), which are built once 
+		/// for each shell pair by the caller. The loops only go over the listed
+		/// pairs, and the significance test inside the loop is dropped, so the 
+		/// caller is responsible for the screening. The function name is appended
+		/// with _sig
+		///
+		VARIANT_SIG_PAIR_LIST,
+
+		///
+		/// the shell pair data variant. Instead of the primitive pair arrays it
+		/// takes the bra and ket shellpair::ShellPair records (see 
+		/// test/include/shellpair.h), where P-A, P-B, 1/(2zeta) as well as alpha,
+		/// beta for the derivatives are precomputed; so they are loaded in the 
+		/// loop rather than formed again. The function name is appended with _pair
+		///
+		VARIANT_PAIR_DATA,
+
+		///
+		/// the ket list variant. It takes one bra shell pair record and nKets 
+		/// ket records of the same L class (see shellpair.h), and loops over the
+		/// kets inside. The bra side data is unpacked once for all of kets, and 
+		/// the results of the ket i go to the block abcdKets+i*nInts(). The 
+		/// function name is appended with _kets
+		///
+		VARIANT_KET_LIST,
+
+		///
+		/// the erf variant, it only computes the erf(omega*r12)/r12 operator
+		/// (ERF_ONLY). With erf_kernels = true the plain function only computes 
+		/// the plain operator (ERF_NONE), so there's no omega test and no erf
+		/// prefactors in its primitive loop; and the registry entry function 
+		/// calls the erf variant when omega is not 0. The function name is 
+		/// appended with _erf
+		///
+		VARIANT_ERF_ONLY,
+
+		///
+		/// the range separated variant, it computes coulFac*(1/r12)+
+		/// erfFac*erf(omega*r12)/r12 in one pass (ERF_COMBINED). The two 
+		/// coefficients follow the omega in the argument list. Both sets of 
+		/// bottom integrals are formed in the primitive loop and combined before
+		/// the VRR, since the VRR (and all of the work after it) is same for the
+		/// two operators; so the VRR is only done once. The name is appended 
+		/// with _rs
+		///
+		VARIANT_RANGE_SEPARATED,
+
+		///
+		/// the geminal variant of EXPR12. The F12 correlation factor is fitted
+		/// as sum_k gemCoe[k]*exp(-gemExp[k]*r12^2), the variant takes the nGem
+		/// terms in place of the omega, and loops over them inside the primitive
+		/// loop. The primitive pair data is formed once for all of terms, and the
+		/// VRR results of each term are scaled by its coefficient in the bottom 
+		/// integral and summed in the contraction; so the HRR is done once for 
+		/// the whole correlation factor. The VRR itself is done for each term, 
+		/// since its coefficients (odorho etc.) depend on the exponent. The 
+		/// function name is appended with _gem
+		///
+		VARIANT_GEMINAL
+	};
+
+	/**
+	 * \class SQIntsVariant
+	 *
+	 * This class describes which variant of the integral function is 
+	 * generated, it's the kind of variant plus the same center and symmetry
+	 * forms of the plain function.
+	 *
+	 * For the same center form of A == B, the P is same with A and B, so 
+	 * the PA and PB terms vanish in VRR; and (a,b| is simply (a+b,S|, so 
+	 * the bra side HRR is replaced by a gather of the VRR results (see 
+	 * NONRR::buildSameCenterRRSQList). It's same for C == D on the ket side.
+	 * The function name is appended with _same_ab, _same_cd or _same_abcd.
+	 *
+	 * For the symmetry reduced form, only the unique integrals of the block
+	 * are computed by the RR, the others are copied from them at the end of
+	 * the function. The function name is appended with _sym_aacd, _sym_abcc,
+	 * _sym_aacc, _sym_abab or _sym_aaaa.
+	 */
+	class SQIntsVariant {
+
+		public:
+
+			int kind;             ///< the kind of variant, VARIANT_PLAIN etc.
+			int sameCenter;       ///< the same center sides combined from SAME_CENTER_BRA etc., 0 if none
+			int symmetry;         ///< the permutational symmetry combined from SYM_BRA etc., 0 if none
+
+			///
+			/// constructor, the default one is the plain function
+			///
+			SQIntsVariant(const int& kind0 = VARIANT_PLAIN, const int& sameCenter0 = 0, 
+					const int& symmetry0 = 0):kind(kind0),sameCenter(sameCenter0),symmetry(symmetry0) { };
+	};
+}
+
+#endif
@@ -0,0 +1,97 @@
+/**
+ *
+ * CPPINTS: A C++ Program to Generate Analytical Integrals Based on Gaussian
+ * Form Primitive Functions
+ *
+ * Copyright (C) 2015 The State University of New York at Buffalo
+ * This softare uses the MIT license as below:
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining 
+ *	a copy of this software and associated documentation files (the "Software"), 
+ *	to deal in the Software without restriction, including without limitation 
+ *	the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+ *	and/or sell copies of the Software, and to permit persons to whom the Software 
+ *	is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all 
+ * copies or substantial portions of the Software.
+ *						    
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, 
+ *	INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR 
+ *	PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE 
+ *	FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, 
+ *	ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * \file    stagetimer.h
+ * \brief   timing of each stage of the code generation
+ * \author  Fenglai Liu
+ */
+#ifndef STAGETIMER_H
+#define STAGETIMER_H
+#include "general.h"
+
+/**
+ * the stages of code generation we time
+ */
+#define STAGE_RRSQ_SEARCH         0
+#define STAGE_FORM_RRSQ_LIST      1
+#define STAGE_SUB_FILES           2
+#define STAGE_PRINTING            3
+#define STAGE_ASSEMBLY            4
+#define N_STAGES                  5
+
+namespace stagetimer {
+
+	/**
+	 * \class StageTimer
+	 *
+	 * The StageTimer adds the wall time spent in its scope to the given
+	 * stage. It's created on the top of the code block to be timed:
+	 *
+	 * { StageTimer timer(STAGE_PRINTING); ... }
+	 *
+	 * The time of all stages is accumulated over the whole run, and it's
+	 * reported by printStageTiming() at the end of the program if 
+	 * stage_timing = true. The scopes of the same stage should not be 
+	 * nested, else the time is counted twice.
+	 */
+	class StageTimer {
+
+		private:
+
+			int stage;             ///< the stage we are timing
+			double start;          ///< the starting wall time
+
+		public:
+
+			/**
+			 * constructor - start the timing
+			 */
+			StageTimer(const int& stage0);
+
+			/**
+			 * destructor - add the time to the stage
+			 */
+			~StageTimer();
+	};
+
+	/**
+	 * current wall time in seconds
+	 */
+	double wallTime();
+
+	/**
+	 * the accumulated time for the given stage
+	 */
+	double getStageTime(const int& stage);
+
+	/**
+	 * print out the stage timing both on screen and into the given
+	 * file in JSON format; total is the wall time of the whole run.
+	 * The peak memory (RSS) of the program is printed too
+	 */
+	void printStageTiming(const string& file, const double& total);
+
+}
+
+#endif
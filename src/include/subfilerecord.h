@@ -183,6 +183,29 @@ namespace subfilerecord {
 			};
 	};
 
+	/**
+	 * form the sub file records by cutting the rrsq list (in printing 
+	 * order, that is the reverse order of the list) into chunks, the 
+	 * cut positions are chosen to minimize the integrals crossing them
+	 *
+	 * every shell quartet formed before a cut and used after it turns 
+	 * into a function input/output array, so the crossing integrals are
+	 * the memory traffic between the sub functions. The module output 
+	 * shell quartets are in array anyway, therefore they cost nothing.
+	 * The chunks are kept in printing order so that each sub file only
+	 * takes input from the previous ones. For balance, each chunk has 
+	 * the number of LHS integrals between (1-balance)*nLHSLimit and 
+	 * (1+balance)*nLHSLimit except the last one, which could be smaller;
+	 * like the LHS count cut the last rrsq in chunk could go over it.
+	 *
+	 * The cuts are found with dynamic programming over the positions.
+	 * If no cut satisfies the balance constraint (e.g. single rrsq is 
+	 * too large), we return false and the caller uses the LHS count cut
+	 */
+	bool formSubFilesByMinCut(const int& moduleName, const list<RRSQ>& rrsqList, 
+			const vector<ShellQuartet>& outputSQList, const int& nLHSLimit, 
+			const double& balance, vector<SubFileRecord>& subFilesList);
+
 }
 
 
@@ -67,6 +67,12 @@ namespace vrrinfor {
 			bool vrrContSplit;                 ///< does the vrr and contraction split in different parts?
 			int nextSection;                   ///< which is the next section of VRR
 			int oper;                          ///< operator information
+			bool gcVariant;                    ///< whether it's the general contraction variant
+			bool sigPairVariant;               ///< whether it loops over the significant pair lists
+			bool pairDataVariant;              ///< whether it takes the shell pair records
+			bool ketListVariant;               ///< whether it loops over the list of ket records
+			bool gemVariant;                   ///< whether it loops over the Gaussian geminal terms
+			int erfMode;                       ///< how the erf(omega*r12)/r12 operator is handled (ERF_RUNTIME etc.)
 
 			// 
 			// general information for RR
@@ -131,6 +137,14 @@ namespace vrrinfor {
 			void setupErfPrefactors(const int& maxLSum, 
 					const int& oper, const int& nSpace, ofstream& file) const;
 
+			///
+			/// for the range separated variant, generate the bottom integrals 
+			/// of 1/r12 and erf(omega*r12)/r12 and combine them with the coulFac
+			/// and erfFac, so that the VRR is done once for both operators
+			///
+			void combinedIntegralsGeneration(const int& maxLSum, 
+					const int& oper, const int& nSpace, ofstream& file) const;
+
 			///
 			/// perform significant integral testing for integrals with fmt function
 			///
@@ -166,11 +180,25 @@ namespace vrrinfor {
 			///
 			void printERIHead(ofstream& file, const SQIntsInfor& infor) const;
 
+			///
+			/// for the shell pair data variant, print the unpacking of bra or 
+			/// ket pair record (see test/include/shellpair.h) at the top. For 
+			/// the ket list variant the loop over kets is opened with the ket
+			///
+			void printPairDataHead(ofstream& file, const SQIntsInfor& infor, const int& side) const;
+
 			///
 			/// print the exp(-omega*r12^2) head (EXPR12 operator)
 			///
 			void printEXPR12Head(ofstream& file, const SQIntsInfor& infor) const;
 
+			///
+			/// print the RR coefficients of EXPR12 which depend on the omega,
+			/// for the geminal variant they are formed for each Gaussian term
+			///
+			void printEXPR12OmegaTerms(const bool& hasRR, const bool& hasRROnBRA, 
+					const bool& hasRROnKET, ofstream& file) const;
+
 			///
 			/// print NAI integral's head
 			///
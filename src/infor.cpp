@@ -115,9 +115,9 @@ bool WordConvert::isInt(string s) {
 Infor::Infor(const string& input):hasSPWithHighL(false),
 	nLHSForVRRSplit(30000),nLHSForHRR1Split(50000),nLHSForHRR2Split(50000),
 	nLHSForNonRRSplit(20000),nLHSForDerivSplit(40000),nTotalLHSLimit(60000),
-	maxParaForFunction(60),VRRSplitCoefs(0.25E0),nonRRArrayToVarCoef(0.25E0),totalLHSScaleFac(0.2E0),
+	maxParaForFunction(60),VRRSplitCoefs(0.25E0),nonRRArrayToVarCoef(0.25E0),totalLHSScaleFac(0.2E0),minCutSplit(false),splitBalance(0.25E0),
 	SPShellContDegree(3),DShellContDegree(1),FShellContDegree(1),LShellContDegree(1),  
-	derivOrder(0),maxL(5),auxMaxL(6),vec_form(USE_SCR_VEC),M_limit(10),fmt_error(12),
+	derivOrder(0),maxL(5),auxMaxL(6),vec_form(USE_SCR_VEC),stridedResult(false),scrMemPlan(false),threadLocalScr(false),kernelRegistry(false),sharedByLSum(false),kernelBenchmark(false),stageTiming(false),dryRun(false),kernelManifest(false),vrrLoopMinL(-1),rrByteCode(false),hrrTemplate(false),hrrMatrixMinL(-1),sameCenterKernels(false),symmetryKernels(false),gcKernels(false),sigPairKernels(false),pairDataKernels(false),ketListKernels(false),erfKernels(false),rsKernels(false),geminalKernels(false),M_limit(10),fmt_error(12),
 	hrr_method("hgp"),vrr_method("os")
 { 
 	// open the input file
@@ -299,6 +299,32 @@ Infor::Infor(const string& input):hasSPWithHighL(false),
 			totalLHSScaleFac = tmp;
 		}
 
+		// how we cut the rrsq list into sub files
+		if (w.compare(l.findValue(0), "split_method")) {
+			string value = l.findValue(1);
+			w.capitalize(value);
+			if (value == "MIN_CUT") {
+				minCutSplit = true;
+			}else if (value == "LHS_COUNT") {
+				minCutSplit = false;
+			}else{
+				crash(true, "Invalid split_method value given for infor class.");
+			}
+		}
+
+		// the balance of sub files for min cut split
+		if (w.compare(l.findValue(0), "split_balance")) {
+			string value = l.findValue(1);
+			double tmp = 0.0E0;
+			if (!w.toDouble(value,tmp)) {
+				crash(true, "In Infor we can not process split_balance. not a double value");
+			}
+			if (tmp < 0.0E0 || tmp >= 1.0E0) {
+				crash(true, "Invalid split_balance value given for infor class, it should be in [0,1).");
+			}
+			splitBalance = tmp;
+		}
+
 		/////////////////////////////////////////////
 		// !!!! contraction degree determination   //
 		/////////////////////////////////////////////
@@ -435,11 +461,293 @@ Infor::Infor(const string& input):hasSPWithHighL(false),
 				vec_form = STD_VEC;
 			}else if (value == "SCR") {
 				vec_form = USE_SCR_VEC;
+			}else if (value == "STACK") {
+				vec_form = USE_STACK_ARRAY;
 			}else{
 				crash(true, "Invalid option given in processing vector_form");
 			}
 		}
 
+		// how the result integrals are written into abcd?
+		if (w.compare(l.findValue(0), "result_layout")) {
+			string value = l.findValue(1);
+			w.capitalize(value);
+			if (value == "DENSE") {
+				stridedResult = false;
+			}else if (value == "STRIDED") {
+				stridedResult = true;
+			}else{
+				crash(true, "Invalid option given in processing result_layout");
+			}
+		}
+
+		// whether we plan the array memory according to their life time
+		if (w.compare(l.findValue(0), "scr_memory_plan")) {
+			string value = l.findValue(1);
+			w.capitalize(value);
+			if (value == "TRUE" || value == "T") {
+				scrMemPlan = true;
+			}else if (value == "FALSE" || value == "F") {
+				scrMemPlan = false;
+			}else{
+				crash(true, "Invalid scr_memory_plan value given for infor class.");
+			}
+		}
+
+		// where does the integral function get the scr?
+		if (w.compare(l.findValue(0), "scr_source")) {
+			string value = l.findValue(1);
+			w.capitalize(value);
+			if (value == "ARGUMENT") {
+				threadLocalScr = false;
+			}else if (value == "THREAD_LOCAL") {
+				threadLocalScr = true;
+			}else{
+				crash(true, "Invalid option given in processing scr_source");
+			}
+		}
+
+		// whether we print the registry of integral functions
+		if (w.compare(l.findValue(0), "kernel_registry")) {
+			string value = l.findValue(1);
+			w.capitalize(value);
+			if (value == "TRUE" || value == "T") {
+				kernelRegistry = true;
+			}else if (value == "FALSE" || value == "F") {
+				kernelRegistry = false;
+			}else{
+				crash(true, "Invalid kernel_registry value given for infor class.");
+			}
+		}
+
+		// how the integral functions are packaged with the registry
+		if (w.compare(l.findValue(0), "kernel_package")) {
+			string value = l.findValue(1);
+			w.capitalize(value);
+			if (value == "STATIC") {
+				sharedByLSum = false;
+			}else if (value == "SHARED_BY_L") {
+				sharedByLSum = true;
+			}else{
+				crash(true, "Invalid option given in processing kernel_package");
+			}
+		}
+
+		// whether we print the benchmark driver for the registry
+		if (w.compare(l.findValue(0), "kernel_benchmark")) {
+			string value = l.findValue(1);
+			w.capitalize(value);
+			if (value == "TRUE" || value == "T") {
+				kernelBenchmark = true;
+			}else if (value == "FALSE" || value == "F") {
+				kernelBenchmark = false;
+			}else{
+				crash(true, "Invalid kernel_benchmark value given for infor class.");
+			}
+		}
+
+		// whether we report the timing of each stage
+		if (w.compare(l.findValue(0), "stage_timing")) {
+			string value = l.findValue(1);
+			w.capitalize(value);
+			if (value == "TRUE" || value == "T") {
+				stageTiming = true;
+			}else if (value == "FALSE" || value == "F") {
+				stageTiming = false;
+			}else{
+				crash(true, "Invalid stage_timing value given for infor class.");
+			}
+		}
+
+		// whether this is a dry run
+		if (w.compare(l.findValue(0), "dry_run")) {
+			string value = l.findValue(1);
+			w.capitalize(value);
+			if (value == "TRUE" || value == "T") {
+				dryRun = true;
+			}else if (value == "FALSE" || value == "F") {
+				dryRun = false;
+			}else{
+				crash(true, "Invalid dry_run value given for infor class.");
+			}
+		}
+
+		// whether we print the manifest for each function
+		if (w.compare(l.findValue(0), "kernel_manifest")) {
+			string value = l.findValue(1);
+			w.capitalize(value);
+			if (value == "TRUE" || value == "T") {
+				kernelManifest = true;
+			}else if (value == "FALSE" || value == "F") {
+				kernelManifest = false;
+			}else{
+				crash(true, "Invalid kernel_manifest value given for infor class.");
+			}
+		}
+
+		// from which L sum the VRR is printed in loop form
+		if (w.compare(l.findValue(0), "vrr_loop_min_l")) {
+			string value = l.findValue(1);
+			int tmp = 0;
+			if (!w.toInt(value,tmp)) {
+				crash(true, "In Infor we can not process vrr_loop_min_l. not an integer");
+			}
+			vrrLoopMinL = tmp;
+		}
+
+		// whether the RR program is serialized into bytecode
+		if (w.compare(l.findValue(0), "rr_bytecode")) {
+			string value = l.findValue(1);
+			w.capitalize(value);
+			if (value == "TRUE" || value == "T") {
+				rrByteCode = true;
+			}else if (value == "FALSE" || value == "F") {
+				rrByteCode = false;
+			}else{
+				crash(true, "Invalid rr_bytecode value given for infor class.");
+			}
+		}
+
+		// whether the HRR is done by the template kernels
+		if (w.compare(l.findValue(0), "hrr_template")) {
+			string value = l.findValue(1);
+			w.capitalize(value);
+			if (value == "TRUE" || value == "T") {
+				hrrTemplate = true;
+			}else if (value == "FALSE" || value == "F") {
+				hrrTemplate = false;
+			}else{
+				crash(true, "Invalid hrr_template value given for infor class.");
+			}
+		}
+
+		// from which L sum the HRR kernel uses the transfer matrix form
+		if (w.compare(l.findValue(0), "hrr_matrix_min_l")) {
+			string value = l.findValue(1);
+			int tmp = 0;
+			if (!w.toInt(value,tmp)) {
+				crash(true, "In Infor we can not process hrr_matrix_min_l. not an integer");
+			}
+			hrrMatrixMinL = tmp;
+		}
+
+		// whether we generate the same center variants
+		if (w.compare(l.findValue(0), "same_center_kernels")) {
+			string value = l.findValue(1);
+			w.capitalize(value);
+			if (value == "TRUE" || value == "T") {
+				sameCenterKernels = true;
+			}else if (value == "FALSE" || value == "F") {
+				sameCenterKernels = false;
+			}else{
+				crash(true, "Invalid same_center_kernels value given for infor class.");
+			}
+		}
+
+		// whether we generate the permutational symmetry reduced variants
+		if (w.compare(l.findValue(0), "symmetry_kernels")) {
+			string value = l.findValue(1);
+			w.capitalize(value);
+			if (value == "TRUE" || value == "T") {
+				symmetryKernels = true;
+			}else if (value == "FALSE" || value == "F") {
+				symmetryKernels = false;
+			}else{
+				crash(true, "Invalid symmetry_kernels value given for infor class.");
+			}
+		}
+
+		// whether we generate the general contraction variants
+		if (w.compare(l.findValue(0), "general_contraction_kernels")) {
+			string value = l.findValue(1);
+			w.capitalize(value);
+			if (value == "TRUE" || value == "T") {
+				gcKernels = true;
+			}else if (value == "FALSE" || value == "F") {
+				gcKernels = false;
+			}else{
+				crash(true, "Invalid general_contraction_kernels value given for infor class.");
+			}
+		}
+
+		// whether we generate the significant pair list variants
+		if (w.compare(l.findValue(0), "sig_pair_kernels")) {
+			string value = l.findValue(1);
+			w.capitalize(value);
+			if (value == "TRUE" || value == "T") {
+				sigPairKernels = true;
+			}else if (value == "FALSE" || value == "F") {
+				sigPairKernels = false;
+			}else{
+				crash(true, "Invalid sig_pair_kernels value given for infor class.");
+			}
+		}
+
+		// whether we generate the shell pair data variants
+		if (w.compare(l.findValue(0), "pair_data_kernels")) {
+			string value = l.findValue(1);
+			w.capitalize(value);
+			if (value == "TRUE" || value == "T") {
+				pairDataKernels = true;
+			}else if (value == "FALSE" || value == "F") {
+				pairDataKernels = false;
+			}else{
+				crash(true, "Invalid pair_data_kernels value given for infor class.");
+			}
+		}
+
+		// whether we generate the ket list variants
+		if (w.compare(l.findValue(0), "ket_list_kernels")) {
+			string value = l.findValue(1);
+			w.capitalize(value);
+			if (value == "TRUE" || value == "T") {
+				ketListKernels = true;
+			}else if (value == "FALSE" || value == "F") {
+				ketListKernels = false;
+			}else{
+				crash(true, "Invalid ket_list_kernels value given for infor class.");
+			}
+		}
+
+		// whether the erf(omega*r12)/r12 operator is in its own variants
+		if (w.compare(l.findValue(0), "erf_kernels")) {
+			string value = l.findValue(1);
+			w.capitalize(value);
+			if (value == "TRUE" || value == "T") {
+				erfKernels = true;
+			}else if (value == "FALSE" || value == "F") {
+				erfKernels = false;
+			}else{
+				crash(true, "Invalid erf_kernels value given for infor class.");
+			}
+		}
+
+		// whether we generate the range separated variants
+		if (w.compare(l.findValue(0), "range_separated_kernels")) {
+			string value = l.findValue(1);
+			w.capitalize(value);
+			if (value == "TRUE" || value == "T") {
+				rsKernels = true;
+			}else if (value == "FALSE" || value == "F") {
+				rsKernels = false;
+			}else{
+				crash(true, "Invalid range_separated_kernels value given for infor class.");
+			}
+		}
+
+		// whether we generate the multi-Gaussian geminal variants
+		if (w.compare(l.findValue(0), "geminal_kernels")) {
+			string value = l.findValue(1);
+			w.capitalize(value);
+			if (value == "TRUE" || value == "T") {
+				geminalKernels = true;
+			}else if (value == "FALSE" || value == "F") {
+				geminalKernels = false;
+			}else{
+				crash(true, "Invalid geminal_kernels value given for infor class.");
+			}
+		}
+
 		// set M limit
 		if (w.compare(l.findValue(0), "m_limit")) {
 			string value = l.findValue(1);
@@ -472,6 +780,23 @@ Infor::Infor(const string& input):hasSPWithHighL(false),
 		crash(true,"Empty job list given in infor class");
 	}
 
+	// the plain functions generated with erf_kernels ignore omega, only
+	// the entry function of the registry routes the erf(r12)/r12 calls to 
+	// the erf variant
+	if (erfKernels && ! kernelRegistry) {
+		crash(true,"erf_kernels requires kernel_registry = true, else omega is not routed to the erf variant");
+	}
+
+	// the thread local pool replaces the heap allocation of vectors
+	// therefore the TBB/STD vector form turns into the scr form
+	if (threadLocalScr && (vec_form == TBB_VEC || vec_form == STD_VEC)) {
+		vec_form = USE_SCR_VEC;
+	}
+
+	// for dry run nothing is printed, so we keep the 
+	// project folder untouched
+	if (dryRun) return;
+
 	// finally, create the peoject folder
 	string project = getProjectName();
 	path p(project.c_str());
@@ -0,0 +1,1286 @@
+//
+// CPPINTS: A C++ Program to Generate Analytical Integrals Based on Gaussian
+// Form Primitive Functions
+//
+// Copyright (C) 2015 The State University of New York at Buffalo
+// This softare uses the MIT license as below:
+//
+//	Permission is hereby granted, free of charge, to any person obtaining 
+//	a copy of this software and associated documentation files (the "Software"), 
+//	to deal in the Software without restriction, including without limitation 
+//	the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//	and/or sell copies of the Software, and to permit persons to whom the Software 
+//	is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all 
+// copies or substantial portions of the Software.
+//						    
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, 
+//	INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR 
+//	PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE 
+//	FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, 
+//	ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+#include "boost/lexical_cast.hpp"
+#include <boost/algorithm/string.hpp>   // string handling
+#include <boost/filesystem.hpp>
+#include "inttype.h"
+#include "shellsymbol.h"
+#include "printing.h"
+#include "kernelregistry.h"
+using boost::lexical_cast;
+using namespace boost::filesystem;
+using namespace boost;
+using namespace inttype;
+using namespace printing;
+using namespace kernelregistry;
+
+long long KernelRecord::getLCode() const
+{
+	long long unit[] = {1, LCODE_UNIT_BRA2, LCODE_UNIT_KET1, LCODE_UNIT_KET2};
+	long long code = 0;
+	for(int i=0; i<(int)shellCodes.size(); i++) {
+		code += unit[i]*shellCodes[i];
+	}
+	return code;
+}
+
+int KernelRecord::getLSum() const
+{
+	// the composite shell code is lmin + lmax*100, so 
+	// we take the lmax
+	int lSum = 0;
+	for(int i=0; i<(int)shellCodes.size(); i++) {
+		int code = shellCodes[i];
+		if (code >= 100) code = code/100;
+		lSum += code;
+	}
+	return lSum;
+}
+
+string KernelRecord::getSCRLengthExpr() const
+{
+	string expr;
+	for(map<int,int>::const_iterator it=scrBlocks.begin(); it!=scrBlocks.end(); ++it) {
+		if (expr.size() > 0) expr = expr + "+";
+		if (it->second > 1) {
+			expr = expr + lexical_cast<string>(it->second) + "*";
+		}
+		expr = expr + "LocalMemScr::alignedLength(" + lexical_cast<string>(it->first) + ")";
+	}
+	if (expr.size() == 0) expr = "0";
+	return expr;
+}
+
+long long KernelRecord::getSCRLength(const int& unit) const
+{
+	long long len = 0;
+	for(map<int,int>::const_iterator it=scrBlocks.begin(); it!=scrBlocks.end(); ++it) {
+		long long n = ((it->first+unit-1)/unit)*unit;
+		len += n*it->second;
+	}
+	return len;
+}
+
+/**
+ * the name of code section used in the cost report and manifest
+ */
+static string getSectionName(const int& section)
+{
+	if (section == VRR)    return "vrr";
+	if (section == HRR1)   return "hrr1";
+	if (section == HRR2)   return "hrr2";
+	if (section == NON_RR) return "nonrr";
+	if (section == DERIV)  return "deriv";
+	crash(true, "invalid section passed in getSectionName");
+	return "";
+}
+
+/**
+ * print the cost of the section in JSON, for the manifest 
+ * we also print the details like the array shell quartets
+ */
+static void printSectionCost(const SectionCost& c, bool withDetails, ofstream& out)
+{
+	out << "{\"section\": \"" << getSectionName(c.section) << "\", \"flops\": " << c.getFlops()
+		<< ", \"n_lhs\": " << c.nLHS << ", \"n_rhs\": " << c.nRHS 
+		<< ", \"array_ints\": " << c.nArrayInts << ", \"var_ints\": " << c.nVarInts
+		<< ", \"sub_files\": " << c.nSubFiles;
+	if (withDetails) {
+		string split = "false";
+		if (c.nSubFiles > 0) split = "true";
+		out << ", \"split\": " << split << ", \"bottom_ints\": " << c.nBottomInts 
+			<< ", \"max_m\": " << c.maxM << ", \"array_sq\": [";
+		for(int i=0; i<(int)c.arraySQList.size(); i++) {
+			if (i > 0) out << ", ";
+			out << "\"" << c.arraySQList[i] << "\"";
+		}
+		out << "]";
+	}
+	out << "}";
+}
+
+long long KernelRecord::getSourceSizeEstimate() const
+{
+	// the coefficients are fitted to the generated code: the function
+	// has about 8K bytes of head, declarations and primitive loops, and
+	// each integral in the result adds 150 bytes for the contraction 
+	// and output. Each section (and each sub file) has about 4K bytes 
+	// of overhead, each LHS integral takes a line of about 40 bytes, 
+	// and each RHS term adds 25 bytes
+	long long size = 8000 + 150*(long long)nInts;
+	for(int i=0; i<(int)sectionCosts.size(); i++) {
+		const SectionCost& cost = sectionCosts[i];
+		size += 4000*(1+cost.nSubFiles) + 40*cost.nLHS + 25*cost.nRHS;
+	}
+	return size;
+}
+
+void KernelRecord::printManifest(const string& file) const
+{
+	ofstream out;
+	out.open(file.c_str(),std::ofstream::out);
+	crash(! out, "failed to open the manifest file " + file);
+
+	// the basic information of the function
+	string oname = getOperStringName(oper);
+	to_lower(oname);
+	out << "{" << endl;
+	out << "  \"function\": \"" << funcName << "\"," << endl;
+	out << "  \"operator\": \"" << oname << "\"," << endl;
+	out << "  \"lcode\": " << getLCode() << "," << endl;
+	out << "  \"n_ints\": " << nInts << "," << endl;
+
+	// the files, the main file goes first
+	out << "  \"files\": [";
+	for(int i=0; i<(int)fileNames.size(); i++) {
+		if (i > 0) out << ", ";
+		out << "\"" << fileNames[i] << "\"";
+	}
+	out << "]," << endl;
+
+	// FLOPs counted on the printed code, and the scr length
+	// in bytes for the double precision (see localmemscr.h)
+	out << "  \"prim_flops\": " << nPrimFlops << "," << endl;
+	out << "  \"cont_flops\": " << nContFlops << "," << endl;
+	out << "  \"scr_bytes\": " << getSCRLength(8)*8 << "," << endl;
+
+	// now the planning result for each section
+	out << "  \"sections\": [" << endl;
+	for(int i=0; i<(int)sectionCosts.size(); i++) {
+		out << "    ";
+		printSectionCost(sectionCosts[i],true,out);
+		if (i < (int)sectionCosts.size()-1) out << ",";
+		out << endl;
+	}
+	out << "  ]" << endl;
+	out << "}" << endl;
+	out.close();
+}
+
+void KernelRegistry::addKernel(const KernelRecord& record)
+{
+	// the function may be already there, since the two/three body eri
+	// are done ahead of eri. For normal run this is checked by the file 
+	// existence, however for dry run there's no file printed
+	vector<KernelRecord>& records = kernelRecords[record.oper];
+	for(int i=0; i<(int)records.size(); i++) {
+		if (records[i].funcName == record.funcName) return;
+	}
+	records.push_back(record);
+}
+
+void KernelRegistry::print() const
+{
+	// the variants with a different argument list go to their 
+	// own registry, see KernelRecord::getRegistrySuffix
+	for(map<int,vector<KernelRecord> >::const_iterator it=kernelRecords.begin(); 
+			it!=kernelRecords.end(); ++it) {
+		map<string,vector<KernelRecord> > registries;
+		for(int iRec=0; iRec<(int)it->second.size(); iRec++) {
+			const KernelRecord& record = it->second[iRec];
+			registries[record.getRegistrySuffix()].push_back(record);
+		}
+		for(map<string,vector<KernelRecord> >::const_iterator it2=registries.begin(); 
+				it2!=registries.end(); ++it2) {
+			printRegistry(it->first,it2->second);
+		}
+	}
+}
+
+void KernelRegistry::printCostReport(const string& file) const
+{
+	// the JSON file, one entry for each integral function
+	ofstream out;
+	out.open(file.c_str(),std::ofstream::out);
+	out << "[" << endl;
+	bool first = true;
+	long long nTotalBytes = 0;
+	int nTotalFuncs = 0;
+	int nTotalSubFiles = 0;
+	for(map<int,vector<KernelRecord> >::const_iterator it=kernelRecords.begin(); 
+			it!=kernelRecords.end(); ++it) {
+		const vector<KernelRecord>& records = it->second;
+		for(int iRec=0; iRec<(int)records.size(); iRec++) {
+			const KernelRecord& r = records[iRec];
+			if (! first) out << "," << endl;
+			first = false;
+			long long bytes = r.getSourceSizeEstimate();
+			int nSubFiles = 0;
+			out << "  {\"function\": \"" << r.funcName << "\", \"lcode\": " << r.getLCode()
+				<< ", \"n_ints\": " << r.nInts << ", \"sections\": [";
+			for(int i=0; i<(int)r.sectionCosts.size(); i++) {
+				const SectionCost& c = r.sectionCosts[i];
+				if (i > 0) out << ", ";
+				printSectionCost(c,false,out);
+				nSubFiles += c.nSubFiles;
+			}
+			out << "], \"sub_files\": " << nSubFiles << ", \"source_bytes\": " << bytes << "}";
+			nTotalBytes += bytes;
+			nTotalSubFiles += nSubFiles;
+			nTotalFuncs++;
+		}
+	}
+	out << endl << "]" << endl;
+	out.close();
+
+	// summary
+	cout << "dry run: " << nTotalFuncs << " integral functions, " << nTotalSubFiles 
+		<< " sub files, estimated source size " << nTotalBytes/1024 << " KB" << endl;
+	cout << "the cost of each integral function is in " << file << endl;
+}
+
+/**
+ * the slot of the shell code in the registry table, it's the position
+ * in the INPUT_SHELL_ANG_MOM_CODE: S, SP, P, D, F etc.
+ */
+static int getShellSlot(const int& code) 
+{
+	for(int i=0; i<MAX_INPUT_SHELL_TYPES; i++) {
+		if (code == INPUT_SHELL_ANG_MOM_CODE[i]) return i;
+	}
+	crash(true, "Failed to find shell code in getShellSlot");
+	return -1;
+}
+
+/**
+ * names for the group of integral functions in the shared object package
+ */
+static string getGroupFileName(const string& name, const int& group)
+{
+	return name + "_l" + lexical_cast<string>(group) + ".cpp";
+}
+
+static string getGroupLibName(const string& name, const int& group)
+{
+	return "lib" + name + "_l" + lexical_cast<string>(group) + ".so";
+}
+
+static string getGroupTableName(const string& name, const int& group)
+{
+	return name + "_l" + lexical_cast<string>(group) + "_funcs";
+}
+
+/**
+ * drop the type information from the argument list, so that 
+ * the argument could be passed to the function call
+ */
+static string getArgNames(const string& arg)
+{
+	vector<string> pieces;
+	split(pieces, arg, is_any_of(","));
+	string names;
+	for(int i=0; i<(int)pieces.size(); i++) {
+		string p = pieces[i];
+		trim(p);
+		size_t pos = p.find_last_of(" &*");
+		string name = p.substr(pos+1);
+		if (names.size() > 0) names = names + ",";
+		names = names + name;
+	}
+	return names;
+}
+
+void KernelRegistry::printRegistry(const int& oper, const vector<KernelRecord>& records) const
+{
+	//
+	// the entry function name, it's same with the one
+	// formed by util/headfiles.py
+	//
+	string oname = getOperStringName(oper);
+	to_lower(oname);
+	string name = infor.getProjectName() + "_" + oname;
+	if (infor.derivOrder == 1) name = name + "_d1";
+	if (infor.derivOrder == 2) name = name + "_d2";
+	string suffix = records[0].getRegistrySuffix();
+	name = name + suffix;
+	string NAME = name;
+	to_upper(NAME);
+
+	// the files are placed in the parent dir of the integral files
+	string any  = infor.getProjectFileDir(oper,"any.cpp",infor.derivOrder,false);
+	path dir    = path(any.c_str()).parent_path().parent_path();
+	string head = (dir / path((name+".h").c_str())).string();
+	string cpp  = (dir / path((name+".cpp").c_str())).string();
+
+	//
+	// all of integral functions share the same argument list, 
+	// except that the scr may only appear for some of them. 
+	// In the registry all of them take the scr if any of them does
+	//
+	string scrArg = ", LocalMemScr& scr";
+	string arg;
+	bool withSCRArg = false;
+	bool withSCR    = false;
+	for(int iRec=0; iRec<(int)records.size(); iRec++) {
+		string a = records[iRec].argList;
+		size_t pos = a.find(scrArg);
+		if (pos != string::npos) {
+			a = a.substr(0,pos);
+			withSCRArg = true;
+		}
+		if (records[iRec].scrBlocks.size() > 0) withSCR = true;
+		if (iRec == 0) arg = a;
+		crash(a != arg, "the integral functions have different argument list in KernelRegistry");
+	}
+	string funcArg = arg;
+	if (withSCRArg) funcArg = arg + scrArg;
+	if (withSCRArg) withSCR = true;
+
+	// the table dimension
+	int nBody  = 0;
+	int nSlots = 0;
+	for(int iRec=0; iRec<(int)records.size(); iRec++) {
+		const vector<int>& codes = records[iRec].shellCodes;
+		if ((int)codes.size() > nBody) nBody = codes.size();
+		for(int i=0; i<(int)codes.size(); i++) {
+			int slot = getShellSlot(codes[i]);
+			if (slot+1 > nSlots) nSlots = slot+1;
+		}
+	}
+	int size = 1;
+	for(int i=0; i<nBody; i++) size *= nSlots;
+
+	// now place the records into the table
+	// the same center and symmetry variants go with the plain function
+	vector<int> table(size,-1);
+	vector<vector<int> > sameCenter(3,vector<int>(size,-1));
+	vector<vector<int> > symmetry(5,vector<int>(size,-1));
+	vector<int> erf(size,-1);
+	bool withSameCenter = false;
+	bool withSymmetry   = false;
+	bool withErfVariant = false;
+	int maxNInts = 0;
+	int maxSCR[2] = {-1, -1};
+	int units[2]  = {8, 16};
+	for(int iRec=0; iRec<(int)records.size(); iRec++) {
+		const vector<int>& codes = records[iRec].shellCodes;
+		int index = 0;
+		for(int i=(int)codes.size()-1; i>=0; i--) {
+			index = index*nSlots + getShellSlot(codes[i]);
+		}
+		int slot = records[iRec].getSameCenterSlot();
+		int symSlot = records[iRec].getSymmetrySlot();
+		if (records[iRec].variant.kind == VARIANT_ERF_ONLY) {
+			erf[index] = iRec;
+			withErfVariant = true;
+		}else if (slot >= 0) {
+			sameCenter[slot][index] = iRec;
+			withSameCenter = true;
+		}else if (symSlot >= 0) {
+			symmetry[symSlot][index] = iRec;
+			withSymmetry = true;
+		}else{
+			crash(table[index] >= 0, "two integral functions share the same L code in KernelRegistry");
+			table[index] = iRec;
+		}
+		if (records[iRec].nInts > maxNInts) maxNInts = records[iRec].nInts;
+
+		// for double and float, the alignment unit is different
+		for(int i=0; i<2; i++) {
+			if (maxSCR[i] < 0 || records[iRec].getSCRLength(units[i]) > 
+					records[maxSCR[i]].getSCRLength(units[i])) {
+				maxSCR[i] = iRec;
+			}
+		}
+	}
+
+	//
+	// for the shared object package, the functions are grouped by
+	// the L sum; in each group they are placed in the order of table
+	//
+	bool shared = infor.packageByLSum();
+	int nGroups = 0;
+	map<int,vector<int> > groups;
+	vector<int> groupPos(records.size(),-1);
+	for(int index=0; index<size; index++) {
+		int iRec = table[index];
+		if (iRec < 0) continue;
+		int lSum = records[iRec].getLSum();
+		groupPos[iRec] = groups[lSum].size();
+		groups[lSum].push_back(iRec);
+		if (lSum+1 > nGroups) nGroups = lSum+1;
+		for(int slot=0; slot<3; slot++) {
+			int iVar = sameCenter[slot][index];
+			if (iVar < 0) continue;
+			groupPos[iVar] = groups[lSum].size();
+			groups[lSum].push_back(iVar);
+		}
+		for(int slot=0; slot<5; slot++) {
+			int iVar = symmetry[slot][index];
+			if (iVar < 0) continue;
+			groupPos[iVar] = groups[lSum].size();
+			groups[lSum].push_back(iVar);
+		}
+		if (erf[index] >= 0) {
+			int iVar = erf[index];
+			groupPos[iVar] = groups[lSum].size();
+			groups[lSum].push_back(iVar);
+		}
+	}
+
+	/////////////////////////////////////////////////////////////////
+	//                     the head file                           //
+	/////////////////////////////////////////////////////////////////
+	ofstream file;
+	file.open(head.c_str(),std::ofstream::out);
+	string line = "#ifndef  " + NAME + "_H";
+	printLine(0,line,file);
+	line = "#define " + NAME + "_H";
+	printLine(0,line,file);
+	file << endl;
+	line = "#include <cstddef>";
+	printLine(0,line,file);
+	if (withSCR) {
+		line = "#include \"localmemscr.h\"";
+		printLine(0,line,file);
+		line = "using namespace localmemscr;";
+		printLine(0,line,file);
+	}else{
+		line = "typedef int             Int; ";
+		printLine(0,line,file);
+		line = "typedef long long       LInt; ";
+		printLine(0,line,file);
+		line = "typedef size_t          UInt; ";
+		printLine(0,line,file);
+		line = "#ifdef WITH_SINGLE_PRECISION ";
+		printLine(0,line,file);
+		line = "typedef float           Double;";
+		printLine(0,line,file);
+		line = "#else";
+		printLine(0,line,file);
+		line = "typedef double          Double;";
+		printLine(0,line,file);
+		line = "#endif";
+		printLine(0,line,file);
+	}
+
+	// the shell pair data and ket list variants take the pair records
+	if (records[0].variant.kind == VARIANT_PAIR_DATA || records[0].variant.kind == VARIANT_KET_LIST) {
+		line = "#include \"shellpair.h\"";
+		printLine(0,line,file);
+	}
+	file << endl;
+
+	// function prototypes
+	for(int iRec=0; iRec<(int)records.size(); iRec++) {
+		line = "void " + records[iRec].funcName + "(" + records[iRec].argList + ");";
+		printLine(0,line,file);
+	}
+	file << endl;
+
+	// the table entry
+	line = "/**";
+	printLine(0,line,file);
+	line = " * registry entry of the integral functions, the table is indexed";
+	printLine(0,line,file);
+	line = " * by " + name + "_index(LCode). The FLOPs are estimated by counting";
+	printLine(0,line,file);
+	line = " * the arithmetic operations in the code: nPrimFlops is for each loop";
+	printLine(0,line,file);
+	line = " * over the primitives, and nContFlops is for the rest of code";
+	printLine(0,line,file);
+	if (shared) {
+		line = " * the integral function is the pos-th one in the function table of";
+		printLine(0,line,file);
+		line = " * the group (L sum), which is loaded by " + name + "_group(group)";
+		printLine(0,line,file);
+	}
+	line = " */";
+	printLine(0,line,file);
+	line = "typedef void (*" + name + "_func)(" + funcArg + ");";
+	printLine(0,line,file);
+	line = "struct " + name + "_entry {";
+	printLine(0,line,file);
+	if (shared) {
+		line = "UInt group;              ///< the group of the integral function, it's the L sum";
+		printLine(2,line,file);
+		line = "UInt pos;                ///< position in the function table of the group";
+		printLine(2,line,file);
+	}else{
+		line = name + "_func func;        ///< the integral function, NULL if it's not generated";
+		printLine(2,line,file);
+	}
+	line = "UInt nInts;              ///< number of result integrals, 0 if it's not generated";
+	printLine(2,line,file);
+	line = "UInt scrLen;             ///< the scr length (in unit of Double) required";
+	printLine(2,line,file);
+	line = "UInt nPrimFlops;         ///< estimated FLOPs for each loop over primitives";
+	printLine(2,line,file);
+	line = "UInt nContFlops;         ///< estimated FLOPs out of the primitive loops";
+	printLine(2,line,file);
+	if (withSameCenter && shared) {
+		line = "Int sameCenterPos[3];    ///< position of the variants for A==B, C==D and both, -1 if not generated";
+		printLine(2,line,file);
+	}else if (withSameCenter) {
+		line = name + "_func sameCenter[3]; ///< variants for A==B, C==D and both, NULL if not generated";
+		printLine(2,line,file);
+	}
+	if (withSymmetry && shared) {
+		line = "Int symmetryPos[5];      ///< position of the variants for (aa|aa), (aa|cc), (ab|ab), (aa|cd) and (ab|cc)";
+		printLine(2,line,file);
+	}else if (withSymmetry) {
+		line = name + "_func symmetry[5];   ///< variants for (aa|aa), (aa|cc), (ab|ab), (aa|cd) and (ab|cc)";
+		printLine(2,line,file);
+	}
+	if (withErfVariant && shared) {
+		line = "Int erfPos;              ///< position of the erf(omega*r12)/r12 variant, -1 if not generated";
+		printLine(2,line,file);
+	}else if (withErfVariant) {
+		line = name + "_func erf;         ///< the erf(omega*r12)/r12 variant, NULL if not generated";
+		printLine(2,line,file);
+	}
+	line = "};";
+	printLine(0,line,file);
+	file << endl;
+
+	// the table dimension and the maximum values
+	line = "const UInt " + NAME + "_N_SLOTS       = " + lexical_cast<string>(nSlots) + ";";
+	printLine(0,line,file);
+	line = "const UInt " + NAME + "_REGISTRY_SIZE = " + lexical_cast<string>(size) + ";";
+	printLine(0,line,file);
+	line = "const UInt " + NAME + "_MAX_N_INTS    = " + lexical_cast<string>(maxNInts) + ";";
+	printLine(0,line,file);
+	string maxSCRExpr = "0";
+	if (withSCR) {
+		string e0 = records[maxSCR[0]].getSCRLengthExpr();
+		string e1 = records[maxSCR[1]].getSCRLengthExpr();
+		maxSCRExpr = e0;
+		if (maxSCR[0] != maxSCR[1]) {
+			maxSCRExpr = "((" + e0 + ")>(" + e1 + ") ? (" + e0 + ") : (" + e1 + "))";
+		}
+	}
+	line = "const UInt " + NAME + "_MAX_SCR_LEN   = " + maxSCRExpr + ";";
+	printLine(0,line,file);
+	if (shared) {
+		line = "const UInt " + NAME + "_N_GROUPS      = " + lexical_cast<string>(nGroups) + ";";
+		printLine(0,line,file);
+	}
+	line = "extern const " + name + "_entry " + name + "_registry[" + NAME + "_REGISTRY_SIZE];";
+	printLine(0,line,file);
+	file << endl;
+
+	// the group loader
+	if (shared) {
+		line = "/**";
+		printLine(0,line,file);
+		line = " * return the function table of the given group, the shared object";
+		printLine(0,line,file);
+		line = " * of the group is loaded in the first call (see kernelloader.h)";
+		printLine(0,line,file);
+		line = " */";
+		printLine(0,line,file);
+		line = "const " + name + "_func* " + name + "_group(const UInt& group);";
+		printLine(0,line,file);
+		file << endl;
+	}
+
+	// the index function
+	line = "/**";
+	printLine(0,line,file);
+	line = " * the slot of shell code in the registry: S, SP, P, D, F etc.";
+	printLine(0,line,file);
+	line = " */";
+	printLine(0,line,file);
+	line = "inline UInt " + name + "_slot(const LInt& code) {";
+	printLine(0,line,file);
+	line = "if (code == " + lexical_cast<string>(INPUT_SHELL_ANG_MOM_CODE[1]) + ") return 1;";
+	printLine(2,line,file);
+	line = "if (code == 0) return 0;";
+	printLine(2,line,file);
+	line = "return code+1;";
+	printLine(2,line,file);
+	line = "}";
+	printLine(0,line,file);
+	file << endl;
+	for(int i=0; i<MAX_INPUT_SHELL_TYPES; i++) {
+		int code = INPUT_SHELL_ANG_MOM_CODE[i];
+		int slot = code+1;
+		if (code == 0) slot = 0;
+		if (code == INPUT_SHELL_ANG_MOM_CODE[1]) slot = 1;
+		crash(slot != i, "the slot function does not match the shell code in KernelRegistry");
+	}
+	line = "/**";
+	printLine(0,line,file);
+	line = " * the registry index for the given L code";
+	printLine(0,line,file);
+	line = " * " + NAME + "_REGISTRY_SIZE is returned if it's out of the table";
+	printLine(0,line,file);
+	line = " */";
+	printLine(0,line,file);
+	line = "inline UInt " + name + "_index(const LInt& LCode) {";
+	printLine(0,line,file);
+	string unit[]  = {"1", lexical_cast<string>(LCODE_UNIT_BRA2), 
+		lexical_cast<string>(LCODE_UNIT_KET1), lexical_cast<string>(LCODE_UNIT_KET2)};
+	string indexExpr;
+	for(int i=0; i<nBody; i++) {
+		string code = "LCode";
+		if (i > 0) code = code + "/" + unit[i];
+		if (i > 0 && i < 3) code = "(" + code + ")";
+		if (i < 3) code = code + "%" + lexical_cast<string>(LCODE_UNIT_BRA2);
+		string s = "s" + lexical_cast<string>(i+1);
+		line = "UInt " + s + " = " + name + "_slot(" + code + ");";
+		printLine(2,line,file);
+		line = "if (" + s + " >= " + NAME + "_N_SLOTS) return " + NAME + "_REGISTRY_SIZE;";
+		printLine(2,line,file);
+		if (i == 0) {
+			indexExpr = s;
+		}else if (i == nBody-1) {
+			indexExpr = indexExpr + "+" + NAME + "_N_SLOTS*" + s;
+		}else{
+			indexExpr = indexExpr + "+" + NAME + "_N_SLOTS*(" + s;
+		}
+	}
+	for(int i=2; i<nBody; i++) indexExpr = indexExpr + ")";
+	if (nBody < 4) {
+		line = "if (LCode/" + unit[nBody] + " > 0) return " + NAME + "_REGISTRY_SIZE;";
+		printLine(2,line,file);
+	}
+	line = "return " + indexExpr + ";";
+	printLine(2,line,file);
+	line = "}";
+	printLine(0,line,file);
+	file << endl;
+
+	// entry function
+	line = "/**";
+	printLine(0,line,file);
+	line = " * the entry function, it dispatches the work to the integral function by L code";
+	printLine(0,line,file);
+	line = " */";
+	printLine(0,line,file);
+	line = "void " + name + "(const LInt& LCode, " + funcArg + ");";
+	printLine(0,line,file);
+	file << endl;
+
+	// the scr length by L code, same with the one printed by util/headfiles.py
+	line = "/**";
+	printLine(0,line,file);
+	line = " * the scr length required by the integral function of the L code, 0 if it's not generated";
+	printLine(0,line,file);
+	line = " */";
+	printLine(0,line,file);
+	line = "UInt " + name + "_scr_len(const LInt& LCode);";
+	printLine(0,line,file);
+	file << endl;
+	line = "#endif";
+	printLine(0,line,file);
+	file.close();
+
+	/////////////////////////////////////////////////////////////////
+	//                      the cpp file                           //
+	/////////////////////////////////////////////////////////////////
+	file.open(cpp.c_str(),std::ofstream::out);
+	line = "#include \"" + name + ".h\"";
+	printLine(0,line,file);
+	line = "#include <cstdio>";
+	printLine(0,line,file);
+	line = "#include <cassert>";
+	printLine(0,line,file);
+	if (withErfVariant) {
+		line = "#include <cmath>";
+		printLine(0,line,file);
+	}
+	if (shared) {
+		line = "#include <mutex>";
+		printLine(0,line,file);
+		line = "#include \"kernelloader.h\"";
+		printLine(0,line,file);
+		line = "using namespace kernelloader;";
+		printLine(0,line,file);
+	}
+	file << endl;
+
+	// the functions without scr are called through a wrapper
+	// so that all of the functions in table share the same type
+	// for the shared object package, they go with the group
+	if (! shared) {
+		vector<int> recList(records.size());
+		for(int iRec=0; iRec<(int)records.size(); iRec++) recList[iRec] = iRec;
+		printEntryWrappers(records,recList,arg,withSCRArg,file);
+	}
+
+	// now the table
+	line = "const " + name + "_entry " + name + "_registry[" + NAME + "_REGISTRY_SIZE] = {";
+	printLine(0,line,file);
+	for(int index=0; index<size; index++) {
+		string end = ",";
+		if (index == size-1) end = "";
+		int iRec = table[index];
+		string variants;
+		if (withSameCenter) {
+			for(int slot=0; slot<3; slot++) {
+				int iVar = sameCenter[slot][index];
+				string v = shared ? "-1" : "NULL";
+				if (iVar >= 0 && shared) {
+					v = lexical_cast<string>(groupPos[iVar]);
+				}else if (iVar >= 0) {
+					v = "&" + records[iVar].funcName;
+					if (withSCRArg && records[iVar].argList.find(scrArg) == string::npos) v = v + "_entry";
+				}
+				variants = variants + (slot == 0 ? ", {" : ", ") + v;
+			}
+			variants = variants + "}";
+		}
+		if (withSymmetry) {
+			for(int slot=0; slot<5; slot++) {
+				int iVar = symmetry[slot][index];
+				string v = shared ? "-1" : "NULL";
+				if (iVar >= 0 && shared) {
+					v = lexical_cast<string>(groupPos[iVar]);
+				}else if (iVar >= 0) {
+					v = "&" + records[iVar].funcName;
+					if (withSCRArg && records[iVar].argList.find(scrArg) == string::npos) v = v + "_entry";
+				}
+				variants = variants + (slot == 0 ? ", {" : ", ") + v;
+			}
+			variants = variants + "}";
+		}
+		if (withErfVariant) {
+			int iVar = erf[index];
+			string v = shared ? "-1" : "NULL";
+			if (iVar >= 0 && shared) {
+				v = lexical_cast<string>(groupPos[iVar]);
+			}else if (iVar >= 0) {
+				v = "&" + records[iVar].funcName;
+				if (withSCRArg && records[iVar].argList.find(scrArg) == string::npos) v = v + "_entry";
+			}
+			variants = variants + ", " + v;
+		}
+		if (iRec < 0) {
+			line = "{NULL, 0, 0, 0, 0" + variants + "}" + end;
+			if (shared) line = "{0, 0, 0, 0, 0, 0" + variants + "}" + end;
+			printLine(2,line,file);
+			continue;
+		}
+		const KernelRecord& r = records[iRec];
+		string func = "&" + r.funcName;
+		if (withSCRArg && r.argList.find(scrArg) == string::npos) func = func + "_entry";
+		if (shared) {
+			func = lexical_cast<string>(r.getLSum()) + ", " + lexical_cast<string>(groupPos[iRec]);
+		}
+		string scr = "0";
+		if (withSCR) scr = r.getSCRLengthExpr();
+		line = "{" + func + ", " + lexical_cast<string>(r.nInts) + ", " + scr + ", " + 
+			lexical_cast<string>(r.nPrimFlops) + ", " + lexical_cast<string>(r.nContFlops) + variants + "}" + end;
+		printLine(2,line,file);
+	}
+	line = "};";
+	printLine(0,line,file);
+	file << endl;
+
+	// the group loader, each group is loaded once even if 
+	// the entry function is called by multiple threads
+	if (shared) {
+		string libs;
+		string symbols;
+		for(int iGroup=0; iGroup<nGroups; iGroup++) {
+			string lib = "NULL";
+			string sym = "NULL";
+			if (groups.find(iGroup) != groups.end()) {
+				lib = "\"" + getGroupLibName(name,iGroup) + "\"";
+				sym = "\"" + getGroupTableName(name,iGroup) + "\"";
+			}
+			if (iGroup > 0) {
+				libs = libs + ", ";
+				symbols = symbols + ", ";
+			}
+			libs = libs + lib;
+			symbols = symbols + sym;
+		}
+		line = "static const char* " + name + "_libs[" + NAME + "_N_GROUPS] = {" + libs + "};";
+		printLine(0,line,file);
+		line = "static const char* " + name + "_tables[" + NAME + "_N_GROUPS] = {" + symbols + "};";
+		printLine(0,line,file);
+		line = "static const " + name + "_func* " + name + "_group_funcs[" + NAME + "_N_GROUPS];";
+		printLine(0,line,file);
+		line = "static std::once_flag " + name + "_group_flags[" + NAME + "_N_GROUPS];";
+		printLine(0,line,file);
+		file << endl;
+		line = "static void " + name + "_load_group(const UInt group)";
+		printLine(0,line,file);
+		line = "{";
+		printLine(0,line,file);
+		line = "void* table = loadKernelGroup(" + name + "_libs[group]," + name + "_tables[group]);";
+		printLine(2,line,file);
+		line = name + "_group_funcs[group] = static_cast<const " + name + "_func*>(table);";
+		printLine(2,line,file);
+		line = "}";
+		printLine(0,line,file);
+		file << endl;
+		line = "const " + name + "_func* " + name + "_group(const UInt& group)";
+		printLine(0,line,file);
+		line = "{";
+		printLine(0,line,file);
+		line = "std::call_once(" + name + "_group_flags[group]," + name + "_load_group,group);";
+		printLine(2,line,file);
+		line = "return " + name + "_group_funcs[group];";
+		printLine(2,line,file);
+		line = "}";
+		printLine(0,line,file);
+		file << endl;
+	}
+
+	// the entry function
+	line = "void " + name + "(const LInt& LCode, " + funcArg + ")";
+	printLine(0,line,file);
+	line = "{";
+	printLine(0,line,file);
+	line = "UInt index = " + name + "_index(LCode);";
+	printLine(2,line,file);
+	line = "if (index >= " + NAME + "_REGISTRY_SIZE || " + name + "_registry[index].func == NULL) {";
+	if (shared) {
+		line = "if (index >= " + NAME + "_REGISTRY_SIZE || " + name + "_registry[index].nInts == 0) {";
+	}
+	printLine(2,line,file);
+	line = "printf(\"%s %lld\\n\",\"Un-recognized LCode in the integrals calculation \", LCode);";
+	printLine(4,line,file);
+	line = "assert(0);";
+	printLine(4,line,file);
+	line = "return;";
+	printLine(4,line,file);
+	line = "}";
+	printLine(2,line,file);
+	string callNames = getArgNames(funcArg);
+	if (withSameCenter || withSymmetry || withErfVariant) {
+
+		// route the shell quartets to the variants by the centers
+		line = "const " + name + "_entry& entry = " + name + "_registry[index];";
+		printLine(2,line,file);
+		string none = shared ? " >= 0" : " != NULL";
+
+		// the erf(omega*r12)/r12 operator goes to its own variant, omega 
+		// is taken as 0 in the same way as THRESHOLD_MATH in the functions
+		if (withErfVariant) {
+			string var = shared ? "entry.erfPos" : "entry.erf";
+			line = "if (fabs(omega)>1.0E-14 && " + var + none + ") {";
+			printLine(2,line,file);
+			line = var + "(" + callNames + ");";
+			if (shared) line = name + "_group(entry.group)[" + var + "](" + callNames + ");";
+			printLine(4,line,file);
+			line = "return;";
+			printLine(4,line,file);
+			line = "}";
+			printLine(2,line,file);
+		}
+		if (withSameCenter || withSymmetry) {
+			line = "bool sameAB = (A[0] == B[0] && A[1] == B[1] && A[2] == B[2]);";
+			printLine(2,line,file);
+			line = "bool sameCD = (C[0] == D[0] && C[1] == D[1] && C[2] == D[2]);";
+			printLine(2,line,file);
+		}
+		if (shared) {
+			line = "Int pos = entry.pos;";
+		}else{
+			line = name + "_func func = entry.func;";
+		}
+		printLine(2,line,file);
+		string lhs = shared ? "pos" : "func";
+		if (withSameCenter) {
+			string var  = shared ? "entry.sameCenterPos" : "entry.sameCenter";
+			line = "if (sameAB && sameCD && " + var + "[2]" + none + ") {";
+			printLine(2,line,file);
+			line = lhs + " = " + var + "[2];";
+			printLine(4,line,file);
+			line = "}else if (sameAB && " + var + "[0]" + none + ") {";
+			printLine(2,line,file);
+			line = lhs + " = " + var + "[0];";
+			printLine(4,line,file);
+			line = "}else if (sameCD && " + var + "[1]" + none + ") {";
+			printLine(2,line,file);
+			line = lhs + " = " + var + "[1];";
+			printLine(4,line,file);
+			line = "}";
+			printLine(2,line,file);
+		}
+		if (withSymmetry) {
+
+			// the bra pair is same with the ket pair only when 
+			// all of the pair data are same
+			string var  = shared ? "entry.symmetryPos" : "entry.symmetry";
+			line = "bool samePair = (inp2 == jnp2 && A[0] == C[0] && A[1] == C[1] && A[2] == C[2] && ";
+			printLine(2,line,file);
+			line = "B[0] == D[0] && B[1] == D[1] && B[2] == D[2]);";
+			printLine(6,line,file);
+			line = "for(UInt ip2=0; samePair && ip2<inp2; ip2++) {";
+			printLine(2,line,file);
+			line = "samePair = (icoe[ip2] == jcoe[ip2] && iexp[ip2] == jexp[ip2] && ifac[ip2] == jfac[ip2] && ";
+			printLine(4,line,file);
+			line = "P[3*ip2] == Q[3*ip2] && P[3*ip2+1] == Q[3*ip2+1] && P[3*ip2+2] == Q[3*ip2+2]);";
+			printLine(8,line,file);
+			line = "}";
+			printLine(2,line,file);
+			line = "Int sym = (sameAB ? " + lexical_cast<string>(SYM_BRA) + " : 0) | (sameCD ? " + 
+				lexical_cast<string>(SYM_KET) + " : 0) | (samePair ? " + lexical_cast<string>(SYM_BRAKET) + " : 0);";
+			printLine(2,line,file);
+			// the masks are in the order of KernelRecord::getSymmetrySlot
+			int masks[] = {SYM_BRA|SYM_KET|SYM_BRAKET, SYM_BRA|SYM_KET, SYM_BRAKET, SYM_BRA, SYM_KET};
+			line = "const Int symMasks[5] = {";
+			for(int slot=0; slot<5; slot++) {
+				if (slot > 0) line = line + ", ";
+				line = line + lexical_cast<string>(masks[slot]);
+			}
+			line = line + "};";
+			printLine(2,line,file);
+			line = "for(Int i=0; i<5; i++) {";
+			printLine(2,line,file);
+			line = "if ((sym & symMasks[i]) == symMasks[i] && " + var + "[i]" + none + ") {";
+			printLine(4,line,file);
+			line = lhs + " = " + var + "[i];";
+			printLine(6,line,file);
+			line = "break;";
+			printLine(6,line,file);
+			line = "}";
+			printLine(4,line,file);
+			line = "}";
+			printLine(2,line,file);
+		}
+		line = "func(" + callNames + ");";
+		if (shared) line = name + "_group(entry.group)[pos](" + callNames + ");";
+	}else{
+		line = name + "_registry[index].func(" + callNames + ");";
+		if (shared) {
+			line = "const " + name + "_entry& entry = " + name + "_registry[index];";
+			printLine(2,line,file);
+			line = name + "_group(entry.group)[entry.pos](" + callNames + ");";
+		}
+	}
+	printLine(2,line,file);
+	line = "}";
+	printLine(0,line,file);
+	file << endl;
+
+	// the scr length
+	line = "UInt " + name + "_scr_len(const LInt& LCode)";
+	printLine(0,line,file);
+	line = "{";
+	printLine(0,line,file);
+	line = "UInt index = " + name + "_index(LCode);";
+	printLine(2,line,file);
+	line = "if (index >= " + NAME + "_REGISTRY_SIZE) return 0;";
+	printLine(2,line,file);
+	line = "return " + name + "_registry[index].scrLen;";
+	printLine(2,line,file);
+	line = "}";
+	printLine(0,line,file);
+	file.close();
+
+	// the benchmark driver
+	if (infor.withKernelBenchmark() && suffix.empty()) {
+		printBenchmark(oper,name,records,table,arg,withSCRArg,dir.string());
+	}
+
+	// finally the group files
+	if (shared) {
+		printGroupFiles(name,records,groups,arg,withSCRArg,dir.string(),
+				path(any.c_str()).parent_path().filename().string());
+	}
+}
+
+void KernelRegistry::printEntryWrappers(const vector<KernelRecord>& records, 
+		const vector<int>& recList, const string& arg, bool withSCRArg, ofstream& file) const
+{
+	if (! withSCRArg) return;
+	string scrArg   = ", LocalMemScr& scr";
+	string funcArg  = arg + scrArg;
+	string argNames = getArgNames(arg);
+	for(int i=0; i<(int)recList.size(); i++) {
+		const KernelRecord& r = records[recList[i]];
+		if (r.argList.find(scrArg) != string::npos) continue;
+		string line = "static void " + r.funcName + "_entry(" + funcArg + ") {";
+		printLine(0,line,file);
+		line = r.funcName + "(" + argNames + ");";
+		printLine(2,line,file);
+		line = "}";
+		printLine(0,line,file);
+		file << endl;
+	}
+}
+
+void KernelRegistry::printBenchmark(const int& oper, const string& name, const vector<KernelRecord>& records, 
+		const vector<int>& table, const string& arg, bool withSCRArg, const string& dir) const
+{
+	string NAME = name;
+	to_upper(NAME);
+	bool shared = infor.packageByLSum();
+	string cpp  = (path(dir.c_str()) / path((name+"_bench.cpp").c_str())).string();
+	ofstream file;
+	file.open(cpp.c_str(),std::ofstream::out);
+
+	// head part
+	string line = "//";
+	printLine(0,line,file);
+	line = "// benchmark driver for the integral functions of " + name + ", build it with";
+	printLine(0,line,file);
+	if (shared) {
+		line = "// " + name + ".cpp (and -ldl), the shared objects are loaded as usual. Run it like";
+	}else{
+		line = "// " + name + ".cpp and all of integral files. Run it like";
+	}
+	printLine(0,line,file);
+	line = "// ./" + name + "_bench nprim=3 screen=0.5 json=" + name + ".json";
+	printLine(0,line,file);
+	line = "// all of options please refer to the kernelbench.h";
+	printLine(0,line,file);
+	line = "//";
+	printLine(0,line,file);
+	line = "#include \"" + name + ".h\"";
+	printLine(0,line,file);
+	line = "#include \"kernelbench.h\"";
+	printLine(0,line,file);
+	line = "using namespace kernelbench;";
+	printLine(0,line,file);
+	file << endl;
+
+	// the function list
+	vector<int> recList;
+	for(int index=0; index<(int)table.size(); index++) {
+		if (table[index] >= 0) recList.push_back(table[index]);
+	}
+	int nFuncs = recList.size();
+	line = "static const UInt nFuncs = " + lexical_cast<string>(nFuncs) + ";";
+	printLine(0,line,file);
+	line = "static const char* funcNames[nFuncs] = {";
+	printLine(0,line,file);
+	for(int i=0; i<nFuncs; i++) {
+		line = "\"" + records[recList[i]].funcName + "\"";
+		if (i < nFuncs-1) line = line + ",";
+		printLine(2,line,file);
+	}
+	line = "};";
+	printLine(0,line,file);
+	line = "static const LInt LCodes[nFuncs] = {";
+	printLine(0,line,file);
+	for(int i=0; i<nFuncs; i++) {
+		line = lexical_cast<string>(records[recList[i]].getLCode()) + "LL";
+		if (i < nFuncs-1) line = line + ",";
+		printLine(2,line,file);
+	}
+	line = "};";
+	printLine(0,line,file);
+	file << endl;
+
+	// the arguments are taken from the benchmark data
+	string callNames;
+	vector<string> names;
+	string argNames = getArgNames(arg);
+	split(names, argNames, is_any_of(","));
+	for(int i=0; i<(int)names.size(); i++) {
+		if (i > 0) callNames = callNames + ",";
+		callNames = callNames + "d." + names[i];
+	}
+	if (withSCRArg) callNames = callNames + ",scr";
+
+	// the number of primitive loops for each call, for two body 
+	// integrals there's no ket side; for ESP the whole function 
+	// is in the loop of grid points
+	string primLoops = "nSigPairs";
+	if (arg.find("jnp2") != string::npos) primLoops = primLoops + "*data[0]->jnp2";
+	string flops = "(entry.nPrimFlops*" + primLoops + "+entry.nContFlops)";
+	if (resultIntegralHasAdditionalOffset(oper)) flops = flops + "*opt.nGrids";
+
+	line = "int main(int argc, char* argv[])";
+	printLine(0,line,file);
+	line = "{";
+	printLine(0,line,file);
+	line = "// set up the random geometries";
+	printLine(2,line,file);
+	line = "KernelBenchOptions opt(argc,argv);";
+	printLine(2,line,file);
+	line = "std::mt19937 gen(opt.seed);";
+	printLine(2,line,file);
+	line = "DoubleVec result(" + NAME + "_MAX_N_INTS*opt.nGrids,ZERO);";
+	printLine(2,line,file);
+	line = "vector<KernelBenchData*> data(opt.nSets);";
+	printLine(2,line,file);
+	line = "Double nSigPairs = ZERO;";
+	printLine(2,line,file);
+	line = "for(UInt i=0; i<opt.nSets; i++) {";
+	printLine(2,line,file);
+	line = "data[i] = new KernelBenchData(gen,opt,&result[0]);";
+	printLine(4,line,file);
+	line = "nSigPairs += data[i]->nSigPairs;";
+	printLine(4,line,file);
+	line = "}";
+	printLine(2,line,file);
+	line = "nSigPairs = nSigPairs/opt.nSets;";
+	printLine(2,line,file);
+	if (withSCRArg) {
+		line = "LocalMemScr scr(" + NAME + "_MAX_SCR_LEN);";
+		printLine(2,line,file);
+	}
+	file << endl;
+	line = "// now time each integral function";
+	printLine(2,line,file);
+	line = "KernelBenchReport report(opt,\"" + name + "\");";
+	printLine(2,line,file);
+	line = "for(UInt k=0; k<nFuncs; k++) {";
+	printLine(2,line,file);
+	line = "string func = funcNames[k];";
+	printLine(4,line,file);
+	line = "if (func.find(opt.only) == string::npos) continue;";
+	printLine(4,line,file);
+	line = "const " + name + "_entry& entry = " + name + "_registry[" + name + "_index(LCodes[k])];";
+	printLine(4,line,file);
+	if (shared) {
+		line = name + "_func f = " + name + "_group(entry.group)[entry.pos];";
+	}else{
+		line = name + "_func f = entry.func;";
+	}
+	printLine(4,line,file);
+	bool withErfVariant = false;
+	for(int i=0; i<(int)records.size(); i++) {
+		if (records[i].variant.kind == VARIANT_ERF_ONLY) withErfVariant = true;
+	}
+	if (withErfVariant) {
+		line = "if (fabs(opt.omega)>1.0E-14 && entry.erf != NULL) f = entry.erf;";
+		if (shared) {
+			line = "if (fabs(opt.omega)>1.0E-14 && entry.erfPos >= 0) f = " + name + "_group(entry.group)[entry.erfPos];";
+		}
+		printLine(4,line,file);
+	}
+	file << endl;
+	line = "// warm up, then repeat it over all of geometries until the time is enough";
+	printLine(4,line,file);
+	line = "const KernelBenchData& d = *data[0];";
+	printLine(4,line,file);
+	line = "f(" + callNames + ");";
+	printLine(4,line,file);
+	line = "UInt nCalls = 0;";
+	printLine(4,line,file);
+	line = "Double t0 = benchTime();";
+	printLine(4,line,file);
+	line = "Double t  = ZERO;";
+	printLine(4,line,file);
+	line = "do {";
+	printLine(4,line,file);
+	line = "for(UInt i=0; i<opt.nSets; i++) {";
+	printLine(6,line,file);
+	line = "const KernelBenchData& d = *data[i];";
+	printLine(8,line,file);
+	line = "f(" + callNames + ");";
+	printLine(8,line,file);
+	line = "}";
+	printLine(6,line,file);
+	line = "nCalls += opt.nSets;";
+	printLine(6,line,file);
+	line = "t = benchTime()-t0;";
+	printLine(6,line,file);
+	line = "} while(t<opt.minTime);";
+	printLine(4,line,file);
+	line = "Double flops = " + flops + ";";
+	printLine(4,line,file);
+	line = "report.add(func,LCodes[k],entry.nInts,nCalls,t,flops);";
+	printLine(4,line,file);
+	line = "}";
+	printLine(2,line,file);
+	line = "report.print();";
+	printLine(2,line,file);
+	file << endl;
+	line = "for(UInt i=0; i<opt.nSets; i++) delete data[i];";
+	printLine(2,line,file);
+	line = "return 0;";
+	printLine(2,line,file);
+	line = "}";
+	printLine(0,line,file);
+	file.close();
+}
+
+void KernelRegistry::printGroupFiles(const string& name, const vector<KernelRecord>& records, 
+		const map<int,vector<int> >& groups, const string& arg, bool withSCRArg, 
+		const string& dir, const string& subDir) const
+{
+	//
+	// each group has a cpp file exporting the function table
+	// with C linkage, so that the loader could find it by dlsym
+	//
+	string scrArg = ", LocalMemScr& scr";
+	string line;
+	ofstream file;
+	for(map<int,vector<int> >::const_iterator it=groups.begin(); it!=groups.end(); ++it) {
+		string cpp = (path(dir.c_str()) / path(getGroupFileName(name,it->first).c_str())).string();
+		file.open(cpp.c_str(),std::ofstream::out);
+		line = "#include \"" + name + ".h\"";
+		printLine(0,line,file);
+		file << endl;
+		printEntryWrappers(records,it->second,arg,withSCRArg,file);
+		line = "extern \"C\" const " + name + "_func " + getGroupTableName(name,it->first) + "[] = {";
+		printLine(0,line,file);
+		const vector<int>& recList = it->second;
+		for(int i=0; i<(int)recList.size(); i++) {
+			const KernelRecord& r = records[recList[i]];
+			line = "&" + r.funcName;
+			if (withSCRArg && r.argList.find(scrArg) == string::npos) line = line + "_entry";
+			if (i < (int)recList.size()-1) line = line + ",";
+			printLine(2,line,file);
+		}
+		line = "};";
+		printLine(0,line,file);
+		file.close();
+	}
+
+	//
+	// the makefile to build the shared objects, the integral files
+	// are given relative to the folder of registry files
+	//
+	string NAME = name;
+	to_upper(NAME);
+	string mk = (path(dir.c_str()) / path((name+"_lib.mk").c_str())).string();
+	file.open(mk.c_str(),std::ofstream::out);
+	line = "#";
+	printLine(0,line,file);
+	line = "# shared objects of " + name + " for each L sum, they are loaded by";
+	printLine(0,line,file);
+	line = "# the entry function on the first use (see kernelloader.h). Please";
+	printLine(0,line,file);
+	line = "# set CXX and CXXFLAGS (with -I to localmemscr.h and kernelloader.h),";
+	printLine(0,line,file);
+	line = "# the program calling " + name + " links " + name + ".cpp with -ldl";
+	printLine(0,line,file);
+	line = "#";
+	printLine(0,line,file);
+	string libs;
+	for(map<int,vector<int> >::const_iterator it=groups.begin(); it!=groups.end(); ++it) {
+		libs = libs + " " + getGroupLibName(name,it->first);
+	}
+	line = NAME + "_LIBS =" + libs;
+	printLine(0,line,file);
+	file << endl;
+	line = name + "_libs: $(" + NAME + "_LIBS)";
+	printLine(0,line,file);
+	file << endl;
+	for(map<int,vector<int> >::const_iterator it=groups.begin(); it!=groups.end(); ++it) {
+		line = getGroupLibName(name,it->first) + ": " + getGroupFileName(name,it->first);
+		const vector<int>& recList = it->second;
+		for(int i=0; i<(int)recList.size(); i++) {
+			const vector<string>& files = records[recList[i]].fileNames;
+			for(int j=0; j<(int)files.size(); j++) {
+				line = line + " \\\n\t" + subDir + "/" + files[j];
+			}
+		}
+		file << line << endl;
+		file << "\t$(CXX) $(CXXFLAGS) -fPIC -shared $^ -o $@" << endl;
+		file << endl;
+	}
+	file.close();
+}
@@ -26,24 +26,44 @@
 #include "inttype.h"
 #include "sqints.h"
 #include "infor.h"
+#include "kernelregistry.h"
+#include "stagetimer.h"
 using namespace inttype;
 using namespace infor;
 using namespace sqints;
+using namespace kernelregistry;
+using namespace stagetimer;
 
-extern void codeGen(const Infor& infor, const int& oper);
+extern void codeGen(const Infor& infor, const int& oper, KernelRegistry& registry);
 
 int main(int argc, char* argv[]) {
 
 	// we should have infor file passed in
+	double startTime = wallTime();
 	string inforFile = argv[1];
 	Infor infor(inforFile);
 
 	// now do jobs
+	KernelRegistry registry(infor);
 	const vector<int>& joblist = infor.getJobList();
 	int nJobs = joblist.size();
 	for(int iJob=0; iJob<nJobs; iJob++) {
 		int job = joblist[iJob];
-		codeGen(infor,job);
+		codeGen(infor,job,registry);
+	}
+
+	// for dry run, we report the cost of each integral function
+	// else it's the registry of integral functions for each operator
+	if (infor.isDryRun()) {
+		registry.printCostReport("dry_run.json");
+	}else if (infor.withKernelRegistry()) {
+		StageTimer timer(STAGE_PRINTING);
+		registry.print();
+	}
+
+	// timing of each stage in code generation
+	if (infor.withStageTiming()) {
+		printStageTiming("stage_timing.json",wallTime()-startTime);
 	}
 
 	/*
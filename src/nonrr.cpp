@@ -97,54 +97,72 @@ void NONRR::buildRRSQList()
 
 			// build the rrsq and insert the new one into the result list
 			RRSQ rrsq(NULL_POS,NULL_POS,sq,intList,dir);
-			rrsqList.push_back(rrsq);
+			appendRRSQ(rrsq);
+		}
+	}
 
-			// now create new shell quartet list for the output 
-			for(int item=0; item<rrsq.getNItems(); item++) {
+	// finally, we need to sort the rrsq list
+	rrsqList.sort();
+}
 
-				// get the corresponding sq
-				const ShellQuartet& rhsSQ = rrsq.getRHSSQ(item);
+void NONRR::buildSameCenterRRSQList(const bool& sameBra, const bool& sameKet)
+{
+	// the gather is a non-RR work, placed between HRR and the result
+	codeSec = NON_RR;
+	for(int iSQ=0; iSQ<(int)inputSQList.size(); iSQ++) {
+		const ShellQuartet& sq  = inputSQList[iSQ];
+		const set<int>& intList = inputIntList[iSQ];
+		RRSQ rrsq(sq,intList,sameBra,sameKet);
+		appendRRSQ(rrsq);
+	}
+	rrsqList.sort();
+}
 
-				// obtain unsolved integral list
-				set<int> newUnsolvedList;
-				rrsq.getUnsolvedIntList(item,newUnsolvedList);
+void NONRR::appendRRSQ(const RRSQ& rrsq)
+{
+	rrsqList.push_back(rrsq);
 
-				// whether this sq is already contained in the tmp sq list?
-				int pos = -1;
-				for(int i=0; i<(int)resultSQList.size(); i++) {
-					if (resultSQList[i] == rhsSQ) {
-						pos = i;
-						break;
-					}
-				}
+	// now create new shell quartet list for the output 
+	for(int item=0; item<rrsq.getNItems(); item++) {
 
-				// if it's totally a new one, we just do simple update
-				// else we need to merge the new unsolved list with the 
-				// one already existing in the tmpUnsolvedIntList
-				if (pos == -1) {
-					resultSQList.push_back(rhsSQ);
-					unsolvedIntList.push_back(newUnsolvedList);
-				}else{
-
-					// now we fetch the old unsolved list from tmpUnsolvedIntList
-					set<int>& oldUnsolvedList = unsolvedIntList[pos];
-
-					// we need to merge the new and old 
-					for(set<int>::iterator it=newUnsolvedList.begin(); 
-							it != newUnsolvedList.end(); ++it) {
-						int val = *it;
-						set<int>::iterator it2=oldUnsolvedList.find(val);
-						if (it2 == oldUnsolvedList.end()) {
-							oldUnsolvedList.insert(val);
-						}
-					}
+		// get the corresponding sq
+		const ShellQuartet& rhsSQ = rrsq.getRHSSQ(item);
+
+		// obtain unsolved integral list
+		set<int> newUnsolvedList;
+		rrsq.getUnsolvedIntList(item,newUnsolvedList);
+
+		// whether this sq is already contained in the tmp sq list?
+		int pos = -1;
+		for(int i=0; i<(int)resultSQList.size(); i++) {
+			if (resultSQList[i] == rhsSQ) {
+				pos = i;
+				break;
+			}
+		}
+
+		// if it's totally a new one, we just do simple update
+		// else we need to merge the new unsolved list with the 
+		// one already existing in the tmpUnsolvedIntList
+		if (pos == -1) {
+			resultSQList.push_back(rhsSQ);
+			unsolvedIntList.push_back(newUnsolvedList);
+		}else{
+
+			// now we fetch the old unsolved list from tmpUnsolvedIntList
+			set<int>& oldUnsolvedList = unsolvedIntList[pos];
+
+			// we need to merge the new and old 
+			for(set<int>::iterator it=newUnsolvedList.begin(); 
+					it != newUnsolvedList.end(); ++it) {
+				int val = *it;
+				set<int>::iterator it2=oldUnsolvedList.find(val);
+				if (it2 == oldUnsolvedList.end()) {
+					oldUnsolvedList.insert(val);
 				}
 			}
 		}
 	}
-
-	// finally, we need to sort the rrsq list
-	rrsqList.sort();
 }
 
 int NONRR::countLHSIntNumbers() const
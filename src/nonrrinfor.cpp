@@ -200,7 +200,7 @@ void NONRRInfor::formSubFiles(const SQIntsInfor& infor, const NONRR& nonrr)
 
 		// now let's see whether we have global result
 		if (hasABCD) {
-			arg = arg + "Double* abcd";
+			arg = arg + infor.getResultArgList();
 		}
 
 		// finally we have to check the ","
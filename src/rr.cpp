@@ -22,6 +22,7 @@
 //	ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //
 //
+#include<map>
 #include "rrsqsearch.h"
 #include "sqintsinfor.h"
 #include "rrints.h"
@@ -32,6 +33,7 @@
 #include "vrrinfor.h"
 #include "hrrinfor.h"
 #include "derivinfor.h"
+#include "stagetimer.h"
 #include "expfacinfor.h"
 #include "rr.h"
 using boost::lexical_cast;
@@ -45,6 +47,7 @@ using namespace hrrinfor;
 using namespace inttype;
 using namespace derivinfor;
 using namespace expfacinfor;
+using namespace stagetimer;
 using namespace rr;
 
 ///////////////////////////////////////////////////////////////////////////
@@ -597,6 +600,9 @@ void RR::completenessCheck()
 
 void RR::formRRSQList()
 {
+	// timing for this stage
+	StageTimer timer(STAGE_FORM_RRSQ_LIST);
+
 	// first step, build the rrsq list
 	// we intentionally put everythig into a braket
 	// so that to make the building process local
@@ -674,10 +680,12 @@ void RR::generateRRSQList(const int& side0)
 	// build the optimum RR path in advance 
 	// and collecting the result path
 	if (rrType == HRR) {
+		StageTimer timer(STAGE_RRSQ_SEARCH);
 		RRSQSearch sqOptSearch(side,initSQList);
 		optRRList = sqOptSearch.getSolvedSQList();
 		posList   = sqOptSearch.getPosList(); 
 	}else{
+		StageTimer timer(STAGE_RRSQ_SEARCH);
 		RRSQSearch sqOptSearch(initSQList,rrType);
 		optRRList = sqOptSearch.getSolvedSQList();
 		posList   = sqOptSearch.getPosList(); 
@@ -768,8 +776,81 @@ void RR::updateHRRInfor(const HRRInfor& infor)
 	}
 }
 
-void RR::vrrPrint(const SQIntsInfor& infor, const VRRInfor& vrrinfor) const
+void RR::updateVRRLoopForm(const SQIntsInfor& infor, const VRRInfor& vrrinfor)
 {
+	// check the rr type
+	if (rrType == HRR) {
+		crash(true, "RR::updateVRRLoopForm only applies for VRR");
+	}
+
+	// which function each LHS is printed in, and whether it's 
+	// passed out of the function in array form
+	// for the case without file split all of them are in one function
+	map<string,int> funcIndex;
+	vector<string> funcOutput;
+	if (vrrinfor.fileSplit()) {
+		for(int iSub=0; iSub<vrrinfor.getNSubFiles(); iSub++) {
+			const SubFileRecord& record = vrrinfor.getSubFileRecord(iSub);
+			const vector<ShellQuartet>& lhs = record.getLHSSQList();
+			const vector<int>&    lhsStatus = record.getLHSSQStatus();
+			for(int iSQ=0; iSQ<(int)lhs.size(); iSQ++) {
+				funcIndex[lhs[iSQ].getName()] = iSub;
+				if (lhsStatus[iSQ] == FUNC_INOUT_SQ) funcOutput.push_back(lhs[iSQ].getName());
+			}
+		}
+	}
+
+	// the module results, without the multipliers
+	vector<ShellQuartet> results;
+	results.reserve(inputSQList.size());
+	for(int iSQ=0; iSQ<(int)inputSQList.size(); iSQ++) {
+		ShellQuartet sq(inputSQList[iSQ]);
+		sq.destroyMultipliers();
+		results.push_back(sq);
+	}
+
+	// now let's see which rrsq is in loop form
+	for(list<RRSQ>::iterator it=rrsqList.begin(); it!=rrsqList.end(); ++it) {
+		const ShellQuartet& sq = it->getLHSSQ();
+		if (! infor.withVRRLoopForm(sq.getLSum())) continue;
+		string name = sq.getName();
+		int index = funcIndex.count(name) > 0 ? funcIndex[name] : 0;
+
+		// the module results are used in contraction in variable form,
+		// so as the function output
+		bool unpack = false;
+		if (find(results.begin(),results.end(),sq) != results.end()) unpack = true;
+		if (find(funcOutput.begin(),funcOutput.end(),name) != funcOutput.end()) unpack = true;
+
+		// now the rrsq using it on the RHS
+		// they are printed later than this one
+		for(list<RRSQ>::iterator it2=rrsqList.begin(); it2!=rrsqList.end(); ++it2) {
+			bool isRHS = false;
+			for(int item=0; item<it2->getNItems(); item++) {
+				if (it2->getRHSSQ(item) == sq) {
+					isRHS = true;
+					break;
+				}
+			}
+			if (! isRHS) continue;
+			const ShellQuartet& lhsSQ = it2->getLHSSQ();
+			string lhsName = lhsSQ.getName();
+			int index2 = funcIndex.count(lhsName) > 0 ? funcIndex[lhsName] : 0;
+			if (infor.withVRRLoopForm(lhsSQ.getLSum()) && index2 == index) {
+				it2->rhsLoopIndexTransform(*it);
+			}else{
+				unpack = true;
+			}
+		}
+		it->updateLoopForm(unpack);
+	}
+}
+
+void RR::vrrPrint(const SQIntsInfor& infor, const VRRInfor& vrrinfor)
+{
+	// set up the loop form of rrsq
+	updateVRRLoopForm(infor,vrrinfor);
+
 	// print out VRR results
 	vrrinfor.printVRRHead(infor);
 
@@ -0,0 +1,218 @@
+//
+// CPPINTS: A C++ Program to Generate Analytical Integrals Based on Gaussian
+// Form Primitive Functions
+//
+// Copyright (C) 2015 The State University of New York at Buffalo
+// This softare uses the MIT license as below:
+//
+//	Permission is hereby granted, free of charge, to any person obtaining
+//	a copy of this software and associated documentation files (the "Software"),
+//	to deal in the Software without restriction, including without limitation
+//	the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//	and/or sell copies of the Software, and to permit persons to whom the Software
+//	is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//	INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+//	PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+//	FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+//	ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//
+#include<cmath>
+#include "boost/lexical_cast.hpp"
+#include "inttype.h"
+#include "sqintsinfor.h"
+#include "rrints.h"
+#include "rr.h"
+#include "rrbytecode.h"
+using boost::lexical_cast;
+using namespace inttype;
+using namespace rrints;
+using namespace rrbytecode;
+
+//
+// the symbols of RR coefficients, the position in the list is the
+// symbol code in the bytecode. It must be kept same with the list
+// in test/include/rrinterp.h
+//
+static const char* RR_SYMBOLS[] = {
+	"1",
+	"PAX", "PAY", "PAZ", "PBX", "PBY", "PBZ",
+	"QCX", "QCY", "QCZ", "QDX", "QDY", "QDZ",
+	"WPX", "WPY", "WPZ", "WQX", "WQY", "WQZ",
+	"oned2z", "oned2e", "oned2k", "rhod2zsq", "rhod2esq",
+	"ABX", "ABY", "ABZ", "CDX", "CDY", "CDZ"
+};
+static const int N_RR_SYMBOLS = sizeof(RR_SYMBOLS)/sizeof(RR_SYMBOLS[0]);
+
+int RRByteCode::getSlot(map<string,int>& slots, const ShellQuartet& sq, const int& index)
+{
+	string key = sq.getName() + "_" + lexical_cast<string>(index);
+	map<string,int>::const_iterator it = slots.find(key);
+	if (it != slots.end()) return it->second;
+	int slot = slots.size();
+	slots[key] = slot;
+	return slot;
+}
+
+void RRByteCode::updateBottom(const ShellQuartet& sq)
+{
+	int m = sq.getM();
+	if (m >= (int)bottomCode.size()) bottomCode.resize(m+1,-1);
+	bottomCode[m] = getSlot(primSlots,sq,0);
+	if (m > maxM) maxM = m;
+}
+
+bool RRByteCode::appendRR(const RR& rr, bool isVRR, vector<int>& code)
+{
+	// the VRR works on the primitive integrals, HRR on the contracted ones
+	map<string,int>& slots = isVRR ? primSlots : contSlots;
+
+	// the rrsq is performed in reverse order of the list
+	const list<RRSQ>& rrsqList = rr.getRRSQList();
+	for(list<RRSQ>::const_reverse_iterator it=rrsqList.rbegin(); it!=rrsqList.rend(); ++it) {
+
+		// the LHS
+		const ShellQuartet& lhsSQ = it->getLHSSQ();
+		const list<int>& LHS = it->getLHSIndexArray();
+		if (! isVRR) contSQList.insert(make_pair(lhsSQ.getName(),lhsSQ));
+		vector<int> lhsSlots;
+		lhsSlots.reserve(LHS.size());
+		for(list<int>::const_iterator it2=LHS.begin(); it2!=LHS.end(); ++it2) {
+			lhsSlots.push_back(getSlot(slots,lhsSQ,*it2));
+		}
+
+		// now form the terms for each LHS integral
+		int nItems = it->getNItems();
+		vector<vector<int> > terms(LHS.size());
+		for(int item=0; item<nItems; item++) {
+			const ShellQuartet& rhsSQ = it->getRHSSQ(item);
+			const list<int>& RHS = it->getRHSIndexArray(item);
+			const list<string>& coe = it->getCoeArray(item);
+			list<int>::const_iterator itRHS = RHS.begin();
+			list<string>::const_iterator itCoe = coe.begin();
+			for(int k=0; k<(int)LHS.size(); k++, ++itRHS, ++itCoe) {
+				if (*itRHS == NULL_POS) continue;
+
+				// the coefficient must be in the symbol list, and
+				// the multiplier must be an integer
+				double m = 1.0E0;
+				string expression;
+				splitCoefficient(*itCoe,m,expression);
+				int symbol = -1;
+				for(int i=0; i<N_RR_SYMBOLS; i++) {
+					if (expression == RR_SYMBOLS[i]) {
+						symbol = i;
+						break;
+					}
+				}
+				if (symbol < 0 || fabs(m-floor(m+0.5E0))>1.0E-12) return false;
+				terms[k].push_back(symbol);
+				terms[k].push_back((int)floor(m+0.5E0));
+				terms[k].push_back(getSlot(slots,rhsSQ,*itRHS));
+				if (isVRR && rhsSQ.isSTypeSQ()) updateBottom(rhsSQ);
+			}
+		}
+
+		// append the steps
+		for(int k=0; k<(int)LHS.size(); k++) {
+			code.push_back(lhsSlots[k]);
+			code.push_back(terms[k].size()/3);
+			code.insert(code.end(),terms[k].begin(),terms[k].end());
+		}
+	}
+	return true;
+}
+
+RRByteCode::RRByteCode(const SQIntsInfor& infor, const RR& vrr, const RR& hrr1,
+		const RR& hrr2):valid(false),nInts(infor.nInts()),maxM(0)
+{
+	// currently we only do ERI energy integrals
+	// the composite shells need additional coefficients in contraction
+	if (infor.getOper() != ERI || infor.getJobOrder() > 0 || infor.isComSQ()) return;
+
+	// VRR
+	if (! appendRR(vrr,true,vrrCode)) return;
+
+	// the results of VRR may be the bottom integrals, too
+	const vector<ShellQuartet>& results = vrr.getRRResultSQList();
+	for(int iSQ=0; iSQ<(int)results.size(); iSQ++) {
+		const ShellQuartet& sq = results[iSQ];
+		if (sq.isSTypeSQ()) updateBottom(sq);
+	}
+
+	// contraction, the results of VRR are summed into the contracted slots
+	const vector<set<int> >& intList = vrr.getRRUnsolvedIntList();
+	for(int iSQ=0; iSQ<(int)results.size(); iSQ++) {
+		const ShellQuartet& sq = results[iSQ];
+		contSQList.insert(make_pair(sq.getName(),sq));
+		const set<int>& ints = intList[iSQ];
+		for(set<int>::const_iterator it=ints.begin(); it!=ints.end(); ++it) {
+			contCode.push_back(getSlot(contSlots,sq,*it));
+			contCode.push_back(getSlot(primSlots,sq,*it));
+		}
+	}
+
+	// HRR, the first side is done first
+	if (infor.hasSection(HRR1)) {
+		if (! appendRR(hrr1,false,hrrCode)) return;
+	}
+	if (infor.hasSection(HRR2)) {
+		if (! appendRR(hrr2,false,hrrCode)) return;
+	}
+
+	// finally the output, all of integrals of the result
+	// shell quartets must be there
+	int nOutput = 0;
+	for(map<string,ShellQuartet>::const_iterator it=contSQList.begin(); it!=contSQList.end(); ++it) {
+		const ShellQuartet& sq = it->second;
+		if (! infor.isResult(sq)) continue;
+		for(int index=0; index<sq.getNInts(); index++) {
+			string key = sq.getName() + "_" + lexical_cast<string>(index);
+			map<string,int>::const_iterator it2 = contSlots.find(key);
+			if (it2 == contSlots.end()) return;
+			outputCode.push_back(infor.getOffset(sq,index));
+			outputCode.push_back(it2->second);
+			nOutput++;
+		}
+	}
+	if (nOutput != nInts) return;
+	valid = true;
+}
+
+void RRByteCode::print(const string& file) const
+{
+	if (! valid) {
+		crash(true, "RRByteCode::print is called for an invalid bytecode");
+	}
+
+	// header
+	vector<int> words;
+	words.push_back(RR_BYTECODE_MAGIC);
+	words.push_back(RR_BYTECODE_VERSION);
+	words.push_back(nInts);
+	words.push_back(primSlots.size());
+	words.push_back(contSlots.size());
+	words.push_back(maxM);
+
+	// now sections
+	const vector<int>* sections[] = {&bottomCode, &vrrCode, &contCode, &hrrCode, &outputCode};
+	for(int i=0; i<5; i++) {
+		const vector<int>& code = *sections[i];
+		words.push_back(code.size());
+		words.insert(words.end(),code.begin(),code.end());
+	}
+
+	// write it in 32 bit integers
+	vector<int32_t> data(words.begin(),words.end());
+	ofstream out(file.c_str(),std::ios::binary);
+	if (! out) {
+		crash(true, "RRByteCode::print can not open the file " + file);
+	}
+	out.write(reinterpret_cast<const char*>(&data[0]),data.size()*sizeof(int32_t));
+	out.close();
+}
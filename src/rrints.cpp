@@ -40,7 +40,7 @@ using namespace rrints;
 
 RRSQ::RRSQ(const int& rrType0, const int& pos, const ShellQuartet& sq,
 		const set<int>& unsolvedIntegralList, int dir):rrType(rrType0),oper(sq.getOper()), 
-	position(pos),direction(dir),lhsSQStatus(VARIABLE_SQ),oriSQ(sq)
+	position(pos),direction(dir),lhsSQStatus(VARIABLE_SQ),loopForm(false),loopUnpack(false),oriSQ(sq)
 {
 	if (isDerivWork()) {
 		RRBuild generalRR(oper,oriSQ.get1stDerivPos(),oriSQ.get2edDerivPos(),
@@ -55,6 +55,60 @@ RRSQ::RRSQ(const int& rrType0, const int& pos, const ShellQuartet& sq,
 	}
 }
 
+RRSQ::RRSQ(const ShellQuartet& sq, const set<int>& unsolvedIntegralList, 
+		const bool& sameBra, const bool& sameKet):rrType(NULL_POS),oper(sq.getOper()),
+	position(NULL_POS),direction(NO_DERIV),lhsSQStatus(VARIABLE_SQ),loopForm(false),
+	loopUnpack(false),oriSQ(sq)
+{
+	// the RHS shell quartet, on the same center side all of 
+	// angular momentum goes to the first shell
+	int L1 = sq.getShell(BRA1).getL();
+	int L2 = sq.getShell(BRA2).getL();
+	int L3 = sq.getShell(KET1).getL();
+	int L4 = sq.getShell(KET2).getL();
+	if (sameBra) {
+		L1 = L1 + L2;
+		L2 = 0;
+	}
+	if (sameKet) {
+		L3 = L3 + L4;
+		L4 = 0;
+	}
+	Shell s1(L1), s2(L2), s3(L3), s4(L4);
+	ShellQuartet rhsSQ(s1,s2,s3,s4,oper,sq.getM(),sq.getDivision());
+	sqPosList.push_back(0);
+	sqlist.push_back(rhsSQ);
+	rhsSQStatus.assign(1,VARIABLE_SQ); 
+	rhsInLoop.assign(1,false); 
+	RHS.push_back(list<int>());
+	coe.push_back(list<string>());
+
+	// each LHS integral is just one RHS integral
+	for(set<int>::const_iterator it = unsolvedIntegralList.begin(); 
+			it != unsolvedIntegralList.end(); ++it) {
+		int index = *it; 
+		LHS.push_back(index);
+		Integral I(sq,index);
+		int l1, m1, n1, l2, m2, n2, l3, m3, n3, l4, m4, n4;
+		I.getBasis(BRA1).getlmn(l1,m1,n1);
+		I.getBasis(BRA2).getlmn(l2,m2,n2);
+		I.getBasis(KET1).getlmn(l3,m3,n3);
+		I.getBasis(KET2).getlmn(l4,m4,n4);
+		if (sameBra) {
+			l1 += l2; m1 += m2; n1 += n2;
+			l2 = m2 = n2 = 0;
+		}
+		if (sameKet) {
+			l3 += l4; m3 += m4; n3 += n4;
+			l4 = m4 = n4 = 0;
+		}
+		Basis b1(l1,m1,n1), b2(l2,m2,n2), b3(l3,m3,n3), b4(l4,m4,n4);
+		Integral J(b1,b2,b3,b4,oper);
+		RHS[0].push_back(J.getIndex());
+		coe[0].push_back("1");
+	}
+}
+
 void RRSQ::setupExpression(const set<int>& unsolvedIntegralList, const RRBuild& generalRR)
 {
 	// form the shell quartet list in the RHS
@@ -83,6 +137,7 @@ void RRSQ::setupExpression(const set<int>& unsolvedIntegralList, const RRBuild&
 
 	// the default rhs shell quartet status always local variable
 	rhsSQStatus.assign(getNItems(),VARIABLE_SQ); 
+	rhsInLoop.assign(getNItems(),false); 
 
 	// initialize the RHS and coefficients
 	RHS.reserve(getNItems());
@@ -517,6 +572,34 @@ void RRSQ::lhsArrayIndexTransform()
 	}
 }
 
+void RRSQ::rhsLoopIndexTransform(const RRSQ& rrsq)
+{
+	// let's check whether the lhs of rrsq appears in this rhs
+	int rhsItem = -1;
+	const ShellQuartet& sq = rrsq.getLHSSQ();
+	for(int item=0; item<getNItems(); item++) {
+		const ShellQuartet& rhsSQ = getRHSSQ(item);
+		if (rhsSQ == sq) {
+			rhsItem = item; 
+			break;
+		}
+	}
+	if (rhsItem<0) return;
+
+	// the loop array keeps the same order with the LHS of rrsq
+	rhsInLoop[rhsItem] = true;
+	list<int>& rhs = RHS[rhsItem];
+	const list<int>& lhs = rrsq.getLHSIndexArray();
+	for(list<int>::iterator it=rhs.begin(); it!=rhs.end(); ++it) {
+		if (*it == NULL_POS) continue;
+		list<int>::const_iterator it2 = find(lhs.begin(),lhs.end(),*it);
+		if (it2 == lhs.end()) {
+			crash(true,"in rhsLoopIndexTransform the RHS integral is not found in the loop form rrsq");
+		}
+		*it = distance(lhs.begin(),it2);
+	}
+}
+
 void RRSQ::print(const int& nSpace, const SQIntsInfor& infor, ofstream& file) const 
 {
 	// obtain the information for this rrsq
@@ -616,6 +699,16 @@ void RRSQ::print(const int& nSpace, const SQIntsInfor& infor, ofstream& file) co
 		additionalOffset = determineAdditionalOffset(oper,nTolInts);
 	}
 
+	// for the high L shell quartets in VRR, the expression is 
+	// printed in compact loop form
+	if (loopForm) {
+		printLoopForm(nSpace,file);
+		return;
+	}
+
+	// whether the final result is written through the caller's layout?
+	bool withStridedResult = infor.withStridedResult();
+
 	// we may need the += rather than = for the LHS
 	bool usePlus =false;
 	if (isNonRRNonDerivWork() && oper == THREEBODYKI) {
@@ -676,12 +769,12 @@ void RRSQ::print(const int& nSpace, const SQIntsInfor& infor, ofstream& file) co
 			// compute the offset(array index) for the given integral
 			//
 			// we note, that if the shell quartet is the final result;
-			// then it must contains all of integrals; therefore there's 
-			// no neglecting integrals for this shell quartet
+			// it's never in array status so the LHS index is not 
+			// transformed into array index (the result may not contain
+			// all of integrals, see the symmetry reduced variant)
 			//
 			// because of this, we can use the index to re-create the 
-			// integral (as you can see in the getOffset), even though
-			// that this rrsq has been transformed into array index
+			// integral (as you can see in the getOffset)
 			//
 			// this explains why it's valid to pass index into 
 			// the getOffset function
@@ -697,14 +790,19 @@ void RRSQ::print(const int& nSpace, const SQIntsInfor& infor, ofstream& file) co
 			}
 
 			// now form the LHS
-			if (withAdditionalOffset && lhsSQStatus == GLOBAL_RESULT_SQ) {
+			if (withStridedResult && lhsSQStatus == GLOBAL_RESULT_SQ) {
+				arrayName = arrayName + "[" + infor.getStridedOffset(oriSQ,index) + "]";
+			}else if (withAdditionalOffset && lhsSQStatus == GLOBAL_RESULT_SQ) {
 				arrayName = arrayName + "[" + additionalOffset + "+" + lexical_cast<string>(offset) + "]";
 			}else{
 				arrayName = arrayName + "[" + lexical_cast<string>(offset) + "]";
 			}
 
 			// consider the cases that we may need to use "+="
-			if (usePlus) {
+			// for the strided result, we always accumulate with the scale factor
+			if (withStridedResult && lhsSQStatus == GLOBAL_RESULT_SQ) {
+				expression = arrayName + " += abcdScale*(";
+			}else if (usePlus) {
 				expression = arrayName + " += ";
 			}else{
 				expression = arrayName + " = ";
@@ -733,6 +831,9 @@ void RRSQ::print(const int& nSpace, const SQIntsInfor& infor, ofstream& file) co
 			// whether this is null integral?
 			if (rhsIndex==NULL_POS) continue;
 
+			// the term vanishes in the same center variant
+			if (infor.isZeroCoefficient(coefficients)) continue;
+
 			// considering the coefficients
 			// we drop the multiplier of 1
 			string k;
@@ -782,7 +883,11 @@ void RRSQ::print(const int& nSpace, const SQIntsInfor& infor, ofstream& file) co
 		}
 
 		// finally add simicolon
-		expression += ";";
+		if (withStridedResult && lhsSQStatus == GLOBAL_RESULT_SQ) {
+			expression += ");";
+		}else{
+			expression += ";";
+		}
 		//cout << expression << endl;
 
 		// now print it to file
@@ -790,6 +895,317 @@ void RRSQ::print(const int& nSpace, const SQIntsInfor& infor, ofstream& file) co
 	}
 }
 
+void rrints::splitCoefficient(const string& coefficients, double& multiplier, string& expression)
+{
+	multiplier = 1.0E0;
+	string k = coefficients;
+	if (k.size() > 0 && (k[0] == '+' || k[0] == '-')) {
+		if (k[0] == '-') multiplier = -1.0E0;
+		k = k.substr(1);
+	}
+
+	// the leading numbers
+	while(true) {
+		string::size_type pos = k.find_first_not_of("0123456789.");
+		if (pos == 0) break;
+		if (pos == string::npos) {
+			multiplier *= lexical_cast<double>(k);
+			k = "1";
+			break;
+		}
+		if (k[pos] != '*') break;
+		multiplier *= lexical_cast<double>(k.substr(0,pos));
+		k = k.substr(pos+1);
+	}
+	expression = k;
+}
+
+void RRSQ::printLoopForm(const int& nSpace, ofstream& file) const 
+{
+	//
+	// the LHS integrals are kept in a local array. Since many of the 
+	// terms in the RR expression are zero for a given LHS (the null RHS), 
+	// the LHS integrals are grouped by their non-zero terms: in one group 
+	// all of integrals have the same items with non-null RHS, and the same 
+	// coefficient expression for each of the items (PAX, WPX, oned2z etc.). 
+	// For each group we have a loop like
+	// lhs[o[k]] = PAX*R0[r[k][0]] + WPX*R1[r[k][1]] + m[k][0]*oned2z*R2[r[k][2]];
+	// the table o holds the LHS position, the table r holds the RHS index 
+	// for each non-zero item, and the table m holds the numerical multiplier 
+	// of the coefficient for the items where it changes in the group. So 
+	// only the non-zero terms are computed, and the coefficients are used 
+	// directly in the loop.
+	//
+	// for the RHS:
+	// - if it's the loop form rrsq in the same function, we use its array;
+	// - S type shell quartet is a single variable;
+	// - else the RHS integrals used are gathered into a local array.
+	//
+	// the tables are static, and there's no dependency between the LHS 
+	// integrals in the loop; so the compiler is free to vectorize it
+	//
+	int nInts  = LHS.size();
+	int nItems = getNItems();
+	vector<string> coefList;
+	vector<vector<int> > gatherList(nItems);
+	vector<vector<int> > table(nInts,vector<int>(2*nItems,0));
+	vector<vector<double> > multipliers(nInts,vector<double>(nItems,0.0E0));
+	vector<vector<int> > terms(nInts,vector<int>(nItems,NULL_POS));
+	for(int item=0; item<nItems; item++) {
+		const ShellQuartet& sq = sqlist[item];
+		bool doGather = (! rhsInLoop[item] && ! sq.isSTypeSQ());
+		list<int>::const_iterator itRHS    = RHS[item].begin();
+		list<string>::const_iterator itCoe = coe[item].begin();
+		for(int k=0; k<nInts; k++, ++itRHS, ++itCoe) {
+			if (*itRHS == NULL_POS) continue;
+
+			// coefficients
+			double m = 1.0E0;
+			string expression;
+			splitCoefficient(*itCoe,m,expression);
+			vector<string>::const_iterator it = find(coefList.begin(),coefList.end(),expression);
+			int coefIndex = it - coefList.begin();
+			if (it == coefList.end()) coefList.push_back(expression);
+
+			// RHS index
+			int rhsIndex = *itRHS;
+			if (doGather) {
+				vector<int>& g = gatherList[item];
+				vector<int>::const_iterator it2 = find(g.begin(),g.end(),rhsIndex);
+				int gatherIndex = it2 - g.begin();
+				if (it2 == g.end()) g.push_back(rhsIndex);
+				rhsIndex = gatherIndex;
+			}
+			if (sq.isSTypeSQ()) rhsIndex = 0;
+			table[k][2*item]   = coefIndex;
+			table[k][2*item+1] = rhsIndex;
+			multipliers[k][item] = m;
+			terms[k][item] = coefIndex;
+		}
+	}
+
+	// now group the LHS integrals by their terms, in the order of 
+	// the first integral in each group
+	vector<vector<int> > groupTerms;
+	vector<vector<int> > groupInts;
+	for(int k=0; k<nInts; k++) {
+		vector<vector<int> >::const_iterator it = find(groupTerms.begin(),groupTerms.end(),terms[k]);
+		int g = it - groupTerms.begin();
+		if (it == groupTerms.end()) {
+			groupTerms.push_back(terms[k]);
+			groupInts.push_back(vector<int>());
+		}
+		groupInts[g].push_back(k);
+	}
+
+	// the loop array
+	string arrayName = oriSQ.getName() + "_vrr_loop";
+	string n = lexical_cast<string>(nInts);
+	string line = "Double " + arrayName + "[" + n + "];";
+	printLine(nSpace,line,file);
+
+	// begin of the block
+	line = "{";
+	printLine(nSpace,line,file);
+	int nSpace2 = nSpace + 2;
+
+	// the gathered RHS
+	for(int item=0; item<nItems; item++) {
+		if (rhsInLoop[item] || sqlist[item].isSTypeSQ()) continue;
+		const vector<int>& g = gatherList[item];
+		if (g.size() == 0) continue;
+		string len = lexical_cast<string>(g.size());
+		line = "const Double R" + lexical_cast<string>(item) + "[" + len + "] = {";
+		for(int i=0; i<(int)g.size(); i++) {
+			if (i > 0) line += ", ";
+			Integral I(sqlist[item],g[i]);
+			line += I.formVarName(rrType);
+		}
+		line += "};";
+		printLine(nSpace2,line,file);
+	}
+
+	// now each group is in its own block
+	for(int g=0; g<(int)groupTerms.size(); g++) {
+		const vector<int>& ints = groupInts[g];
+		int nGroupInts = ints.size();
+		string ng = lexical_cast<string>(nGroupInts);
+
+		// the non-zero items, whether they need the RHS index, and whether
+		// the multiplier changes in the group
+		vector<int> items;
+		vector<int> indexCol;
+		vector<int> multiplierCol;
+		int nIndexCols = 0;
+		int nMultiplierCols = 0;
+		for(int item=0; item<nItems; item++) {
+			if (groupTerms[g][item] == NULL_POS) continue;
+			items.push_back(item);
+			if (sqlist[item].isSTypeSQ()) {
+				indexCol.push_back(-1);
+			}else{
+				indexCol.push_back(nIndexCols);
+				nIndexCols++;
+			}
+			bool sameMultiplier = true;
+			for(int i=1; i<nGroupInts; i++) {
+				if (multipliers[ints[i]][item] != multipliers[ints[0]][item]) {
+					sameMultiplier = false;
+					break;
+				}
+			}
+			if (sameMultiplier) {
+				multiplierCol.push_back(-1);
+			}else{
+				multiplierCol.push_back(nMultiplierCols);
+				nMultiplierCols++;
+			}
+		}
+
+		line = "{";
+		printLine(nSpace2,line,file);
+		int nSpace3 = nSpace2 + 2;
+
+		// the tables, we put a few rows in one line to keep the code compact
+		int nRowsPerLine = 8;
+		line = "static const UInt o[" + ng + "] = {";
+		for(int i=0; i<nGroupInts; i++) {
+			if (i > 0) line += ",";
+			line += lexical_cast<string>(ints[i]);
+		}
+		line += "};";
+		printLine(nSpace3,line,file);
+		if (nIndexCols > 0) {
+			line = "static const UInt r[" + ng + "][" + lexical_cast<string>(nIndexCols) + "] = {";
+			printLine(nSpace3,line,file);
+			line.clear();
+			for(int i=0; i<nGroupInts; i++) {
+				line += "{";
+				bool first = true;
+				for(int j=0; j<(int)items.size(); j++) {
+					if (indexCol[j] < 0) continue;
+					if (! first) line += ",";
+					line += lexical_cast<string>(table[ints[i]][2*items[j]+1]);
+					first = false;
+				}
+				line += "}";
+				if (i < nGroupInts-1) line += ",";
+				if ((i+1)%nRowsPerLine == 0 || i == nGroupInts-1) {
+					printLine(nSpace3+2,line,file);
+					line.clear();
+				}
+			}
+			line = "};";
+			printLine(nSpace3,line,file);
+		}
+		if (nMultiplierCols > 0) {
+			line = "static const Double m[" + ng + "][" + lexical_cast<string>(nMultiplierCols) + "] = {";
+			printLine(nSpace3,line,file);
+			line.clear();
+			for(int i=0; i<nGroupInts; i++) {
+				line += "{";
+				bool first = true;
+				for(int j=0; j<(int)items.size(); j++) {
+					if (multiplierCol[j] < 0) continue;
+					if (! first) line += ",";
+					ostringstream s;
+					s.precision(16);
+					s << multipliers[ints[i]][items[j]];
+					line += s.str();
+					first = false;
+				}
+				line += "}";
+				if (i < nGroupInts-1) line += ",";
+				if ((i+1)%nRowsPerLine == 0 || i == nGroupInts-1) {
+					printLine(nSpace3+2,line,file);
+					line.clear();
+				}
+			}
+			line = "};";
+			printLine(nSpace3,line,file);
+		}
+
+		// now the loop
+		line = "for(UInt k=0; k<" + ng + "; k++) {";
+		printLine(nSpace3,line,file);
+		string expression = arrayName + "[o[k]] = ";
+		if (items.size() == 0) expression += "0.0E0";
+		for(int j=0; j<(int)items.size(); j++) {
+			int item = items[j];
+			const ShellQuartet& sq = sqlist[item];
+			string rhs;
+			if (sq.isSTypeSQ()) {
+				Integral I(sq,0);
+				rhs = I.formVarName(rrType);
+			}else{
+				string r = "r[k][" + lexical_cast<string>(indexCol[j]) + "]";
+				if (rhsInLoop[item]) {
+					rhs = sq.getName() + "_vrr_loop[" + r + "]";
+				}else{
+					rhs = "R" + lexical_cast<string>(item) + "[" + r + "]";
+				}
+			}
+
+			// the multiplier, a constant one is printed as the number;
+			// and -1 becomes the sign of the term
+			string term;
+			bool negative = false;
+			if (multiplierCol[j] >= 0) {
+				term = "m[k][" + lexical_cast<string>(multiplierCol[j]) + "]*";
+			}else{
+				double m = multipliers[ints[0]][item];
+				if (m < 0.0E0) {
+					negative = true;
+					m = -m;
+				}
+				if (m != 1.0E0) {
+					ostringstream s;
+					s.precision(16);
+					s << m;
+					term = s.str() + "*";
+				}
+			}
+
+			// the coefficient, brackets are added if it's a sum
+			const string& c = coefList[groupTerms[g][item]];
+			if (c != "1") {
+				if (c.find_first_of("+-",1) != string::npos) {
+					term += "(" + c + ")*";
+				}else{
+					term += c + "*";
+				}
+			}
+			term += rhs;
+			if (negative) {
+				expression += "-";
+			}else if (j > 0) {
+				expression += "+";
+			}
+			expression += term;
+		}
+		expression += ";";
+		printLine(nSpace3+2,expression,file);
+		line = "}";
+		printLine(nSpace3,line,file);
+		line = "}";
+		printLine(nSpace2,line,file);
+	}
+
+	// end of the block
+	line = "}";
+	printLine(nSpace,line,file);
+
+	// the results needed in variable form
+	if (! loopUnpack) return;
+	int offset = 0;
+	for(list<int>::const_iterator it=LHS.begin(); it!=LHS.end(); ++it) {
+		Integral I(oriSQ,*it);
+		line = "Double " + I.formVarName(rrType) + " = " + arrayName + "[" + lexical_cast<string>(offset) + "];";
+		printLine(nSpace,line,file);
+		offset++;
+	}
+}
+
 void RRSQ::printArrayToVar(const int& nSpace, ofstream& file) const 
 {
 	// now print comment section to file
@@ -22,10 +22,12 @@
 //	ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //
 //
+#include <map>
 #include "boost/lexical_cast.hpp"
 #include <boost/algorithm/string.hpp>   // string handling
 #include <boost/filesystem.hpp>
 #include "inttype.h"
+#include "integral.h"
 #include "derivinfor.h"
 #include "rr.h"
 #include "nonrr.h"
@@ -34,18 +36,301 @@
 #include "hrrinfor.h"
 #include "nonrrinfor.h"
 #include "sqints.h"
+#include "stagetimer.h"
+#include "rrbytecode.h"
 using boost::lexical_cast;
 using namespace boost::filesystem;
 using namespace boost;
 using namespace derivinfor;
 using namespace printing;
 using namespace inttype;
+using namespace integral;
 using namespace rr;
 using namespace nonrr;
 using namespace vrrinfor;
 using namespace hrrinfor;
 using namespace nonrrinfor;
 using namespace sqints;
+using namespace stagetimer;
+using namespace rrbytecode;
+
+/**
+ * form the cost of the code section for dry run and manifest. The rr 
+ * is the RR or NONRR object of the section, and the secInfor is the 
+ * corresponding VRRInfor, HRRInfor or NONRRInfor. The LHS shell quartets
+ * in array are decided in the same way as the printing does: for file 
+ * split case they come from the sub file records, else from the module 
+ * output. 
+ *
+ * The bottom integral list is what the section passes to its previous
+ * section. VRR does not have it, its bottom integrals are those RHS 
+ * integrals which are not formed in VRR
+ */
+template<class RRType, class InforType>
+static SectionCost formSectionCost(const int& section, const RRType& rr, const InforType& secInfor,
+		const vector<set<int> >& bottomIntList)
+{
+	SectionCost cost;
+	cost.section   = section;
+	cost.nLHS      = rr.countLHSIntNumbers();
+	cost.nRHS      = rr.countRHSIntNumbers();
+	cost.nSubFiles = secInfor.getNSubFiles();
+
+	// the shell quartets in array
+	vector<ShellQuartet> arraySQList;
+	if (secInfor.fileSplit()) {
+		for(int iSub=0; iSub<secInfor.getNSubFiles(); iSub++) {
+			const SubFileRecord& record = secInfor.getSubFileRecord(iSub);
+			const vector<ShellQuartet>& lhs = record.getLHSSQList();
+			const vector<int>& lhsStatus    = record.getLHSSQStatus();
+			for(int iSQ=0; iSQ<(int)lhs.size(); iSQ++) {
+				if (inArrayStatus(lhsStatus[iSQ])) arraySQList.push_back(lhs[iSQ]);
+			}
+		}
+	}else{
+		const vector<ShellQuartet>& output = secInfor.getOutputSQList();
+		const vector<int>& outputStatus    = secInfor.getOutputSQStatus();
+		for(int iSQ=0; iSQ<(int)output.size(); iSQ++) {
+			if (inArrayStatus(outputStatus[iSQ])) arraySQList.push_back(output[iSQ]);
+		}
+	}
+
+	for(int iSQ=0; iSQ<(int)arraySQList.size(); iSQ++) {
+		cost.arraySQList.push_back(arraySQList[iSQ].getName());
+	}
+
+	// now count the LHS integrals, and get the max M value
+	const list<RRSQ>& rrsqList = rr.getRRSQList();
+	for(list<RRSQ>::const_iterator it=rrsqList.begin(); it!=rrsqList.end(); ++it) {
+		long long n = it->getLHSIndexArray().size();
+		const ShellQuartet& sq = it->getLHSSQ();
+		if (find(arraySQList.begin(),arraySQList.end(),sq) != arraySQList.end()) {
+			cost.nArrayInts += n;
+		}else{
+			cost.nVarInts += n;
+		}
+		if (sq.getM() > cost.maxM) cost.maxM = sq.getM();
+		for(int item=0; item<it->getNItems(); item++) {
+			const ShellQuartet& rhsSQ = it->getRHSSQ(item);
+			if (rhsSQ.getM() > cost.maxM) cost.maxM = rhsSQ.getM();
+		}
+	}
+
+	// the bottom integrals
+	if (section != VRR) {
+		for(int iSQ=0; iSQ<(int)bottomIntList.size(); iSQ++) {
+			cost.nBottomInts += bottomIntList[iSQ].size();
+		}
+		return cost;
+	}
+
+	// for VRR, the operator < of shell quartet does not allow
+	// equal shell quartets, so we use the vector here
+	vector<ShellQuartet> lhsSQList;
+	for(list<RRSQ>::const_iterator it=rrsqList.begin(); it!=rrsqList.end(); ++it) {
+		lhsSQList.push_back(it->getLHSSQ());
+	}
+	vector<ShellQuartet> bottomSQList;
+	vector<set<int> > bottomList;
+	for(list<RRSQ>::const_iterator it=rrsqList.begin(); it!=rrsqList.end(); ++it) {
+		for(int item=0; item<it->getNItems(); item++) {
+			const ShellQuartet& rhsSQ = it->getRHSSQ(item);
+			if (find(lhsSQList.begin(),lhsSQList.end(),rhsSQ) != lhsSQList.end()) continue;
+			set<int> intList;
+			it->getUnsolvedIntList(item,intList);
+			vector<ShellQuartet>::iterator pos = find(bottomSQList.begin(),bottomSQList.end(),rhsSQ);
+			if (pos == bottomSQList.end()) {
+				bottomSQList.push_back(rhsSQ);
+				bottomList.push_back(intList);
+			}else{
+				set<int>& list = bottomList[pos-bottomSQList.begin()];
+				list.insert(intList.begin(),intList.end());
+			}
+		}
+	}
+	for(int iSQ=0; iSQ<(int)bottomList.size(); iSQ++) {
+		cost.nBottomInts += bottomList[iSQ].size();
+	}
+	return cost;
+}
+
+/**
+ * print the HRR part with the template kernels in hrrkernel.h. 
+ *
+ * The contracted VRR results (e,S|f,S) are gathered into one array, with
+ * the bra side integrals as the fastest dimension; the f runs over the 
+ * ket HRR range and the e over the bra HRR range. Then the kernel of 
+ * the first side is called, and its output is directly the input of 
+ * the second side; the final kernel writes into abcd. Both of sides 
+ * are printed into the HRR1 work file, the HRR2 work file only keeps 
+ * a comment line. For the side with L1+L2 from hrr_matrix_min_l the
+ * transfer matrix kernel hrrMatrix is called instead of hrr.
+ *
+ * For the general contraction variant the VRR results are already 
+ * contracted into the blocks of gc_cont (see gcontract.h), the kernels
+ * are called for each block and write into the block of abcd.
+ */
+static void printHRRTemplate(const SQIntsInfor& infor, const RR& vrr, const VRRInfor& vrrInfor,
+		const RR& hrr1, const RR& hrr2)
+{
+	// the L of the result shell quartet
+	const ShellQuartet& result = infor.getInputSQList()[0];
+	int La = result.getShell(BRA1).getL();
+	int Lb = result.getShell(BRA2).getL();
+	int Lc = result.getShell(KET1).getL();
+	int Ld = result.getShell(KET2).getL();
+
+	// the sides of HRR, the range of e and f
+	int firstSide  = hrr1.getSide();
+	int secondSide = NULL_POS;
+	if (infor.hasSection(HRR2)) secondSide = hrr2.getSide();
+	bool braHRR = (firstSide == BRA || secondSide == BRA);
+	bool ketHRR = (firstSide == KET || secondSide == KET);
+	int eMax = braHRR ? La+Lb : La;
+	int fMax = ketHRR ? Lc+Ld : Lc;
+	if ((! braHRR && Lb > 0) || (! ketHRR && Ld > 0)) {
+		crash(true, "printHRRTemplate: the HRR side does not match the result shell quartet");
+	}
+
+	// now gather the names of VRR results
+	const vector<ShellQuartet>& vrrResults = vrr.getRRResultSQList();
+	const vector<set<int> >& vrrIntList    = vrr.getRRUnsolvedIntList();
+	const vector<ShellQuartet>& outputSQ   = vrrInfor.getOutputSQList();
+	const vector<int>& outputStatus        = vrrInfor.getOutputSQStatus();
+	vector<ShellQuartet> sqList;
+	vector<int> indexList;
+	infor.getHRRKernelInput(sqList,indexList);
+	vector<string> names;
+	for(int i=0; i<(int)sqList.size(); i++) {
+		const ShellQuartet& sq = sqList[i];
+		vector<ShellQuartet>::const_iterator it = find(vrrResults.begin(),vrrResults.end(),sq);
+		if (it == vrrResults.end()) {
+			crash(true, "printHRRTemplate: can not find the VRR result " + sq.getName());
+		}
+		const set<int>& ints = vrrIntList[it-vrrResults.begin()];
+		if ((int)ints.size() != sq.getNInts()) {
+			crash(true, "printHRRTemplate: the VRR result is not complete " + sq.getName());
+		}
+		vector<ShellQuartet>::const_iterator it2 = find(outputSQ.begin(),outputSQ.end(),sq);
+		bool inArray = (it2 != outputSQ.end() && inArrayStatus(outputStatus[it2-outputSQ.begin()]));
+		int index = indexList[i];
+		if (inArray) {
+			names.push_back(sq.getName() + "[" + lexical_cast<string>(index) + "]");
+		}else{
+			Integral I(sq,index);
+			names.push_back(I.getName());
+		}
+	}
+
+	// open the file
+	string filename = infor.getWorkFuncName(false,HRR1);
+	ofstream myfile;
+	myfile.open (filename.c_str(),std::ofstream::app);
+	int nSpace = 2;
+	string line;
+	line = "/************************************************************";
+	printLine(nSpace,line,myfile);
+	line = " * HRR is done by the template kernels in hrrkernel.h";
+	printLine(nSpace,line,myfile);
+	if (infor.isGeneralContraction()) {
+		line = " * for each pair of contracted functions, the input is the";
+		printLine(nSpace,line,myfile);
+		line = " * block of contracted VRR results in gc_cont";
+		printLine(nSpace,line,myfile);
+	}else{
+		line = " * gather the contracted VRR results in the kernel order";
+		printLine(nSpace,line,myfile);
+	}
+	line = " ************************************************************/";
+	printLine(nSpace,line,myfile);
+	string nIn = lexical_cast<string>(names.size());
+	string output = "abcd";
+	if (infor.isGeneralContraction()) {
+		line = "for(UInt gc_kl=0; gc_kl<nBraCont*nKetCont; gc_kl++) {";
+		printLine(nSpace,line,myfile);
+		nSpace += 2;
+		line = "const Double* hrr_input = gc_cont+gc_kl*" + nIn + ";";
+		printLine(nSpace,line,myfile);
+		line = "Double* gc_abcd = abcd+gc_kl*" + lexical_cast<string>(infor.nInts()) + ";";
+		printLine(nSpace,line,myfile);
+		output = "gc_abcd";
+	}else{
+		line = "Double hrr_input[" + nIn + "] = {";
+		printLine(nSpace,line,myfile);
+		for(int i=0; i<(int)names.size(); i+=4) {
+			line = "";
+			for(int j=i; j<i+4 && j<(int)names.size(); j++) {
+				line += names[j];
+				if (j < (int)names.size()-1) line += ", ";
+			}
+			printLine(nSpace+2,line,myfile);
+		}
+		line = "};";
+		printLine(nSpace,line,myfile);
+	}
+
+	// the kernel calls
+	Shell a(La), b(Lb), c(Lc), d(Ld);
+	int na = a.getBasisSetNumber();
+	int nb = b.getBasisSetNumber();
+	int nKet = 0;
+	for(int f=Lc; f<=fMax; f++) {
+		Shell fShell(f);
+		nKet += fShell.getBasisSetNumber();
+	}
+	int nBra = 0;
+	for(int e=La; e<=eMax; e++) {
+		Shell eShell(e);
+		nBra += eShell.getBasisSetNumber();
+	}
+	string braKernel = infor.withHRRMatrixForm(La+Lb) ? "hrrMatrix" : "hrr";
+	string ketKernel = infor.withHRRMatrixForm(Lc+Ld) ? "hrrMatrix" : "hrr";
+	string braCall = "hrrkernel::" + braKernel + "<HRR_BRA," + lexical_cast<string>(La) + "," + 
+		lexical_cast<string>(Lb) + ">(A,B,";
+	string ketCall = "hrrkernel::" + ketKernel + "<HRR_KET," + lexical_cast<string>(Lc) + "," + 
+		lexical_cast<string>(Ld) + ">(C,D,";
+	if (braHRR && ketHRR) {
+		if (firstSide == BRA) {
+			line = "Double hrr_bra[" + lexical_cast<string>(na*nb*nKet) + "];";
+			printLine(nSpace,line,myfile);
+			line = braCall + "hrr_input,hrr_bra," + lexical_cast<string>(nKet) + ");";
+			printLine(nSpace,line,myfile);
+			line = ketCall + "hrr_bra," + output + "," + lexical_cast<string>(na*nb) + ");";
+			printLine(nSpace,line,myfile);
+		}else{
+			int nc = c.getBasisSetNumber();
+			int nd = d.getBasisSetNumber();
+			line = "Double hrr_ket[" + lexical_cast<string>(nBra*nc*nd) + "];";
+			printLine(nSpace,line,myfile);
+			line = ketCall + "hrr_input,hrr_ket," + lexical_cast<string>(nBra) + ");";
+			printLine(nSpace,line,myfile);
+			line = braCall + "hrr_ket," + output + "," + lexical_cast<string>(nc*nd) + ");";
+			printLine(nSpace,line,myfile);
+		}
+	}else if (braHRR) {
+		line = braCall + "hrr_input," + output + "," + lexical_cast<string>(nKet) + ");";
+		printLine(nSpace,line,myfile);
+	}else{
+		line = ketCall + "hrr_input," + output + "," + lexical_cast<string>(nBra) + ");";
+		printLine(nSpace,line,myfile);
+	}
+	if (infor.isGeneralContraction()) {
+		nSpace -= 2;
+		line = "}";
+		printLine(nSpace,line,myfile);
+	}
+	myfile.close();
+
+	// the HRR2 file is still required in assembling
+	if (infor.hasSection(HRR2)) {
+		string filename = infor.getWorkFuncName(false,HRR2);
+		ofstream myfile;
+		myfile.open (filename.c_str(),std::ofstream::app);
+		line = "// the second side HRR is done together with the first side above";
+		printLine(nSpace,line,myfile);
+		myfile.close();
+	}
+}
 
 void SQInts::intCodeGeneration()
 {
@@ -68,6 +353,19 @@ void SQInts::intCodeGeneration()
 		unsolvedList.push_back(list);
 	}
 
+	// for the symmetry reduced variant, only the unique integrals
+	// are solved; the others are copied in assembleCPPFiles
+	if (infor.isSymmetryVariant()) {
+		for(int iSQ=0; iSQ<(int)outputSQList.size(); iSQ++) {
+			set<int> list;
+			const set<int>& oriList = unsolvedList[iSQ];
+			for(set<int>::const_iterator it=oriList.begin(); it!=oriList.end(); ++it) {
+				if (infor.getSymmetryUniqueIndex(outputSQList[iSQ],*it) == *it) list.insert(*it);
+			}
+			unsolvedList[iSQ] = list;
+		}
+	}
+
 	///////////////////////////////////////////////////////////////////////
 	// some note before we proceed the real work:                        //
 	// the code generation is in reverse order of the real cpp file.     //
@@ -129,6 +427,18 @@ void SQInts::intCodeGeneration()
 
 		// update nLHS
 		nLHSNonRR  = (size_t)nonRRJob.countLHSIntNumbers();
+	}else if (infor.isSameCenterVariant()) {
+
+		// for the same center variant, the HRR on the same center 
+		// side is replaced by the gather from the VRR results
+		nonRRJob.buildSameCenterRRSQList(infor.isSameCenter(BRA),infor.isSameCenter(KET));
+		outputSQList.clear();
+		unsolvedList.clear();
+		outputSQList = nonRRJob.getBottomSQList();
+		unsolvedList = nonRRJob.getBottomIntList();
+		int moduleName = NON_RR;
+		infor.appendCodeSection(moduleName);
+		nLHSNonRR  = (size_t)nonRRJob.countLHSIntNumbers();
 	}
 	NONRRInfor nonRRJobInfor(infor,nonRRJob);
 	infor.updateWithArray(nonRRJobInfor.fileSplit());
@@ -223,6 +533,13 @@ void SQInts::intCodeGeneration()
 	//      %%%%            FILE SPLIT DETERMINATION STEP                //
 	///////////////////////////////////////////////////////////////////////
 
+	// with the template kernels the HRR code in the main cpp
+	// file is merely the kernel call
+	if (infor.useHRRTemplate()) {
+		nLHSHRR1 = 0;
+		nLHSHRR2 = 0;
+	}
+
 	// do we need to re-evalate the file split status
 	// for all of codes?
 	// we do this when the main driver cpp file becomes too large
@@ -330,6 +647,7 @@ void SQInts::intCodeGeneration()
 			}
 		}
 	}else{
+		StageTimer timer(STAGE_SUB_FILES);
 		vrrInfor.subFilesForming(infor,vrr);
 	}
 
@@ -383,6 +701,7 @@ void SQInts::intCodeGeneration()
 				}
 			}
 		}else{
+			StageTimer timer(STAGE_SUB_FILES);
 			HRR1JobInfor.formSubFiles(infor,hrr1);
 		}
 
@@ -429,6 +748,7 @@ void SQInts::intCodeGeneration()
 				}
 			}
 		}else{
+			StageTimer timer(STAGE_SUB_FILES);
 			HRR2JobInfor.formSubFiles(infor,hrr2);
 		}
 
@@ -468,6 +788,7 @@ void SQInts::intCodeGeneration()
 				nonRRJobInfor.updateOutputSQInArray(output);
 			}
 		}else{
+			StageTimer timer(STAGE_SUB_FILES);
 			nonRRJobInfor.formSubFiles(infor,nonRRJob);
 		}
 
@@ -493,18 +814,60 @@ void SQInts::intCodeGeneration()
 	// all of input shell quartet updating are finished
 	// and output sq must be global results
 	if (infor.hasSection(DERIV) && derivJobInfor.fileSplit()) {
+		StageTimer timer(STAGE_SUB_FILES);
 		derivJobInfor.formSubFiles(infor,derivJob);
 	}
 
+	///////////////////////////////////////////////////////////////////////
+	//   record the planning result of sections, for dry run we stop     //
+	//   here                                                            //
+	///////////////////////////////////////////////////////////////////////
+	if (infor.isDryRun() || infor.withKernelManifest()) {
+		vector<SectionCost>& costs = kernelRecord.sectionCosts;
+		vector<set<int> > vrrBottom;
+		costs.clear();
+		costs.push_back(formSectionCost(VRR,vrr,vrrInfor,vrrBottom));
+		if (infor.hasSection(HRR1)) {
+			costs.push_back(formSectionCost(HRR1,hrr1,HRR1JobInfor,hrr1.getHRRBottomIntList()));
+		}
+		if (infor.hasSection(HRR2)) {
+			costs.push_back(formSectionCost(HRR2,hrr2,HRR2JobInfor,hrr2.getHRRBottomIntList()));
+		}
+		if (infor.hasSection(NON_RR)) {
+			costs.push_back(formSectionCost(NON_RR,nonRRJob,nonRRJobInfor,nonRRJob.getBottomIntList()));
+		}
+		if (infor.hasSection(DERIV)) {
+			costs.push_back(formSectionCost(DERIV,derivJob,derivJobInfor,derivJob.getBottomIntList()));
+		}
+	}
+	if (infor.isDryRun()) return;
+
+	///////////////////////////////////////////////////////////////////////
+	//   serialize the RR program into bytecode, it must be done before  //
+	//   printing since the HRR indices are transformed there            //
+	///////////////////////////////////////////////////////////////////////
+	if (infor.withRRByteCode()) {
+		RRByteCode code(infor,vrr,hrr1,hrr2);
+		if (code.isValid()) {
+			string cppFile = infor.getWorkFuncName(false,NULL_POS,-1,true);
+			code.print(path(cppFile.c_str()).replace_extension(".rrb").string());
+		}
+	}
+
 	///////////////////////////////////////////////////////////////////////
 	//               %%%%     PRINT OUT THE CODES                        //
 	///////////////////////////////////////////////////////////////////////
+	StageTimer timer(STAGE_PRINTING);
 	vrr.vrrPrint(infor,vrrInfor);
-	if (infor.hasSection(HRR1)) {
-		hrr1.hrrPrint(infor,HRR1JobInfor);
-	}
-	if (infor.hasSection(HRR2)) {
-		hrr2.hrrPrint(infor,HRR2JobInfor);
+	if (infor.useHRRTemplate() && infor.hasSection(HRR1)) {
+		printHRRTemplate(infor,vrr,vrrInfor,hrr1,hrr2);
+	}else{
+		if (infor.hasSection(HRR1)) {
+			hrr1.hrrPrint(infor,HRR1JobInfor);
+		}
+		if (infor.hasSection(HRR2)) {
+			hrr2.hrrPrint(infor,HRR2JobInfor);
+		}
 	}
 	if (infor.hasSection(NON_RR)) {
 		nonRRJob.print(infor,nonRRJobInfor);
@@ -584,9 +947,24 @@ void SQInts::assembleCPPFiles() const
 	if (resultIntegralHasAdditionalOffset(oper)) nSpaceStop += 2;
 
 	// finally, we need to add braket closure to the vrr body
-	line = "}";
+	// for the general contraction variant, the bra side contraction
+	// is done when the loop of ket primitives is closed; the geminal
+	// variant closes the loop over Gaussian terms first
+	if (infor.isGeminal()) {
+		line = "}";
+		printLine(nSpace,line,CPP);
+	}
 	for(int iSpace= nSpace-2; iSpace>=nSpaceStop; iSpace = iSpace - 2) {
+		line = "}";
 		printLine(iSpace,line,CPP);
+		if (infor.isGeneralContraction() && iSpace == nSpace-2) {
+			vector<ShellQuartet> sqList;
+			vector<int> indexList;
+			infor.getHRRKernelInput(sqList,indexList);
+			line = "gcontract::braContract<" + lexical_cast<string>(indexList.size()) + 
+				">(icoe+ip2,inp2,nBraCont,nKetCont,gc_ket,gc_cont);";
+			printLine(iSpace,line,CPP);
+		}
 	}
 
 	// if we have significance test, then we may
@@ -609,7 +987,7 @@ void SQInts::assembleCPPFiles() const
 		// for the case that VRR/HRR are in a loop 
 		// we can not return, just use continue
 		line = "if (! isSignificant) return;";
-		if (resultIntegralHasAdditionalOffset(oper)) {
+		if (resultIntegralHasAdditionalOffset(oper) || infor.isKetList()) {
 			line = "if (! isSignificant) continue;";
 		}
 		printLine(nSpaceStop,line,CPP);
@@ -638,18 +1016,602 @@ void SQInts::assembleCPPFiles() const
 		}
 	}
 
+	// the symmetry reduced variant, copy the unique integrals
+	// to the redundant positions
+	if (infor.isSymmetryVariant()) {
+		CPP << endl;
+		line = "/************************************************************";
+		printLine(nSpaceStop,line,CPP);
+		line = " * the redundant integrals are copied from the unique ones";
+		printLine(nSpaceStop,line,CPP);
+		line = " ************************************************************/";
+		printLine(nSpaceStop,line,CPP);
+		const ShellQuartet& sq = infor.getInputSQList()[0];
+		for(int index=0; index<sq.getNInts(); index++) {
+			int unique = infor.getSymmetryUniqueIndex(sq,index);
+			if (unique == index) continue;
+			line = "abcd[" + lexical_cast<string>(infor.getOffset(sq,index)) + "] = abcd[" + 
+				lexical_cast<string>(infor.getOffset(sq,unique)) + "];";
+			printLine(nSpaceStop,line,CPP);
+		}
+	}
+
 	// now finalize the cpp file
-	if (oper == ESP) {
+	// the ket list variant closes the loop over kets
+	if (oper == ESP || infor.isKetList()) {
 		CPP << "  }" << endl;
 		CPP << "}" << endl;
 	}else{
 		CPP << "}" << endl;
 	}
 	CPP.close();
+
+	// the body of loop over kets, see VRRInfor::printPairDataHead; 
+	// and the loop over Gaussian terms, see VRRInfor::printEXPR12Head
+	if (infor.isKetList()) {
+		indentLoop("for(UInt iKet=0; iKet<nKets; iKet++) {");
+	}
+	if (infor.isGeminal()) {
+		indentLoop("for(UInt iGem=0; iGem<nGem; iGem++) {");
+	}
+
+	// finally place the arrays into the memory frame
+	if (infor.inArray() && infor.usePlannedArray()) {
+		planArrayMemory();
+	}
+}
+
+void SQInts::indentLoop(const string& loop) const
+{
+	// read in the whole cpp file
+	string cppFile = infor.getWorkFuncName(false,NULL_POS,-1,true);
+	vector<string> lines;
+	lines.reserve(10000);
+	ifstream IN;
+	IN.open(cppFile.c_str(),ios::in);
+	string line;
+	while(getline(IN,line)) {
+		lines.push_back(line);
+	}
+	IN.close();
+
+	// the loop is opened in the VRR head; the braces in the generated 
+	// code are paired in lines, so its closure is where the number of 
+	// braces gets back. The comment lines are not counted
+	int begin = -1;
+	for(int i=0; i<(int)lines.size(); i++) {
+		if (lines[i].find(loop) != string::npos) {
+			begin = i+1;
+			break;
+		}
+	}
+	crash(begin < 0, "the loop is not found in SQInts::indentLoop");
+	int end   = -1;
+	int depth = 1;
+	for(int i=begin; i<(int)lines.size(); i++) {
+		string l = lines[i];
+		trim(l);
+		if (l.compare(0,2,"//") == 0 || l.compare(0,1,"*") == 0 || l.compare(0,2,"/*") == 0) continue;
+		for(int j=0; j<(int)l.size(); j++) {
+			if (l[j] == '{') depth++;
+			if (l[j] == '}') depth--;
+		}
+		if (depth == 0) {
+			end = i;
+			break;
+		}
+	}
+	crash(end < 0, "the closure of loop is not found in SQInts::indentLoop");
+	for(int i=begin; i<end; i++) {
+		if (lines[i].empty() || lines[i][0] == '#') continue;
+		lines[i] = "  " + lines[i];
+	}
+
+	// now write it back
+	ofstream OUT;
+	OUT.open(cppFile.c_str(),std::ofstream::out);
+	for(int i=0; i<(int)lines.size(); i++) {
+		OUT << lines[i] << endl;
+	}
+	OUT.close();
+}
+
+void SQInts::planArrayMemory() const
+{
+	// read in the whole cpp file
+	string cppFile = infor.getWorkFuncName(false,NULL_POS,-1,true);
+	vector<string> lines;
+	lines.reserve(10000);
+	ifstream IN;
+	IN.open(cppFile.c_str(),ios::in);
+	string line;
+	while(getline(IN,line)) {
+		lines.push_back(line);
+	}
+	IN.close();
+
+	//
+	// the life time is measured in the unit of statement on the 
+	// level of frame declaration. Any code inside a deeper block 
+	// (like the loop over primitives) is counted as the statement
+	// which opens the block, so that an array used inside a loop 
+	// is alive for the whole loop
+	//
+	int framePos   = -1;
+	int frameDepth = -1;
+	int depth      = 0;
+	int curUnit    = 0;
+	vector<int> unit(lines.size(),0);
+	for(int i=0; i<(int)lines.size(); i++) {
+		const string& l = lines[i];
+		if (l.find("SCR_PLAN_FRAME") != string::npos) {
+			framePos   = i;
+			frameDepth = depth;
+		}
+		if (frameDepth < 0 || depth <= frameDepth) curUnit = i;
+		unit[i] = curUnit;
+		for(int j=0; j<(int)l.size(); j++) {
+			if (l[j] == '{') depth++;
+			if (l[j] == '}') depth--;
+		}
+	}
+	if (framePos < 0) {
+		crash(true, "the memory frame place holder is missing in SQInts::planArrayMemory");
+	}
+
+	// now collect the array declarations
+	// they are in the form of "Double* name = SCR_PLAN(n);"
+	vector<string> names;
+	vector<int> length;
+	vector<int> declPos;
+	vector<bool> needInit;
+	for(int i=0; i<(int)lines.size(); i++) {
+		const string& l = lines[i];
+		size_t pos = l.find("SCR_PLAN(");
+		bool init  = false;
+		if (pos == string::npos) {
+			pos  = l.find("SCR_PLAN_INIT(");
+			init = true;
+		}
+		if (pos == string::npos) continue;
+		size_t left  = l.find("(",pos);
+		size_t right = l.find(")",left);
+		string len   = l.substr(left+1,right-left-1);
+		LineParse lp(l);
+		string name  = lp.findValue(1);
+		names.push_back(name);
+		length.push_back(lexical_cast<int>(len));
+		declPos.push_back(i);
+		needInit.push_back(init);
+	}
+
+	// the array is alive from the declaration to its last use
+	// the array name may appear in the code, or as argument of the 
+	// sub function calls in the form of &name[0]
+	map<string,int> nameIndex;
+	for(int iArr=0; iArr<(int)names.size(); iArr++) {
+		nameIndex[names[iArr]] = iArr;
+	}
+	vector<int> begin(names.size(),0);
+	vector<int> end(names.size(),0);
+	for(int iArr=0; iArr<(int)names.size(); iArr++) {
+		begin[iArr] = unit[declPos[iArr]];
+		end[iArr]   = unit[declPos[iArr]];
+	}
+	for(int i=0; i<(int)lines.size(); i++) {
+		const string& l = lines[i];
+		int j = 0;
+		int n = l.size();
+		while(j<n) {
+			if (! (isalnum(l[j]) || l[j] == '_')) {
+				j++;
+				continue;
+			}
+			int k = j;
+			while(k<n && (isalnum(l[k]) || l[k] == '_')) k++;
+			map<string,int>::const_iterator it = nameIndex.find(l.substr(j,k-j));
+			if (it != nameIndex.end()) {
+				int iArr = it->second;
+				if (unit[i] > end[iArr]) end[iArr] = unit[i];
+			}
+			j = k;
+		}
+	}
+
+	// now assign the offset, we go with the declaration order and
+	// place the array to the lowest offset which does not overlap
+	// with the arrays alive at the same time
+	// each array is aligned on 64 bytes (8 doubles)
+	int align = 8;
+	vector<int> offset(names.size(),0);
+	vector<int> alloc(names.size(),0);
+	int peak = 0;
+	int total = 0;
+	for(int iArr=0; iArr<(int)names.size(); iArr++) {
+		alloc[iArr] = ((length[iArr]+align-1)/align)*align;
+		total += alloc[iArr];
+		int off = 0;
+		bool moved = true;
+		while(moved) {
+			moved = false;
+			for(int jArr=0; jArr<iArr; jArr++) {
+				if (end[jArr] < begin[iArr] || end[iArr] < begin[jArr]) continue;
+				if (off+alloc[iArr] <= offset[jArr] || offset[jArr]+alloc[jArr] <= off) continue;
+				off   = offset[jArr]+alloc[jArr];
+				moved = true;
+			}
+		}
+		offset[iArr] = off;
+		if (off+alloc[iArr] > peak) peak = off+alloc[iArr];
+	}
+
+	// now replace the place holders
+	for(int iArr=0; iArr<(int)names.size(); iArr++) {
+		string& l   = lines[declPos[iArr]];
+		size_t pos  = l.find("Double*");
+		string nSpace = l.substr(0,pos);
+		string decl = nSpace + "Double* " + names[iArr] + " = scrFrame+" + 
+			lexical_cast<string>(offset[iArr]) + ";";
+		if (needInit[iArr]) {
+			decl = decl + "\n" + nSpace + "for(UInt i=0; i<" + lexical_cast<string>(length[iArr]) + 
+				"; i++) " + names[iArr] + "[i] = 0.0E0;";
+		}
+		l = decl;
+	}
+	string& l = lines[framePos];
+	size_t pos = l.find("SCR_PLAN_FRAME");
+	string nSpace = l.substr(0,pos);
+	string frame;
+	if (names.size() == 0) {
+		frame = nSpace + "// no array is used in this function";
+	}else{
+		frame = nSpace + "// memory frame for all of arrays, " + lexical_cast<string>(names.size()) + 
+			" arrays with " + lexical_cast<string>(total) + " Doubles are planned into " + 
+			lexical_cast<string>(peak) + " Doubles\n";
+		if (infor.useStackArray()) {
+			frame = frame + nSpace + "alignas(64) Double scrFrame[" + lexical_cast<string>(peak) + "];";
+		}else{
+			frame = frame + nSpace + "Double* scrFrame = scr.getRawMemPos(" + lexical_cast<string>(peak) + ");";
+		}
+	}
+	l = frame;
+
+	// write back the file
+	ofstream CPP;
+	CPP.open(cppFile.c_str());
+	for(int i=0; i<(int)lines.size(); i++) {
+		CPP << lines[i] << endl;
+	}
+	CPP.close();
+
+	// report the peak memory
+	cout << "array memory plan for " << infor.getFuncName() << ": " << names.size() 
+		<< " arrays, " << total << " Doubles planned into " << peak << " Doubles" << endl;
+}
+
+void SQInts::recordSCRLength()
+{
+	// read in the whole cpp file
+	string cppFile = infor.getWorkFuncName(false,NULL_POS,-1,true);
+	vector<string> lines;
+	lines.reserve(10000);
+	ifstream IN;
+	IN.open(cppFile.c_str(),ios::in);
+	string line;
+	while(getline(IN,line)) {
+		lines.push_back(line);
+	}
+	IN.close();
+
+	// collect the memory blocks obtained from the scr
+	// each block is aligned in the scr, so we count the blocks
+	// for each length and leave the alignment to the LocalMemScr
+	// all of them are released when the function returns (or at the 
+	// end of each grid point for ESP), so the blocks are simply added
+	map<int,int>& blocks = kernelRecord.scrBlocks;
+	blocks.clear();
+	int nBlocks  = 0;
+	int funcLine = -1;
+	string func  = infor.getFuncName();
+	string head  = "void " + func + "(";
+	for(int i=0; i<(int)lines.size(); i++) {
+		const string& l = lines[i];
+		if (funcLine < 0 && l.compare(0,head.size(),head) == 0) {
+			funcLine = i;
+		}
+		size_t pos = 0;
+		while(true) {
+			size_t p1 = l.find("scr.getNewMemPos(",pos);
+			size_t p2 = l.find("scr.getRawMemPos(",pos);
+			pos = p1 < p2 ? p1 : p2;
+			if (pos == string::npos) break;
+			size_t left  = l.find("(",pos);
+			size_t right = l.find(")",left);
+			string len   = l.substr(left+1,right-left-1);
+			blocks[lexical_cast<int>(len)] += 1;
+			nBlocks++;
+			pos = right;
+		}
+	}
+	if (funcLine < 0) {
+		crash(true, "failed to find the integral function in SQInts::recordSCRLength");
+	}
+
+	// form the scr length function
+	string expr   = kernelRecord.getSCRLengthExpr();
+	string scrLen = "//\n// the scr length (in unit of Double) required by " + func + ", " + 
+		lexical_cast<string>(nBlocks) + " memory blocks\n//\n" + 
+		"UInt " + func + "_scr_len()\n{\n  return " + expr + ";\n}\n";
+	lines[funcLine] = scrLen + "\n" + lines[funcLine];
+
+	// write back the file
+	ofstream CPP;
+	CPP.open(cppFile.c_str());
+	for(int i=0; i<(int)lines.size(); i++) {
+		CPP << lines[i] << endl;
+	}
+	CPP.close();
+}
+
+/**
+ * the FLOPs of the HRR kernel in hrrkernel.h for each integral on the
+ * other side, it follows the work done in the kernel. 
+ *
+ * For hrr each level b (1 to L2) forms (a,b| for a = L1 to L1+L2-b, 
+ * and each integral takes one multiplication and one addition. For 
+ * hrrMatrix each result row (a,b| sums the non-zero elements of the
+ * transfer matrix, for b = (bx,by,bz) there are (bx+1)(by+1)(bz+1) 
+ * of them for each a; again one multiplication and one addition each.
+ */
+static long long hrrKernelFlops(bool matrixForm, int L1, int L2)
+{
+	long long n = 0;
+	if (matrixForm) {
+		Shell a(L1);
+		long long nTerms = 0;
+		for(int bx=L2; bx>=0; bx--) {
+			for(int by=L2-bx; by>=0; by--) {
+				int bz = L2-bx-by;
+				nTerms += (bx+1)*(by+1)*(bz+1);
+			}
+		}
+		n = 2*a.getBasisSetNumber()*nTerms;
+	}else{
+		for(int b=1; b<=L2; b++) {
+			Shell bShell(b);
+			for(int a=L1; a<=L1+L2-b; a++) {
+				Shell aShell(a);
+				n += 2*aShell.getBasisSetNumber()*bShell.getBasisSetNumber();
+			}
+		}
+	}
+	return n;
+}
+
+long long SQInts::countLineFlops(const string& line) const
+{
+	// drop the comments
+	string l = line;
+	size_t pos = l.find("//");
+	if (pos != string::npos) l = l.substr(0,pos);
+	trim(l);
+	if (l.size() == 0) return 0;
+	if (l[0] == '*' || l[0] == '#' || l.compare(0,2,"/*") == 0) return 0;
+	if (l.compare(0,3,"for") == 0) return 0;
+
+	// the call of HRR template kernel (see printHRRTemplate), 
+	// "hrrkernel::hrr<SIDE,L1,L2>(X1,X2,in,out,n);"
+	// the work is counted by the kernel for the n integrals
+	string kernel = "hrrkernel::";
+	if (l.compare(0,kernel.size(),kernel) == 0) {
+		size_t lt    = l.find("<");
+		size_t gt    = l.find(">");
+		size_t comma = l.rfind(",");
+		size_t right = l.rfind(")");
+		if (lt == string::npos || gt == string::npos || comma == string::npos || right == string::npos) {
+			crash(true, "failed to parse the HRR kernel call in SQInts::countLineFlops: " + l);
+		}
+		bool matrixForm = (l.substr(kernel.size(),lt-kernel.size()) == "hrrMatrix");
+		vector<string> para;
+		split(para,l.substr(lt+1,gt-lt-1),is_any_of(","));
+		if (para.size() != 3) {
+			crash(true, "failed to parse the HRR kernel call in SQInts::countLineFlops: " + l);
+		}
+		int L1 = lexical_cast<int>(trim_copy(para[1]));
+		int L2 = lexical_cast<int>(trim_copy(para[2]));
+		long long nInts = lexical_cast<long long>(trim_copy(l.substr(comma+1,right-comma-1)));
+		return hrrKernelFlops(matrixForm,L1,L2)*nInts;
+	}
+
+	// only the assignment is counted, we look for the first
+	// "=" which is not part of the comparison
+	size_t eq = string::npos;
+	for(size_t i=0; i<l.size(); i++) {
+		if (l[i] != '=') continue;
+		if (i+1<l.size() && l[i+1] == '=') {
+			i++;
+			continue;
+		}
+		if (i>0 && (l[i-1] == '<' || l[i-1] == '>' || l[i-1] == '!')) continue;
+		eq = i;
+		break;
+	}
+	if (eq == string::npos) return 0;
+
+	// the compound assignment like "+=" counts one operation
+	long long n = 0;
+	if (eq>0 && (l[eq-1] == '+' || l[eq-1] == '-' || l[eq-1] == '*' || l[eq-1] == '/')) n++;
+
+	// now count the operators on the right hand side, the index
+	// arithmetic in [] is omitted as well as the unary minus and 
+	// the sign of exponent in the number like 1.0E-5
+	int bracket = 0;
+	char prev   = '=';
+	for(size_t i=eq+1; i<l.size(); i++) {
+		char c = l[i];
+		if (c == ' ') continue;
+		if (c == '[') bracket++;
+		if (c == ']') bracket--;
+		if (bracket == 0 && (c == '+' || c == '-' || c == '*' || c == '/')) {
+			bool isOper = true;
+			if (prev == '=' || prev == '(' || prev == ',' || prev == '+' || 
+					prev == '-' || prev == '*' || prev == '/') isOper = false;
+			if ((prev == 'E' || prev == 'e') && i>=2 && (isdigit(l[i-2]) || l[i-2] == '.')) isOper = false;
+			if (isOper) n++;
+		}
+		prev = c;
+	}
+	return n;
+}
+
+long long SQInts::loopTripCount(const string& line) const
+{
+	// only the loop like "for(UInt k=0; k<N; k++) {" with the literal
+	// N has the trip count known in the code, e.g. the table driven VRR 
+	// loop (see vrr_loop_min_l); the other loops return 1
+	string l = line;
+	trim(l);
+	if (l.compare(0,4,"for(") != 0) return 1;
+	size_t p0 = l.find(";");
+	if (p0 == string::npos) return 1;
+	size_t p1 = l.find(";",p0+1);
+	if (p1 == string::npos) return 1;
+	string init = l.substr(4,p0-4);
+	trim(init);
+	if (init.size() < 2 || init.compare(init.size()-2,2,"=0") != 0) return 1;
+	string cond = l.substr(p0+1,p1-p0-1);
+	size_t lt = cond.find("<");
+	if (lt == string::npos || lt+1 >= cond.size() || cond[lt+1] == '=') return 1;
+	string n = cond.substr(lt+1);
+	trim(n);
+	if (n.size() == 0) return 1;
+	for(size_t i=0; i<n.size(); i++) {
+		if (! isdigit(n[i])) return 1;
+	}
+	return lexical_cast<long long>(n);
+}
+
+long long SQInts::countFileFlops(const string& file) const
+{
+	ifstream IN;
+	IN.open(file.c_str(),ios::in);
+	crash(! IN, "failed to open the sub file in SQInts::countFileFlops");
+	long long n = 0;
+	vector<long long> scales(1,1);
+	string line;
+	while(getline(IN,line)) {
+		if (scales.size() > 1) n += countLineFlops(line)*scales.back();
+		long long trip = loopTripCount(line);
+		for(int j=0; j<(int)line.size(); j++) {
+			if (line[j] == '{') {
+				scales.push_back(scales.back()*trip);
+				trip = 1;
+			}
+			if (line[j] == '}' && scales.size() > 1) scales.pop_back();
+		}
+	}
+	IN.close();
+	return n;
+}
+
+void SQInts::countFlops()
+{
+	// read in the whole cpp file
+	string cppFile = infor.getWorkFuncName(false,NULL_POS,-1,true);
+	path dir = path(cppFile.c_str()).parent_path();
+	ifstream IN;
+	IN.open(cppFile.c_str(),ios::in);
+
+	// the code deeper than the function body is in the loop over 
+	// primitives, for the case that the result has additional offset
+	// (ESP) the function body is the loop over grid points, and so is
+	// the loop over kets for the ket list variant
+	int oper      = infor.getOper();
+	int baseDepth = 1;
+	if (resultIntegralHasAdditionalOffset(oper) || infor.isKetList()) baseDepth = 2;
+	string func   = infor.getFuncName();
+	string head   = "void " + func + "(";
+	string sub    = func + "_";
+	bool inFunc   = false;
+	int depth     = 0;
+	vector<long long> scales(1,1);
+	long long nPrim = 0;
+	long long nCont = 0;
+	string line;
+	kernelRecord.fileNames.clear();
+	kernelRecord.fileNames.push_back(path(cppFile.c_str()).filename().string());
+	while(getline(IN,line)) {
+		if (! inFunc) {
+			if (line.compare(0,head.size(),head) != 0) continue;
+			inFunc = true;
+		}
+
+		// the function call to the sub file
+		string l = line;
+		trim(l);
+		long long n = 0;
+		if (l.compare(0,sub.size(),sub) == 0 && l.find("(") != string::npos) {
+			string subFile = l.substr(0,l.find("(")) + ".cpp";
+			n = countFileFlops((dir / path(subFile.c_str())).string());
+			vector<string>& files = kernelRecord.fileNames;
+			if (find(files.begin(),files.end(),subFile) == files.end()) {
+				files.push_back(subFile);
+			}
+		}else{
+			n = countLineFlops(line);
+		}
+
+		// the code in the loop with literal trip count is repeated
+		n *= scales.back();
+		if (depth > baseDepth) {
+			nPrim += n;
+		}else{
+			nCont += n;
+		}
+		long long trip = loopTripCount(line);
+		for(int j=0; j<(int)line.size(); j++) {
+			if (line[j] == '{') {
+				depth++;
+				scales.push_back(scales.back()*trip);
+				trip = 1;
+			}
+			if (line[j] == '}') {
+				depth--;
+				if (scales.size() > 1) scales.pop_back();
+			}
+		}
+	}
+	IN.close();
+	kernelRecord.nPrimFlops = nPrim;
+	kernelRecord.nContFlops = nCont;
+}
+
+void SQInts::formKernelRecord()
+{
+	kernelRecord.oper       = infor.getOper();
+	kernelRecord.funcName   = infor.getFuncName();
+	kernelRecord.argList    = infor.getArgList();
+	kernelRecord.shellCodes = infor.getShellCodeArray();
+	kernelRecord.nInts      = infor.nInts();
+	kernelRecord.variant    = infor.getVariant();
+
+	// for dry run there's no code to look at
+	if (infor.isDryRun()) return;
+
+	// record the scr length required by the function
+	if (infor.withSCRVec()) {
+		recordSCRLength();
+	}
+
+	// FLOPs estimation
+	countFlops();
 }
 
 bool SQInts::isFileExist() const 
 {
+	// for dry run the files left there are from an earlier run
+	if (infor.isDryRun()) return false;
+
 	string fileName = infor.getWorkFuncName(false,NULL_POS,-1,true);
 	path cppFile(fileName.c_str());
 	if (exists(cppFile)) {
@@ -799,6 +1761,7 @@ void SQInts::formFunctionCall(int moduleName, ofstream& CPP) const
 			if (val.find("vector")!=std::string::npos) continue;
 			if (val.find("Double")!=std::string::npos) continue;
 			if (val.find("LocalMemScr")!=std::string::npos) continue;
+			if (val.find("UInt")!=std::string::npos) continue;
 			if (val.find("void")!=std::string::npos) continue;
 
 			// if the name is turned out to be a shell quartet name,
@@ -1000,6 +1963,14 @@ void SQInts::codeGeneration()
 	// generate the tmp folder
 	// the work dir name should be same with
 	// the one used in function of getProjectFileDir
+	// for the dry run, we only plan the code and collect 
+	// the cost of each code section
+	if (infor.isDryRun()) {
+		intCodeGeneration();
+		formKernelRecord();
+		return;
+	}
+
 	int intOperator = infor.getOper();
 	int jobOrder    = infor.getJobOrder();
 	string workDir = infor.getProjectTmpFileDir(intOperator,jobOrder);
@@ -1009,8 +1980,20 @@ void SQInts::codeGeneration()
 	// generate the codes
 	intCodeGeneration();
 
-	// now assemble cpp files
-	assembleCPPFiles();
+	// now assemble cpp files, and collect the information 
+	// of the integral function for the registry
+	{
+		StageTimer timer(STAGE_ASSEMBLY);
+		assembleCPPFiles();
+		formKernelRecord();
+	}
+
+	// the manifest goes together with the cpp file
+	if (infor.withKernelManifest()) {
+		string cppFile = infor.getWorkFuncName(false,NULL_POS,-1,true);
+		string manifest = path(cppFile.c_str()).replace_extension(".json").string();
+		kernelRecord.printManifest(manifest);
+	}
 
 	// this is debugging codes
 	//const vector<int> shellCodes = infor.getShellCodeArray();
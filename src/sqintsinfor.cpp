@@ -487,7 +487,9 @@ void SQIntsInfor::formDerivInfor()
 SQIntsInfor::SQIntsInfor(const int& oper0, 
 		const Infor& infor0, const int& codeBra1, const int& codeBra2, 
 		const int& codeKet1,const int& codeKet2):Infor(infor0),withArray(false),
-	doHRRWork(true),sectionInfor(6,NULL_POS),oper(oper0),minDerivInts(0)
+	doHRRWork(true),variant(),
+	erfMode((infor0.withErfKernels() && withErf(oper0)) ? ERF_NONE : ERF_RUNTIME),sectionInfor(6,NULL_POS),
+	oper(oper0),minDerivInts(0)
 {
 	//
 	// firstly, from the input shell code let's form the data
@@ -557,19 +559,20 @@ int SQIntsInfor::nInts() const
 	return nTolInts*num;
 }
 
-int SQIntsInfor::getOffset(const ShellQuartet& sq, const int& index) const
+void SQIntsInfor::formResultPos(const ShellQuartet& sq, const int& index, int& derivPos,
+		vector<int>& pos, vector<int>& dim) const
 {
 	// now let's see the derivatives situation
 	// because the derivSQList is in dimension of:
 	// derivSQList(nSQ,nDeriv)
 	// thus we will need to see where is the deriv section
 	// in the nDeriv
-	int derivOffset = 0;
+	derivPos = 0;
 	if (derivOrder>0) {
 
 		// let's see where is the deriv information related 
 		// to the sq during the whole deriv infor
-		int derivPos = -1;
+		derivPos = -1;
 		if (derivOrder == 1) {
 
 			// fetch the deriv infor
@@ -604,15 +607,6 @@ int SQIntsInfor::getOffset(const ShellQuartet& sq, const int& index) const
 		if (derivPos == -1) {
 			crash(true, "fail to get the deriv position in getOffset function of SQIntsInfor");
 		}
-
-		// now let's count how many integrals for each deriv section
-		int nTolInts = 0;
-		for(int iSQ=0; iSQ<(int)inputSQList.size(); iSQ++) {
-			nTolInts += inputSQList[iSQ].getNInts(); 
-		}
-
-		// now set the derivOffset
-		derivOffset = nTolInts*derivPos;
 	}
 
 	// now to compute the offset within the composite shell quartet
@@ -693,12 +687,77 @@ int SQIntsInfor::getOffset(const ShellQuartet& sq, const int& index) const
 		pos4 = offset + k2.getLocalIndex();
 	}
 
+	// now record the result
+	pos.assign(4,0);
+	pos[0] = pos1;
+	pos[1] = pos2;
+	pos[2] = pos3;
+	pos[3] = pos4;
+	dim.assign(3,0);
+	dim[0] = n1;
+	dim[1] = n2;
+	dim[2] = n3;
+}
+
+int SQIntsInfor::getOffset(const ShellQuartet& sq, const int& index) const
+{
+	// get the positions of the integral
+	int derivPos = 0;
+	vector<int> pos;
+	vector<int> dim;
+	formResultPos(sq,index,derivPos,pos,dim);
+
+	// the derivatives are arranged as (nSQ,nDeriv), so each 
+	// deriv section holds all of integrals in the input sq list
+	int nTolInts = 0;
+	for(int iSQ=0; iSQ<(int)inputSQList.size(); iSQ++) {
+		nTolInts += inputSQList[iSQ].getNInts(); 
+	}
+	int derivOffset = nTolInts*derivPos;
 
 	// now it's the global index
-	int globalIndex = derivOffset + pos1 + pos2*n1 + pos3*n1*n2 + pos4*n1*n2*n3;
+	int n1 = dim[0];
+	int n2 = dim[1];
+	int n3 = dim[2];
+	int globalIndex = derivOffset + pos[0] + pos[1]*n1 + pos[2]*n1*n2 + pos[3]*n1*n2*n3;
 	return globalIndex;
 }
 
+string SQIntsInfor::getStridedOffset(const ShellQuartet& sq, const int& index) const
+{
+	// get the positions of the integral
+	int derivPos = 0;
+	vector<int> pos;
+	vector<int> dim;
+	formResultPos(sq,index,derivPos,pos,dim);
+
+	// now form the index expression with the caller's strides
+	// the zero position is omitted
+	vector<int> p(pos);
+	p.push_back(derivPos);
+	string offset;
+	for(int i=0; i<(int)p.size(); i++) {
+		if (p[i] == 0) continue;
+		string stride = "abcdStride[" + boost::lexical_cast<string>(i) + "]";
+		if (! offset.empty()) offset = offset + "+";
+		if (p[i] == 1) {
+			offset = offset + stride;
+		}else{
+			offset = offset + boost::lexical_cast<string>(p[i]) + "*" + stride;
+		}
+	}
+
+	// for the result with additional offset, it's the grid dimension
+	if (resultIntegralHasAdditionalOffset(oper)) {
+		if (! offset.empty()) offset = offset + "+";
+		offset = offset + "iGrid*abcdStride[5]";
+	}
+
+	// this is the first integral
+	if (offset.empty()) offset = "0";
+	return offset;
+}
+
 void SQIntsInfor::getCoeOffset(const ShellQuartet& sq, 
 		int& ic2Offset, int& jc2Offset) const
 {
@@ -835,9 +894,185 @@ string SQIntsInfor::getFuncName() const
 		string order = "d2";
 		file = file + "_" + order;
 	}
+
+	// the symmetry reduced variant, it may be in the same center 
+	// form too; however the symmetry already tells the centers
+	if (variant.symmetry == SYM_BRA) {
+		file = file + "_sym_aacd";
+	}else if (variant.symmetry == SYM_KET) {
+		file = file + "_sym_abcc";
+	}else if (variant.symmetry == (SYM_BRA|SYM_KET)) {
+		file = file + "_sym_aacc";
+	}else if (variant.symmetry == SYM_BRAKET) {
+		file = file + "_sym_abab";
+	}else if (variant.symmetry > 0) {
+		file = file + "_sym_aaaa";
+	}else if (isSameCenter(BRA) && isSameCenter(KET)) {
+		file = file + "_same_abcd";
+	}else if (isSameCenter(BRA)) {
+		file = file + "_same_ab";
+	}else if (isSameCenter(KET)) {
+		file = file + "_same_cd";
+	}else if (isGeneralContraction()) {
+		file = file + "_gc";
+	}else if (isSigPairList()) {
+		file = file + "_sig";
+	}else if (isPairData()) {
+		file = file + "_pair";
+	}else if (isKetList()) {
+		file = file + "_kets";
+	}else if (erfMode == ERF_ONLY) {
+		file = file + "_erf";
+	}else if (erfMode == ERF_COMBINED) {
+		file = file + "_rs";
+	}else if (isGeminal()) {
+		file = file + "_gem";
+	}
 	return file;
 }
 
+bool SQIntsInfor::canDoSameCenter(const int& side) const
+{
+	if (! withSameCenterKernels()) return false;
+	if (oper != ERI || derivOrder > 0 || isComSQ()) return false;
+	return inputSQList[0].canDoHRR(side);
+}
+
+bool SQIntsInfor::isZeroCoefficient(const string& coe) const
+{
+	if (! isSameCenterVariant()) return false;
+	double m = 1.0E0;
+	string expression;
+	splitCoefficient(coe,m,expression);
+	if (expression.size() != 3) return false;
+	string k = expression.substr(0,2);
+	if (isSameCenter(BRA) && (k == "PA" || k == "PB")) return true;
+	if (isSameCenter(KET) && (k == "QC" || k == "QD")) return true;
+	return false;
+}
+
+bool SQIntsInfor::canDoSymmetry(const int& sym) const
+{
+	if (! withSymmetryKernels()) return false;
+	if (oper != ERI || derivOrder > 0 || isComSQ() || withStridedResult()) return false;
+	int all = SYM_BRA | SYM_KET | SYM_BRAKET;
+	if (sym <= 0 || sym > all) return false;
+	if ((sym & SYM_BRAKET) && sym != SYM_BRAKET && sym != all) return false;
+
+	// the shells must be the same L, and the block must have
+	// some redundant integrals
+	const ShellQuartet& sq = inputSQList[0];
+	int L1 = sq.getShell(BRA1).getL();
+	int L2 = sq.getShell(BRA2).getL();
+	int L3 = sq.getShell(KET1).getL();
+	int L4 = sq.getShell(KET2).getL();
+	if ((sym & SYM_BRA) && (L1 != L2 || L1 == 0)) return false;
+	if ((sym & SYM_KET) && (L3 != L4 || L3 == 0)) return false;
+	if ((sym & SYM_BRAKET) && (L1 != L3 || L2 != L4 || L1+L2 == 0)) return false;
+	return true;
+}
+
+bool SQIntsInfor::canDoVariant(const SQIntsVariant& v) const
+{
+	// the same center and symmetry forms are only for the plain function
+	if (v.kind == VARIANT_PLAIN) {
+		if ((v.sameCenter & SAME_CENTER_BRA) && ! canDoSameCenter(BRA)) return false;
+		if ((v.sameCenter & SAME_CENTER_KET) && ! canDoSameCenter(KET)) return false;
+		if (v.symmetry > 0 && ! canDoSymmetry(v.symmetry)) return false;
+		return true;
+	}
+	if (v.sameCenter > 0 || v.symmetry > 0) return false;
+
+	// now it's the variants in their own registries
+	if (v.kind == VARIANT_GENERAL_CONTRACTION) {
+		if (! withGeneralContractionKernels()) return false;
+		return (oper == ERI && derivOrder == 0 && ! isComSQ() && ! withStridedResult());
+	}else if (v.kind == VARIANT_SIG_PAIR_LIST) {
+		return (withSigPairKernels() && oper == ERI);
+	}else if (v.kind == VARIANT_PAIR_DATA) {
+		return (withPairDataKernels() && oper == ERI);
+	}else if (v.kind == VARIANT_KET_LIST) {
+		return (withKetListKernels() && oper == ERI && ! withStridedResult());
+	}else if (v.kind == VARIANT_ERF_ONLY) {
+		return (withErfKernels() && withErf(oper));
+	}else if (v.kind == VARIANT_RANGE_SEPARATED) {
+		return (withRangeSeparatedKernels() && withErf(oper));
+	}else if (v.kind == VARIANT_GEMINAL) {
+		return (withGeminalKernels() && oper == EXPR12);
+	}
+	return false;
+}
+
+void SQIntsInfor::setVariant(const SQIntsVariant& v)
+{
+	if (! canDoVariant(v)) {
+		crash(true, "the given variant can not be formed in SQIntsInfor::setVariant");
+	}
+	variant = v;
+
+	// the erf and range separated variants carry the erf operator,
+	// the plain function leaves it to them with erf_kernels = true
+	if (v.kind == VARIANT_ERF_ONLY) {
+		erfMode = ERF_ONLY;
+	}else if (v.kind == VARIANT_RANGE_SEPARATED) {
+		erfMode = ERF_COMBINED;
+	}else if (v.kind == VARIANT_PLAIN && withErfKernels() && withErf(oper)) {
+		erfMode = ERF_NONE;
+	}else{
+		erfMode = ERF_RUNTIME;
+	}
+}
+
+void SQIntsInfor::getHRRKernelInput(vector<ShellQuartet>& sqList, vector<int>& indexList) const
+{
+	// the L of the result shell quartet, the HRR is done on the 
+	// side which has L > 0 on the second shell
+	const ShellQuartet& result = inputSQList[0];
+	int La = result.getShell(BRA1).getL();
+	int Lb = result.getShell(BRA2).getL();
+	int Lc = result.getShell(KET1).getL();
+	int Ld = result.getShell(KET2).getL();
+	sqList.clear();
+	indexList.clear();
+	for(int f=Lc; f<=Lc+Ld; f++) {
+		Shell fShell(f);
+		int nf = fShell.getBasisSetNumber();
+		for(int fi=0; fi<nf; fi++) {
+			for(int e=La; e<=La+Lb; e++) {
+				Shell eShell(e);
+				Shell s(0);
+				ShellQuartet sq(eShell,s,fShell,s,oper);
+				int ne = eShell.getBasisSetNumber();
+				for(int ei=0; ei<ne; ei++) {
+					sqList.push_back(sq);
+					indexList.push_back(ei + ne*fi);
+				}
+			}
+		}
+	}
+}
+
+int SQIntsInfor::getSymmetryUniqueIndex(const ShellQuartet& sq, const int& index) const
+{
+	// go over the permutations allowed by the symmetry
+	Integral I(sq,index);
+	int unique = index;
+	for(int k=1; k<=(SYM_BRA|SYM_KET|SYM_BRAKET); k++) {
+		if ((k & variant.symmetry) != k) continue;
+		Basis b[4] = {I.getBasis(BRA1), I.getBasis(BRA2), I.getBasis(KET1), I.getBasis(KET2)};
+		if (k & SYM_BRA) std::swap(b[0],b[1]);
+		if (k & SYM_KET) std::swap(b[2],b[3]);
+		if (k & SYM_BRAKET) {
+			std::swap(b[0],b[2]);
+			std::swap(b[1],b[3]);
+		}
+		Integral J(b[0],b[1],b[2],b[3],oper);
+		int j = J.getIndex();
+		if (j < unique) unique = j;
+	}
+	return unique;
+}
+
 int SQIntsInfor::getCoeArrayLength(const int& side) const
 {
 	//
@@ -1142,6 +1377,22 @@ void SQIntsInfor::headPrinting(ofstream& file) const
 	printLine(0,line,file);
 	line = "#include <math.h>"; 
 	printLine(0,line,file);
+	if (erfMode == ERF_NONE) {
+		line = "#include <cassert>"; 
+		printLine(0,line,file);
+	}
+	if (useHRRTemplate()) {
+		line = "#include \"hrrkernel.h\""; 
+		printLine(0,line,file);
+	}
+	if (isGeneralContraction()) {
+		line = "#include \"gcontract.h\""; 
+		printLine(0,line,file);
+	}
+	if (withPairRecord()) {
+		line = "#include \"shellpair.h\""; 
+		printLine(0,line,file);
+	}
 	if (withBoostGamma) {
 		line = "#include <boost/math/special_functions/gamma.hpp>";
 		printLine(0,line,file);
@@ -1534,8 +1785,60 @@ string SQIntsInfor::getArgList() const
 		}
 	}
 
+	// the general contraction variant takes the number of contracted 
+	// functions on the bra and ket side, they follow the primitives
+	if (isGeneralContraction()) {
+		string np = "const UInt& jnp2, ";
+		size_t pos = arg.find(np);
+		arg.insert(pos+np.size(),"const UInt& nBraCont, const UInt& nKetCont, ");
+	}
+
+	// the significant pair list variant takes the lists of primitive pairs
+	if (isSigPairList()) {
+		string np = "const UInt& jnp2, ";
+		size_t pos = arg.find(np);
+		arg.insert(pos+np.size(),"const UInt& inSig, const UInt* iSig, const UInt& jnSig, const UInt* jSig, ");
+	}
+
+	// the shell pair data variant takes the bra and ket pair records
+	// in place of all of primitive pair arrays and the centers
+	if (isPairData()) {
+		arg = "const shellpair::ShellPair<Double>& bra, const shellpair::ShellPair<Double>& ket, "
+			"const Double& pMax, const Double& omega, Double* abcd";
+	}
+
+	// the ket list variant takes one bra record and the list of ket records,
+	// the results of each ket are written into its own block of abcdKets
+	if (isKetList()) {
+		arg = "const shellpair::ShellPair<Double>& bra, const UInt& nKets, "
+			"const shellpair::ShellPair<Double>* kets, const Double& pMax, const Double& omega, "
+			"Double* abcdKets";
+	}
+
+	// the range separated variant takes the coefficients of the two
+	// operators after the omega
+	if (erfMode == ERF_COMBINED) {
+		string om = "const Double& omega, ";
+		size_t pos = arg.find(om);
+		arg.insert(pos+om.size(),"const Double& coulFac, const Double& erfFac, ");
+	}
+
+	// the geminal variant takes the coefficients and exponents of the 
+	// Gaussian terms in place of the omega
+	if (isGeminal()) {
+		string om = "const Double& omega, ";
+		size_t pos = arg.find(om);
+		arg.replace(pos,om.size(),"const UInt& nGem, const Double* gemCoe, const Double* gemExp, ");
+	}
+
+	// the result array may be written through the layout descriptor
+	if (withStridedResult()) {
+		arg = arg + ", const UInt* abcdStride, const Double& abcdScale";
+	}
+
 	// finally, consider that whether we have the scr class add in?
-	if (withSCRVec()) {
+	// with the thread local pool the function fetches scr by itself
+	if (withSCRVec() && ! useThreadLocalSCR()) {
 		arg = arg + ", LocalMemScr& scr";
 	}
 
@@ -0,0 +1,97 @@
+//
+// CPPINTS: A C++ Program to Generate Analytical Integrals Based on Gaussian
+// Form Primitive Functions
+//
+// Copyright (C) 2015 The State University of New York at Buffalo
+// This softare uses the MIT license as below:
+//
+//	Permission is hereby granted, free of charge, to any person obtaining 
+//	a copy of this software and associated documentation files (the "Software"), 
+//	to deal in the Software without restriction, including without limitation 
+//	the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+//	and/or sell copies of the Software, and to permit persons to whom the Software 
+//	is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all 
+// copies or substantial portions of the Software.
+//						    
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, 
+//	INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR 
+//	PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE 
+//	FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, 
+//	ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+#include <sys/time.h>
+#include <sys/resource.h>
+#include "stagetimer.h"
+using namespace stagetimer;
+
+/**
+ * accumulated time for each stage
+ */
+static double stageTimes[N_STAGES] = {0.0E0, 0.0E0, 0.0E0, 0.0E0, 0.0E0};
+
+/**
+ * name of each stage
+ */
+static const char* stageNames[N_STAGES] = {"rrsq_search", "form_rrsq_list", 
+	"sub_files", "printing", "assembly"};
+
+double stagetimer::wallTime() 
+{
+	struct timeval t;
+	gettimeofday(&t,NULL);
+	return t.tv_sec + t.tv_usec*1.0E-6;
+}
+
+StageTimer::StageTimer(const int& stage0):stage(stage0),start(wallTime())
+{
+	if (stage < 0 || stage >= N_STAGES) {
+		crash(true, "invalid stage given in StageTimer");
+	}
+}
+
+StageTimer::~StageTimer()
+{
+	stageTimes[stage] += wallTime()-start;
+}
+
+double stagetimer::getStageTime(const int& stage)
+{
+	if (stage < 0 || stage >= N_STAGES) {
+		crash(true, "invalid stage given in getStageTime");
+	}
+	return stageTimes[stage];
+}
+
+void stagetimer::printStageTiming(const string& file, const double& total)
+{
+	// the peak RSS, on Linux it's in KB
+	struct rusage usage;
+	getrusage(RUSAGE_SELF,&usage);
+	long peakRSS = usage.ru_maxrss;
+
+	// the rest of time out of the stages
+	double other = total;
+	for(int i=0; i<N_STAGES; i++) other -= stageTimes[i];
+
+	// screen output
+	printf("%s\n", "stage timing for the code generation (in seconds):");
+	for(int i=0; i<N_STAGES; i++) {
+		printf("%-20s %12.3f\n", stageNames[i], stageTimes[i]);
+	}
+	printf("%-20s %12.3f\n", "other", other);
+	printf("%-20s %12.3f\n", "total", total);
+	printf("%-20s %12ld\n", "peak_rss_kb", peakRSS);
+
+	// JSON file
+	ofstream out;
+	out.open(file.c_str(),std::ofstream::out);
+	out << "{";
+	for(int i=0; i<N_STAGES; i++) {
+		out << "\"" << stageNames[i] << "\": " << stageTimes[i] << ", ";
+	}
+	out << "\"other\": " << other << ", \"total\": " << total;
+	out << ", \"peak_rss_kb\": " << peakRSS << "}" << endl;
+	out.close();
+}
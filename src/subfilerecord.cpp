@@ -23,6 +23,7 @@
 //
 //
 #include<algorithm>
+#include<map>
 #include "general.h"
 #include "rrints.h"
 #include "sqintsinfor.h"
@@ -199,3 +200,106 @@ void SubFileRecord::updateInput(const SubFileRecord& record)
 		}
 	}
 }
+
+bool subfilerecord::formSubFilesByMinCut(const int& moduleName, const list<RRSQ>& rrsqList, 
+		const vector<ShellQuartet>& outputSQList, const int& nLHSLimit, 
+		const double& balance, vector<SubFileRecord>& subFilesList)
+{
+	// the rrsq in printing order
+	vector<const RRSQ*> rrsqs;
+	rrsqs.reserve(rrsqList.size());
+	for(list<RRSQ>::const_reverse_iterator it=rrsqList.rbegin(); it!=rrsqList.rend(); ++it) {
+		rrsqs.push_back(&(*it));
+	}
+	int n = rrsqs.size();
+	if (n == 0) return false;
+
+	// the shell quartet is identified by its name, the operator < 
+	// of shell quartet does not allow the equal ones in map
+	// for each LHS shell quartet we record where it's formed first,
+	// where it's used last and its number of integrals
+	map<string,int> sqIndex;
+	vector<int> firstLHS;
+	vector<int> lastRHS;
+	vector<long long> nInts;
+	vector<long long> weight(n+1,0);
+	for(int i=0; i<n; i++) {
+		const ShellQuartet& sq = rrsqs[i]->getLHSSQ();
+		long long nLHS = rrsqs[i]->getLHSIndexArray().size();
+		weight[i+1] = weight[i] + nLHS;
+
+		// module output is in array form, it's free to cut
+		if (find(outputSQList.begin(),outputSQList.end(),sq) != outputSQList.end()) continue;
+		string name = sq.getName();
+		map<string,int>::iterator it = sqIndex.find(name);
+		if (it == sqIndex.end()) {
+			sqIndex[name] = firstLHS.size();
+			firstLHS.push_back(i);
+			lastRHS.push_back(i);
+			nInts.push_back(nLHS);
+		}else{
+			nInts[it->second] += nLHS;
+		}
+	}
+	for(int i=0; i<n; i++) {
+		for(int item=0; item<rrsqs[i]->getNItems(); item++) {
+			const ShellQuartet& rhsSQ = rrsqs[i]->getRHSSQ(item);
+			map<string,int>::iterator it = sqIndex.find(rhsSQ.getName());
+			if (it == sqIndex.end()) continue;
+			if (i > lastRHS[it->second]) lastRHS[it->second] = i;
+		}
+	}
+
+	// the integrals crossing the cut placed before position c
+	vector<long long> cutCost(n+1,0);
+	for(int iSQ=0; iSQ<(int)firstLHS.size(); iSQ++) {
+		if (lastRHS[iSQ] <= firstLHS[iSQ]) continue;
+		cutCost[firstLHS[iSQ]+1] += nInts[iSQ];
+		cutCost[lastRHS[iSQ]+1]  -= nInts[iSQ];
+	}
+	for(int c=1; c<=n; c++) cutCost[c] += cutCost[c-1];
+
+	// dynamic programming, best[c] is the cost for the chunks ending 
+	// at position c. For the same cost we prefer the less chunks.
+	// Same with the LHS count cut, the last rrsq of the chunk is 
+	// allowed to go over the upper limit
+	long long lower = (long long)((1.0E0-balance)*nLHSLimit);
+	long long upper = (long long)((1.0E0+balance)*nLHSLimit);
+	if (lower < 1) lower = 1;
+	vector<long long> best(n+1,-1);
+	vector<int> nChunks(n+1,0);
+	vector<int> prev(n+1,-1);
+	best[0] = 0;
+	for(int c=1; c<=n; c++) {
+		for(int j=c-1; j>=0; j--) {
+			long long w = weight[c]-weight[j];
+			if (weight[c-1]-weight[j] > upper) break;
+			if (best[j] < 0) continue;
+			if (w < lower && c < n) continue;
+			long long cost = best[j];
+			if (c < n) cost += cutCost[c];
+			if (best[c] < 0 || cost < best[c] || (cost == best[c] && nChunks[j]+1 < nChunks[c])) {
+				best[c]    = cost;
+				nChunks[c] = nChunks[j]+1;
+				prev[c]    = j;
+			}
+		}
+	}
+	if (best[n] < 0) return false;
+
+	// now form the records from the cuts
+	vector<int> cuts;
+	for(int c=n; c>0; c=prev[c]) cuts.push_back(c);
+	reverse(cuts.begin(),cuts.end());
+	int start = 0;
+	for(int iCut=0; iCut<(int)cuts.size(); iCut++) {
+		SubFileRecord record(moduleName);
+		record.init();
+		for(int i=start; i<cuts[iCut]; i++) {
+			record.updateFromRRSQ(*rrsqs[i]);
+		}
+		subFilesList.push_back(record);
+		start = cuts[iCut];
+	}
+	return true;
+}
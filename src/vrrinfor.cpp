@@ -614,38 +614,90 @@ void VRRInfor::setupErfPrefactors(const int& maxLSum,
 {
 	// we only perform the pre-factor calculation when
 	// operator is able to be combined with error function
-	if (withErf(oper)) {
+	// for the plain function (ERF_NONE) there's nothing to do,
+	// and the erf variant (ERF_ONLY) does it without the test, so is
+	// the range separated variant (ERF_COMBINED) in its erf block
+	if (withErf(oper) && erfMode != ERF_NONE) {
 		file << endl;
 		string line = "// now scale the bottom integral if oper in erf(r12)/r12 form";
 		printLine(nSpace,line,file);
-		line = "if (withErfR12) {";
-		printLine(nSpace,line,file);
+		int nSpace2 = nSpace;
+		if (erfMode == ERF_RUNTIME) {
+			line = "if (withErfR12) {";
+			printLine(nSpace,line,file);
+			nSpace2 += 2;
+		}
 		line = "Double erfPref0   = 1.0E0+rho/(omega*omega);";
-		printLine(nSpace+2,line,file);
+		printLine(nSpace2,line,file);
 		line = "Double erfPref1   = 1.0E0/erfPref0;";
-		printLine(nSpace+2,line,file);
+		printLine(nSpace2,line,file);
 		line = "Double erfp       = sqrt(erfPref1);";
-		printLine(nSpace+2,line,file);
+		printLine(nSpace2,line,file);
 		line = "Double erfp2      = erfp*erfp;";
-		printLine(nSpace+2,line,file);
+		printLine(nSpace2,line,file);
 		line = "Double erfPref_1  = erfp;";
-		printLine(nSpace+2,line,file);
+		printLine(nSpace2,line,file);
 		string intName = getBottomIntName(0,oper);
 		line = intName + " = " + intName + "*erfPref_1;";
-		printLine(nSpace+2,line,file);
+		printLine(nSpace2,line,file);
 		for(int m=1; m<=maxLSum; m++) {
 			string name  = "erfPref_" + boost::lexical_cast<string>(2*m+1);
 			string name1 = "erfPref_" + boost::lexical_cast<string>(2*(m-1)+1);
 			line = "Double " + name + " = " + name1 + "*erfp2;";
-			printLine(nSpace+2,line,file);
+			printLine(nSpace2,line,file);
 		}
 		for(int m=1; m<=maxLSum; m++) {
 			intName = getBottomIntName(m,oper);
 			string name  = "erfPref_" + boost::lexical_cast<string>(2*m+1);
 			line = intName + " = " + intName + "*" + name + ";";
-			printLine(nSpace+2,line,file);
+			printLine(nSpace2,line,file);
 		}
-		line="}";
+		if (erfMode == ERF_RUNTIME) {
+			line="}";
+			printLine(nSpace,line,file);
+		}
+	}
+}
+
+void VRRInfor::combinedIntegralsGeneration(const int& maxLSum, 
+		const int& oper, const int& nSpace, ofstream& file) const
+{
+	// the bottom integrals of erf(omega*r12)/r12 are formed first in 
+	// their own block, with the attenuated u; the fmt code inside declares
+	// the bottom integrals again so they do not mix with the 1/r12 ones
+	file << endl;
+	string line = "// the bottom integrals for erf(omega*r12)/r12 operator";
+	printLine(nSpace,line,file);
+	for(int m=0; m<=maxLSum; m++) {
+		string name = getBottomIntName(m,oper);
+		line = "Double " + name + "_erf = 0.0E0;";
+		printLine(nSpace,line,file);
+	}
+	line = "{";
+	printLine(nSpace,line,file);
+	line = "Double u     = PQ2/(1.0E0/(omega*omega)+1.0E0/rho);";
+	printLine(nSpace+2,line,file);
+	line = "Double squ   = sqrt(u);";
+	printLine(nSpace+2,line,file);
+	fmtIntegralsGeneration(maxLSum,oper,nSpace+2,file);
+	setupErfPrefactors(maxLSum,oper,nSpace+2,file);
+	file << endl;
+	for(int m=0; m<=maxLSum; m++) {
+		string name = getBottomIntName(m,oper);
+		line = name + "_erf = " + name + ";";
+		printLine(nSpace+2,line,file);
+	}
+	line = "}";
+	printLine(nSpace,line,file);
+
+	// now it's the 1/r12 operator, then combine the two sets
+	fmtIntegralsGeneration(maxLSum,oper,nSpace,file);
+	file << endl;
+	line = "// combine the bottom integrals of the two operators, the VRR is linear on them";
+	printLine(nSpace,line,file);
+	for(int m=0; m<=maxLSum; m++) {
+		string name = getBottomIntName(m,oper);
+		line = name + " = coulFac*" + name + "+erfFac*" + name + "_erf;";
 		printLine(nSpace,line,file);
 	}
 }
@@ -653,6 +705,10 @@ void VRRInfor::setupErfPrefactors(const int& maxLSum,
 void VRRInfor::fmtIntegralsTest(const int& maxLSum, 
 		const int& oper, const int& nSpace, ofstream& file) const
 {
+	// for the significant pair list variant the screening is already
+	// done by the caller in forming the lists
+	if (sigPairVariant) return;
+
 	// for other case
 	file << endl;
 	string line = "// ";
@@ -673,15 +729,20 @@ void VRRInfor::fmtIntegralsTest(const int& maxLSum,
 	name = name + "_IntegralTest";
 	line = "Double " + name + " = pref;"; 
 	printLine(nSpace,line,file);
-	line = "if (fabs(ic2*jc2)>1.0E0) {"; 
-	if (oper == NAI || oper == ESP) {
-		line = "if (fabs(ic2)>1.0E0) {"; 
+
+	// for the general contraction variant there's no single coefficient
+	// for the primitive pair, so the test is on the pref only
+	if (! gcVariant) {
+		line = "if (fabs(ic2*jc2)>1.0E0) {"; 
+		if (oper == NAI || oper == ESP) {
+			line = "if (fabs(ic2)>1.0E0) {"; 
+		}
+		printLine(nSpace,line,file);
+		line = name + " = prefactor;"; 
+		printLine(nSpace+2,line,file);
+		line = "}";
+		printLine(nSpace,line,file);
 	}
-	printLine(nSpace,line,file);
-	line = name + " = prefactor;"; 
-	printLine(nSpace+2,line,file);
-	line = "}";
-	printLine(nSpace,line,file);
 
 	// now do the sig check
 	if (sigCheck(oper)) {
@@ -732,6 +793,14 @@ void VRRInfor::printResultStatement(ofstream& myfile) const
 		return;
 	}
 
+	//
+	// for the general contraction variant, the VRR results are 
+	// contracted into the work space rather than the variables
+	//
+	if (gcVariant) {
+		return;
+	}
+
 	//
 	// this is the variable declare head
 	//
@@ -761,7 +830,8 @@ void VRRInfor::printResultStatement(ofstream& myfile) const
 			string name      = sq.getName();
 			string arrayType = getArrayType();
 			int nInts        = intList.size();
-			string declare   = getArrayDeclare(lexical_cast<string>(nInts));
+			bool needInit    = true;
+			string declare   = getArrayDeclare(lexical_cast<string>(nInts),needInit);
 			string line      = arrayType + name + declare;
 			printLine(nSpace,line,myfile);
 		}else{
@@ -882,7 +952,29 @@ void VRRInfor::printVRRHead(const SQIntsInfor& infor) const
 	ofstream file;
 	file.open(name.c_str(),std::ofstream::out);
 
-	// firstly we need to see that wether we need a loop on the top
+	// for the shell pair data variant, get the arrays out of the 
+	// pair records so that the code below keeps the same names
+	if (pairDataVariant) {
+		printPairDataHead(file,infor,BRA);
+	}
+
+	// the scr is drawn from the thread local pool, it's sized with 
+	// the scr length of this function, see SQInts::recordSCRLength()
+	if (infor.withSCRVec() && infor.useThreadLocalSCR()) {
+		string line = "// get the scr from the memory pool of the calling thread";
+		printLine(2,line,file);
+		line = "LocalMemScr& scr = threadLocalMemScr(" + infor.getFuncName() + "_scr_len());";
+		printLine(2,line,file);
+		file << endl;
+	}
+
+	// the ket side of pair records, for the ket list variant this
+	// is where the loop over kets begins
+	if (pairDataVariant) {
+		printPairDataHead(file,infor,KET);
+	}
+
+	// now we need to see that wether we need a loop on the top
 	if (oper == ESP) {
 		string line = "// loop over grid points ";
 		printLine(2,line,file);
@@ -901,9 +993,37 @@ void VRRInfor::printVRRHead(const SQIntsInfor& infor) const
 		}
 	}
 
+	// all of arrays obtained from scr are released when the function
+	// returns, for ESP it's released for each grid point
+	if (infor.withSCRVec()) {
+		int nSpace = 2;
+		if (oper == ESP) {
+			nSpace += 2;
+		}
+		string line = "// release the scr memory used in this scope when it ends";
+		printLine(nSpace,line,file);
+		line = "LocalMemScope scrScope(scr);";
+		printLine(nSpace,line,file);
+		file << endl;
+	}
+
+	// if the arrays are planned in one memory frame, this is 
+	// the place holder for the frame declaration 
+	// see the SQInts::planArrayMemory
+	if (infor.inArray() && infor.usePlannedArray()) {
+		int nSpace = 2;
+		if (oper == ESP) {
+			nSpace += 2;
+		}
+		string line = "SCR_PLAN_FRAME;";
+		printLine(nSpace,line,file);
+		file << endl;
+	}
+
 	// let's check that whether the operator is with error function
 	// form, which is, operator is erf(r12)/r12
-	if (withErf(oper)) {
+	// it's only tested at run time for ERF_RUNTIME
+	if (withErf(oper) && erfMode == ERF_RUNTIME) {
 
 		// set the space
 		int nSpace = 2;
@@ -923,6 +1043,21 @@ void VRRInfor::printVRRHead(const SQIntsInfor& infor) const
 		file << endl;
 	}
 
+	// the plain function with erf_kernels keeps omega in the argument 
+	// list but computes the Coulomb operator only, so a non-zero omega 
+	// passed in by mistake should fail loudly
+	if (withErf(oper) && erfMode == ERF_NONE) {
+		int nSpace = 2;
+		if (oper == ESP) {
+			nSpace += 2;
+		}
+		string line = "// the erf(r12)/r12 operator is done by the erf variant";
+		printLine(nSpace,line,file);
+		line = "assert(fabs(omega)<THRESHOLD_MATH);";
+		printLine(nSpace,line,file);
+		file << endl;
+	}
+
 	//
 	// we print the vrr declaration variables here
 	//
@@ -934,6 +1069,37 @@ void VRRInfor::printVRRHead(const SQIntsInfor& infor) const
 		nSpace += 2;
 	}
 
+	// for the general contraction variant, set up the work space: 
+	// the contracted VRR results for each pair of contracted functions,
+	// and the ket side contraction for the current bra primitive. 
+	// If VRR is the last section the results go to abcd directly.
+	// Both of them are accumulated so they are cleared here, the work 
+	// space itself is not initialized
+	if (gcVariant) {
+		vector<ShellQuartet> sqList;
+		vector<int> indexList;
+		infor.getHRRKernelInput(sqList,indexList);
+		string nVRR = lexical_cast<string>(indexList.size());
+		string line = "// the work space for the general contraction, see gcontract.h";
+		printLine(nSpace,line,file);
+		if (isLastSection()) {
+			line = "Double* gc_cont = abcd;";
+			printLine(nSpace,line,file);
+			line = "Double* gc_ket  = gcontract::workSpace(nKetCont*" + nVRR + ");";
+			printLine(nSpace,line,file);
+			line = "for(UInt i=0; i<nKetCont*" + nVRR + "; i++) gc_ket[i] = 0.0E0;";
+			printLine(nSpace,line,file);
+		}else{
+			line = "Double* gc_cont = gcontract::workSpace((nBraCont+1)*nKetCont*" + nVRR + ");";
+			printLine(nSpace,line,file);
+			line = "Double* gc_ket  = gc_cont+nBraCont*nKetCont*" + nVRR + ";";
+			printLine(nSpace,line,file);
+			line = "for(UInt i=0; i<(nBraCont+1)*nKetCont*" + nVRR + "; i++) gc_cont[i] = 0.0E0;";
+			printLine(nSpace,line,file);
+		}
+		file << endl;
+	}
+
 	// set up significance test if the file employs fmt function
 	// however, if it's all bottom integrals we do not need to do it
 	// just return true 
@@ -943,6 +1109,9 @@ void VRRInfor::printVRRHead(const SQIntsInfor& infor) const
 		line = "// this will determine that whether we skip the following part ";
 		printLine(nSpace,line,file);
 		line = "bool isSignificant = false;";
+		if (sigPairVariant) {
+			line = "bool isSignificant = (inSig>0 && jnSig>0);";
+		}
 		printLine(nSpace,line,file);
 		file << endl;
 	}
@@ -1769,15 +1938,29 @@ void VRRInfor::printERIHead(ofstream& file, const SQIntsInfor& infor) const
 	///////////////////////////////////////////////////////
 	//                     bra side                      //
 	///////////////////////////////////////////////////////
+	// for the significant pair list variant, we only go over
+	// the listed primitive pairs
 	string line = "for(UInt ip2=0; ip2<inp2; ip2++) {";
+	if (sigPairVariant) line = "for(UInt is2=0; is2<inSig; is2++) {";
 	printLine(2,line,file);
+	if (sigPairVariant) {
+		line = "UInt ip2 = iSig[is2];";
+		printLine(4,line,file);
+	}
 
 	// coefficients and exponents
 	line = "Double onedz = iexp[ip2];";
 	printLine(4,line,file);
 
-	// with exp fac?
-	if (withExpFac) {
+	// with exp fac? the pair data has them already
+	if (withExpFac && pairDataVariant) {
+		line = "Double zeta  = izeta[ip2];";
+		printLine(4,line,file);
+		line = "Double alpha = ialpha[ip2];";
+		printLine(4,line,file);
+		line = "Double beta  = ibeta[ip2];";
+		printLine(4,line,file);
+	}else if (withExpFac) {
 		line = "Double zeta  = 1.0E0/onedz;";
 		printLine(4,line,file);
 		line = "Double zdiff = iexpdiff[ip2];";
@@ -1789,8 +1972,10 @@ void VRRInfor::printERIHead(ofstream& file, const SQIntsInfor& infor) const
 	}
 
 	// bra side coefficients
-	line = "Double ic2   = icoe[ip2];";
-	printLine(4,line,file);
+	if (! gcVariant) {
+		line = "Double ic2   = icoe[ip2];";
+		printLine(4,line,file);
+	}
 	for(int i=1; i<nBraCoeArray; i++) {
 		string array= "icoe";
 		string lhs  = "ic2_" + lexical_cast<string>(i);
@@ -1806,24 +1991,43 @@ void VRRInfor::printERIHead(ofstream& file, const SQIntsInfor& infor) const
 
 	// if we do RR on BRA side, we need 
 	// them
-	if (hasRROnBRA) {
+	if (hasRROnBRA && pairDataVariant) {
+		line = "Double oned2z= ioned2z[ip2];";
+		printLine(4,line,file);
+	}else if (hasRROnBRA) {
 		line = "Double oned2z= 0.5E0*onedz;";
 		printLine(4,line,file);
 	}
 
 	// however, even for S integral calculation, we need
 	// P for calculating |PQ|
-	line = "UInt offsetP = 3*ip2;";
-	printLine(4,line,file);
-	line = "Double PX    = P[offsetP  ];";
-	printLine(4,line,file);
-	line = "Double PY    = P[offsetP+1];";
-	printLine(4,line,file);
-	line = "Double PZ    = P[offsetP+2];";
-	printLine(4,line,file);
+	if (pairDataVariant) {
+		line = "Double PX    = iPX[ip2];";
+		printLine(4,line,file);
+		line = "Double PY    = iPY[ip2];";
+		printLine(4,line,file);
+		line = "Double PZ    = iPZ[ip2];";
+		printLine(4,line,file);
+	}else{
+		line = "UInt offsetP = 3*ip2;";
+		printLine(4,line,file);
+		line = "Double PX    = P[offsetP  ];";
+		printLine(4,line,file);
+		line = "Double PY    = P[offsetP+1];";
+		printLine(4,line,file);
+		line = "Double PZ    = P[offsetP+2];";
+		printLine(4,line,file);
+	}
 
 	// if we do RR on BRA1
-	if (hasRROnBRA1) {
+	if (hasRROnBRA1 && pairDataVariant) {
+		line = "Double PAX   = iPAX[ip2];";
+		printLine(4,line,file);
+		line = "Double PAY   = iPAY[ip2];";
+		printLine(4,line,file);
+		line = "Double PAZ   = iPAZ[ip2];";
+		printLine(4,line,file);
+	}else if (hasRROnBRA1) {
 		line = "Double PAX   = PX - A[0];";
 		printLine(4,line,file);
 		line = "Double PAY   = PY - A[1];";
@@ -1833,7 +2037,14 @@ void VRRInfor::printERIHead(ofstream& file, const SQIntsInfor& infor) const
 	}
 
 	// if we do RR on BRA2
-	if (hasRROnBRA2) {
+	if (hasRROnBRA2 && pairDataVariant) {
+		line = "Double PBX   = iPBX[ip2];";
+		printLine(4,line,file);
+		line = "Double PBY   = iPBY[ip2];";
+		printLine(4,line,file);
+		line = "Double PBZ   = iPBZ[ip2];";
+		printLine(4,line,file);
+	}else if (hasRROnBRA2) {
 		line = "Double PBX   = PX - B[0];";
 		printLine(4,line,file);
 		line = "Double PBY   = PY - B[1];";
@@ -1846,14 +2057,26 @@ void VRRInfor::printERIHead(ofstream& file, const SQIntsInfor& infor) const
 	//                     ket side                      //
 	///////////////////////////////////////////////////////
 	line = "for(UInt jp2=0; jp2<jnp2; jp2++) {";
+	if (sigPairVariant) line = "for(UInt js2=0; js2<jnSig; js2++) {";
 	printLine(4,line,file);
+	if (sigPairVariant) {
+		line = "UInt jp2 = jSig[js2];";
+		printLine(6,line,file);
+	}
 
 	// coefficients and exponents
 	line = "Double onede = jexp[jp2];";
 	printLine(6,line,file);
 
 	// with exp fac?
-	if (withExpFac) {
+	if (withExpFac && pairDataVariant) {
+		line = "Double eta   = jzeta[jp2];";
+		printLine(6,line,file);
+		line = "Double gamma = jalpha[jp2];";
+		printLine(6,line,file);
+		line = "Double delta = jbeta[jp2];";
+		printLine(6,line,file);
+	}else if (withExpFac) {
 		line = "Double eta   = 1.0E0/onede;";
 		printLine(6,line,file);
 		line = "Double ediff = jexpdiff[jp2];";
@@ -1865,8 +2088,10 @@ void VRRInfor::printERIHead(ofstream& file, const SQIntsInfor& infor) const
 	}
 
 	// ket side coefficients
-	line = "Double jc2   = jcoe[jp2];";
-	printLine(6,line,file);
+	if (! gcVariant) {
+		line = "Double jc2   = jcoe[jp2];";
+		printLine(6,line,file);
+	}
 	for(int i=1; i<nKetCoeArray; i++) {
 		string array= "jcoe";
 		string lhs  = "jc2_" + lexical_cast<string>(i);
@@ -1882,8 +2107,9 @@ void VRRInfor::printERIHead(ofstream& file, const SQIntsInfor& infor) const
 
 	// based on bra and ket part, generate the prefactor
 	// as well as other things to form (SS|SS)^{m} 
-	// integrals
-	if (comSQ) {
+	// integrals; for the general contraction variant the coefficients
+	// are applied in the final step too, see gcontract.h
+	if (comSQ || gcVariant) {
 		line = "Double pref      = fbra*fket;";
 		printLine(6,line,file);
 		line = "Double prefactor = pref;";
@@ -1901,14 +2127,23 @@ void VRRInfor::printERIHead(ofstream& file, const SQIntsInfor& infor) const
 	file << endl;
 
 	// continue to generate variables 
-	line = "UInt offsetQ  = 3*jp2;";
-	printLine(6,line,file);
-	line = "Double QX    = Q[offsetQ  ];";
-	printLine(6,line,file);
-	line = "Double QY    = Q[offsetQ+1];";
-	printLine(6,line,file);
-	line = "Double QZ    = Q[offsetQ+2];";
-	printLine(6,line,file);
+	if (pairDataVariant) {
+		line = "Double QX    = jPX[jp2];";
+		printLine(6,line,file);
+		line = "Double QY    = jPY[jp2];";
+		printLine(6,line,file);
+		line = "Double QZ    = jPZ[jp2];";
+		printLine(6,line,file);
+	}else{
+		line = "UInt offsetQ  = 3*jp2;";
+		printLine(6,line,file);
+		line = "Double QX    = Q[offsetQ  ];";
+		printLine(6,line,file);
+		line = "Double QY    = Q[offsetQ+1];";
+		printLine(6,line,file);
+		line = "Double QZ    = Q[offsetQ+2];";
+		printLine(6,line,file);
+	}
 	line = "Double rho   = 1.0E0/(onedz+onede);";
 	printLine(6,line,file);
 	line = "Double sqrho = sqrt(rho);";
@@ -1917,15 +2152,31 @@ void VRRInfor::printERIHead(ofstream& file, const SQIntsInfor& infor) const
 	printLine(6,line,file);
 
 	// here set up the u
-	line = "Double u     = rho*PQ2;";
-	printLine(6,line,file);
-	line = "if (withErfR12) u = PQ2/(1.0E0/(omega*omega)+1.0E0/rho);";
-	printLine(6,line,file);
+	// the erf variant always takes the erf(omega*r12)/r12 form, 
+	// and the plain function has nothing to do with omega
+	if (erfMode == ERF_ONLY) {
+		line = "Double u     = PQ2/(1.0E0/(omega*omega)+1.0E0/rho);";
+		printLine(6,line,file);
+	}else{
+		line = "Double u     = rho*PQ2;";
+		printLine(6,line,file);
+	}
+	if (erfMode == ERF_RUNTIME) {
+		line = "if (withErfR12) u = PQ2/(1.0E0/(omega*omega)+1.0E0/rho);";
+		printLine(6,line,file);
+	}
 	line = "Double squ   = sqrt(u);";
 	printLine(6,line,file);
 
 	// if we do RR on KET1
-	if (hasRROnKET1) {
+	if (hasRROnKET1 && pairDataVariant) {
+		line = "Double QCX   = jPAX[jp2];";
+		printLine(6,line,file);
+		line = "Double QCY   = jPAY[jp2];";
+		printLine(6,line,file);
+		line = "Double QCZ   = jPAZ[jp2];";
+		printLine(6,line,file);
+	}else if (hasRROnKET1) {
 		line = "Double QCX   = QX - C[0];";
 		printLine(6,line,file);
 		line = "Double QCY   = QY - C[1];";
@@ -1935,7 +2186,14 @@ void VRRInfor::printERIHead(ofstream& file, const SQIntsInfor& infor) const
 	}
 
 	// if we do RR on KET2
-	if (hasRROnKET2) {
+	if (hasRROnKET2 && pairDataVariant) {
+		line = "Double QDX   = jPBX[jp2];";
+		printLine(6,line,file);
+		line = "Double QDY   = jPBY[jp2];";
+		printLine(6,line,file);
+		line = "Double QDZ   = jPBZ[jp2];";
+		printLine(6,line,file);
+	}else if (hasRROnKET2) {
 		line = "Double QDX   = QX - D[0];";
 		printLine(6,line,file);
 		line = "Double QDY   = QY - D[1];";
@@ -1981,6 +2239,7 @@ void VRRInfor::printERIHead(ofstream& file, const SQIntsInfor& infor) const
 		line = "Double WQZ   = WZ - QZ;";
 		printLine(6,line,file);
 		line = "Double oned2e= 0.5E0*onede;";
+		if (pairDataVariant) line = "Double oned2e= joned2z[jp2];";
 		printLine(6,line,file);
 		line = "Double rhod2esq= rho*oned2e*onede;";
 		printLine(6,line,file);
@@ -1988,6 +2247,11 @@ void VRRInfor::printERIHead(ofstream& file, const SQIntsInfor& infor) const
 	file << endl;
 
 	// now let's go to generate the S integrals
+	// the range separated variant forms the two operators together
+	if (erfMode == ERF_COMBINED) {
+		combinedIntegralsGeneration(maxLSum,ERI,6,file);
+		return;
+	}
 	fmtIntegralsGeneration(maxLSum,ERI,6,file);
 
 	// we may also need to correct the bottom integral
@@ -1995,6 +2259,107 @@ void VRRInfor::printERIHead(ofstream& file, const SQIntsInfor& infor) const
 	setupErfPrefactors(maxLSum,ERI,6,file);
 }
 
+void VRRInfor::printPairDataHead(ofstream& file, const SQIntsInfor& infor, const int& side) const 
+{
+	// the bra side record gives i* arrays, and the ket side gives j* arrays;
+	// the centers of ket side are C and D
+	string rec = "bra";
+	string x   = "i";
+	string np  = "inp2";
+	string c1  = "A";
+	string c2  = "B";
+	bool RR1   = hasVRROnVar(BRA1);
+	bool RR2   = hasVRROnVar(BRA2);
+	if (side == KET) {
+		rec = "ket";
+		x   = "j";
+		np  = "jnp2";
+		c1  = "C";
+		c2  = "D";
+		RR1 = hasVRROnVar(KET1);
+		RR2 = hasVRROnVar(KET2);
+	}
+
+	// for the ket list variant, the ket record and the result block 
+	// are given by the ket in the list 
+	string line;
+	if (side == KET && ketListVariant) {
+		line = "// loop over the kets, the bra side data above is shared by all of them";
+		printLine(2,line,file);
+		line = "for(UInt iKet=0; iKet<nKets; iKet++) {";
+		printLine(2,line,file);
+		file << endl;
+		line = "const shellpair::ShellPair<Double>& ket = kets[iKet];";
+		printLine(2,line,file);
+		line = "Double* abcd = abcdKets+iKet*" + lexical_cast<string>(infor.nInts()) + ";";
+		printLine(2,line,file);
+		file << endl;
+	}
+
+	// the number of pairs, coefficients and the data always needed
+	line = "// get the primitive pair data out of the " + rec + " record";
+	printLine(2,line,file);
+	line = "const UInt& " + np + " = " + rec + ".n;";
+	printLine(2,line,file);
+	vector<string> names;
+	vector<string> members;
+	names.push_back("coe");
+	members.push_back("coe");
+	names.push_back("exp");
+	members.push_back("oned");
+	names.push_back("fac");
+	members.push_back("fac");
+	names.push_back("PX");
+	members.push_back("PX");
+	names.push_back("PY");
+	members.push_back("PY");
+	names.push_back("PZ");
+	members.push_back("PZ");
+
+	// the ones used in RR
+	if (RR1 || RR2) {
+		names.push_back("oned2z");
+		members.push_back("oned2z");
+	}
+	if (RR1) {
+		names.push_back("PAX");
+		members.push_back("PAX");
+		names.push_back("PAY");
+		members.push_back("PAY");
+		names.push_back("PAZ");
+		members.push_back("PAZ");
+	}
+	if (RR2) {
+		names.push_back("PBX");
+		members.push_back("PBX");
+		names.push_back("PBY");
+		members.push_back("PBY");
+		names.push_back("PBZ");
+		members.push_back("PBZ");
+	}
+
+	// the exponents for derivatives
+	if (infor.withExpFac()) {
+		names.push_back("zeta");
+		members.push_back("zeta");
+		names.push_back("alpha");
+		members.push_back("alpha");
+		names.push_back("beta");
+		members.push_back("beta");
+	}
+	for(int i=0; i<(int)names.size(); i++) {
+		line = "const Double* " + x + names[i] + " = " + rec + "." + members[i] + ".data();";
+		printLine(2,line,file);
+	}
+
+	// the centers are still used in the HRR and derivatives
+	line = "const Double* " + c1 + " = " + rec + ".A;";
+	printLine(2,line,file);
+	line = "const Double* " + c2 + " = " + rec + ".B;";
+	printLine(2,line,file);
+	file << endl;
+}
+
 void VRRInfor::printEXPR12Head(ofstream& file, const SQIntsInfor& infor) const 
 {
 	///////////////////////////////////////////////////////
@@ -2188,10 +2553,7 @@ void VRRInfor::printEXPR12Head(ofstream& file, const SQIntsInfor& infor) const
 		printLine(6,line,file);
 		line = "Double oned2k= 0.5E0*rho*onede*onedz;";
 		printLine(6,line,file);
-		line = "Double odorho= omega/(rho+omega);";
-		printLine(6,line,file);
-		line = "Double od2k  = oned2k*odorho;";
-		printLine(6,line,file);
+		if (! gemVariant) printEXPR12OmegaTerms(true,false,false,file);
 	}
 
 	// if BRA part is both S integral, we do not need it
@@ -2205,8 +2567,7 @@ void VRRInfor::printEXPR12Head(ofstream& file, const SQIntsInfor& infor) const
 		printLine(6,line,file);
 		line = "Double rhod2zsq = rho*oned2z*onedz;";
 		printLine(6,line,file);
-		line = "Double orhod2z2 = rhod2zsq*odorho;";
-		printLine(6,line,file);
+		if (! gemVariant) printEXPR12OmegaTerms(false,hasRROnBRA,false,file);
 	}
 
 	// if KET part is both S integral, we do not need it
@@ -2222,8 +2583,22 @@ void VRRInfor::printEXPR12Head(ofstream& file, const SQIntsInfor& infor) const
 		printLine(6,line,file);
 		line = "Double rhod2esq= rho*oned2e*onede;";
 		printLine(6,line,file);
-		line = "Double orhod2e2= rhod2esq*odorho;";
+		if (! gemVariant) printEXPR12OmegaTerms(false,false,hasRROnKET,file);
+	}
+
+	// the geminal variant loops over the Gaussian terms here, all of 
+	// the above is same for the terms; the loop body is indented later
+	// (see SQInts::indentLoop) and closed with the primitive loops
+	string pref = "prefactor";
+	if (gemVariant) {
+		line = "Double PQ2     = (PX-QX)*(PX-QX)+(PY-QY)*(PY-QY)+(PZ-QZ)*(PZ-QZ);";
+		printLine(6,line,file);
+		line = "for(UInt iGem=0; iGem<nGem; iGem++) {";
 		printLine(6,line,file);
+		line = "Double omega = gemExp[iGem];";
+		printLine(6,line,file);
+		printEXPR12OmegaTerms(hasRR,hasRROnBRA,hasRROnKET,file);
+		pref = "gemPref";
 	}
 
 	// now compute the bottom integral
@@ -2234,6 +2609,8 @@ void VRRInfor::printEXPR12Head(ofstream& file, const SQIntsInfor& infor) const
 	file << endl;
 
 	// here we need to do something for the debugging
+	// for the geminal variant the coefficient of the term is
+	// folded into the bottom integral too
 	line = "// if operator is normalized, the bottom integral will";
 	printLine(6,line,file);
 	line = "// multiply (omega/PI)^{3/2}, this is only used when omega is very large";
@@ -2245,26 +2622,55 @@ void VRRInfor::printEXPR12Head(ofstream& file, const SQIntsInfor& infor) const
 	line = "#ifdef  DEBUG_EXPR12";
 	printLine(0,line,file);
 	line = "prefactor = prefactor*pow(1.0E0/PI,1.5E0)*pow(rho*(omega/(rho+omega)),1.5E0);";
+	if (gemVariant) {
+		line = "Double gemPref = gemCoe[iGem]*prefactor*pow(1.0E0/PI,1.5E0)*pow(rho*(omega/(rho+omega)),1.5E0);";
+	}
 	printLine(6,line,file);
 	line = "#else";
 	printLine(0,line,file);
 	line = "prefactor = prefactor*pow(rhodorho,1.5E0);";
+	if (gemVariant) {
+		line = "Double gemPref = gemCoe[iGem]*prefactor*pow(rhodorho,1.5E0);";
+	}
 	printLine(6,line,file);
 	line = "#endif";
 	printLine(0,line,file);
 
 	// continue the bottom integral calculation
-	line = "Double PQ2     = (PX-QX)*(PX-QX)+(PY-QY)*(PY-QY)+(PZ-QZ)*(PZ-QZ);";
-	printLine(6,line,file);
+	if (! gemVariant) {
+		line = "Double PQ2     = (PX-QX)*(PX-QX)+(PY-QY)*(PY-QY)+(PZ-QZ)*(PZ-QZ);";
+		printLine(6,line,file);
+	}
 	line = "Double expFac  = exp(-omega*rhodorho*PQ2);";
 	printLine(6,line,file);
-	line = "Double I_EXPR12_S_S_S_S_vrr = prefactor*expFac;";
+	line = "Double I_EXPR12_S_S_S_S_vrr = " + pref + "*expFac;";
 	printLine(6,line,file);
 	line = "if(fabs(I_EXPR12_S_S_S_S_vrr)<THRESHOLD_MATH) continue;";
 	printLine(6,line,file);
 	file << endl;
 }
 
+void VRRInfor::printEXPR12OmegaTerms(const bool& hasRR, const bool& hasRROnBRA, 
+		const bool& hasRROnKET, ofstream& file) const
+{
+	// the RR coefficients depend on the omega through odorho
+	string line;
+	if (hasRR) {
+		line = "Double odorho= omega/(rho+omega);";
+		printLine(6,line,file);
+		line = "Double od2k  = oned2k*odorho;";
+		printLine(6,line,file);
+	}
+	if (hasRROnBRA) {
+		line = "Double orhod2z2 = rhod2zsq*odorho;";
+		printLine(6,line,file);
+	}
+	if (hasRROnKET) {
+		line = "Double orhod2e2= rhod2esq*odorho;";
+		printLine(6,line,file);
+	}
+}
+
 //////////////////////////////////////////////////////////////////////////
 //           @@@@ printing VRR contraction part of code                 //
 //////////////////////////////////////////////////////////////////////////
@@ -2305,6 +2711,50 @@ void VRRInfor::contraction(const SQIntsInfor& infor,
 	ofstream myfile;
 	myfile.open(filename.c_str(),std::ofstream::app);
 
+	// for the general contraction variant, the VRR results are gathered
+	// in the kernel order, and contracted on the ket side for all of the
+	// contracted functions; the bra side follows the ket primitive loop
+	// (see SQInts::assembleCPPFiles)
+	if (gcVariant) {
+		vector<ShellQuartet> sqList;
+		vector<int> indexList;
+		infor.getHRRKernelInput(sqList,indexList);
+		myfile << endl;
+		string line = "/************************************************************";
+		printLine(nSpace,line,myfile);
+		line = " * doing contraction work for VRR part on all of the";
+		printLine(nSpace,line,myfile);
+		line = " * contracted functions, see gcontract.h";
+		printLine(nSpace,line,myfile);
+		line = " ************************************************************/";
+		printLine(nSpace,line,myfile);
+		string nVRR = lexical_cast<string>(indexList.size());
+		line = "Double gc_vrr[" + nVRR + "] = {";
+		printLine(nSpace,line,myfile);
+		for(int i=0; i<(int)indexList.size(); i+=4) {
+			line = "";
+			for(int j=i; j<i+4 && j<(int)indexList.size(); j++) {
+
+				// without HRR, the gathered results must be in the 
+				// order of abcd
+				const ShellQuartet& sq = sqList[j];
+				if (isLastSection() && infor.getOffset(sq,indexList[j]) != j) {
+					crash(true, "the VRR results are not in the order of abcd for general contraction");
+				}
+				Integral I(sq,indexList[j]);
+				line += I.formVarName(VRR);
+				if (j < (int)indexList.size()-1) line += ", ";
+			}
+			printLine(nSpace+2,line,myfile);
+		}
+		line = "};";
+		printLine(nSpace,line,myfile);
+		line = "gcontract::ketContract<" + nVRR + ">(jcoe+jp2,jnp2,nKetCont,gc_vrr,gc_ket);";
+		printLine(nSpace,line,myfile);
+		myfile.close();
+		return;
+	}
+
 	// for VRR and contraction split case,
 	// here we will transform the input sq into the variable
 	// form for contraction
@@ -2512,16 +2962,20 @@ void VRRInfor::contraction(const SQIntsInfor& infor,
 			if (isResult || lhsUseArray) {
 
 				// determine the offset
+				// the result may not have all of integrals (see the
+				// symmetry reduced variant), so use the integral index
 				int offset = pos;
 				if (isResult) {
-					offset = infor.getOffset(sq,pos);
+					offset = infor.getOffset(sq,intIndex);
 				}
 
 				// counting the additional offset
 				// if we apply additional offset to the VRR result,
 				// it must be the final results
 				string lhsIndex;
-				if (hasAdditionalOffset && isResult) {
+				if (infor.withStridedResult() && isResult) {
+					lhsIndex  = "[" + infor.getStridedOffset(sq,intIndex) + "]";
+				}else if (hasAdditionalOffset && isResult) {
 					lhsIndex  = "[" + additionalOffset + "+" + lexical_cast<string>(offset) + "]";
 				}else{
 					lhsIndex  = "[" + lexical_cast<string>(offset) + "]";
@@ -2545,6 +2999,7 @@ void VRRInfor::contraction(const SQIntsInfor& infor,
 			I.destroyMultipliers();
 			string rhs = I.formVarName(VRR);
 			if (withModifier) rhs = coefsName + "*" + rhs; 
+			if (infor.withStridedResult() && isResult) rhs = "abcdScale*" + rhs; 
 
 			// form the code
 			string line = lhs + " += " + rhs + ";";
@@ -2636,7 +3091,7 @@ void VRRInfor::contraction(const SQIntsInfor& infor,
 		// if the input shell quartet contains the final result,
 		// we need to include the abcd array
 		if (hasResultSQ) {
-			arg = arg + "Double* abcd";
+			arg = arg + infor.getResultArgList();
 		}
 
 		// finally we have to check the ","
@@ -3359,7 +3814,7 @@ string VRRInfor::getVRRArgList(const int& subFileIndex,
 
 		// now let's see whether we have global result
 		if (hasABCD) {
-			arg = arg + "Double* abcd";
+			arg = arg + infor.getResultArgList();
 		}
 	}
 
@@ -3386,6 +3841,9 @@ string VRRInfor::getVRRArgList(const int& subFileIndex,
 //////////////////////////////////////////////////////////////////////////
 VRRInfor::VRRInfor(const SQIntsInfor& infor, const RR& vrr):Infor(infor),vrrInFileSplit(false),
 	vrrContSplit(false),nextSection(infor.nextSection(VRR)),oper(infor.getOper()),
+	gcVariant(infor.isGeneralContraction()),sigPairVariant(infor.isSigPairList()),
+	pairDataVariant(infor.withPairRecord()),ketListVariant(infor.isKetList()),gemVariant(infor.isGeminal()),
+	erfMode(infor.getErfMode()),
 	vrrSQList(vrr.getRRResultSQList()),solvedIntList(vrr.getRRUnsolvedIntList()),
 	outputSQList(vrr.getRRResultSQList()),outputIntList(vrr.getRRUnsolvedIntList()),
 	outputSQStatus(outputSQList.size(),VARIABLE_SQ)  
@@ -3416,6 +3874,12 @@ VRRInfor::VRRInfor(const SQIntsInfor& infor, const RR& vrr):Infor(infor),vrrInFi
 		vrrInFileSplit = false;
 	}
 
+	// the general contraction variant gathers all of VRR results
+	// in the primitive loop, so the VRR is not split
+	if (gcVariant) {
+		vrrInFileSplit = false;
+	}
+
 	// do we have VRR contraction split?
 	// for integrals with we need to also count int the number 
 	// of bottom integrals
@@ -3466,6 +3930,12 @@ void VRRInfor::updateFileSplit()
 		return;
 	}
 
+	// also for the general contraction variant, see the constructor
+	if (gcVariant) {
+		vrrInFileSplit = false;
+		return;
+	}
+
 	// do we have VRR contraction split?
 	// for integrals with we need to also count int the number 
 	// of bottom integrals
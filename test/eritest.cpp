@@ -6,6 +6,7 @@
 #include "eri.h"
 #include "localmemscr.h"
 #include "eritest.h"
+#include <thread>
 using namespace shellprop;
 using namespace functions;
 using namespace norm;
@@ -13,11 +14,34 @@ using namespace localmemscr;
 using namespace eritest;
 
 // for energy calculation over ERI
+#ifdef WITH_THREAD_LOCAL_SCR
+// the ERI codes are generated with scr_source = thread_local, the
+// function takes the scr of the calling thread by itself; so the 
+// scr passed in is dropped here
 extern void hgp_os_eri(const LInt& LCode, const UInt& inp2, const UInt& jnp2, 
-		const Double& thresh, const Double& pMax, const Double& omega, const Double* icoe, const Double* iexp, 
+		const Double& pMax, const Double& omega, const Double* icoe, const Double* iexp, 
+		const Double* ifac, const Double* P, const Double* A, const Double* B, const Double* jcoe, 
+		const Double* jexp,const Double* jfac, const Double* Q, const Double* C, 
+		const Double* D, Double* abcd);
+inline void hgp_os_eri(const LInt& LCode, const UInt& inp2, const UInt& jnp2, 
+		const Double& pMax, const Double& omega, const Double* icoe, const Double* iexp, 
+		const Double* ifac, const Double* P, const Double* A, const Double* B, const Double* jcoe, 
+		const Double* jexp,const Double* jfac, const Double* Q, const Double* C, 
+		const Double* D, Double* abcd, LocalMemScr& scr)
+{
+	hgp_os_eri(LCode,inp2,jnp2,pMax,omega,icoe,iexp,ifac,P,A,B,
+			jcoe,jexp,jfac,Q,C,D,abcd);
+}
+#else
+extern void hgp_os_eri(const LInt& LCode, const UInt& inp2, const UInt& jnp2, 
+		const Double& pMax, const Double& omega, const Double* icoe, const Double* iexp, 
 		const Double* ifac, const Double* P, const Double* A, const Double* B, const Double* jcoe, 
 		const Double* jexp,const Double* jfac, const Double* Q, const Double* C, 
 		const Double* D, Double* abcd, LocalMemScr& scr);
+#endif
+
+// the scr length required by the ERI function of the given LCode
+extern UInt hgp_os_eri_scr_len(const LInt& LCode);
 
 void eritest::directeri(const Int& Li, const Int& Lj, const Int& Lk, const Int& Ll,
 		const Int& inp, const Double* icoe, const Double* iexp, const Double* A, 
@@ -268,13 +292,13 @@ void eritest::eri_test(const Int& maxL, const Int& auxMaxL, const Int& workType,
 				UInt jnp2_ = static_cast<UInt>(jnp2);
 				Double pmax = 1.0E0;
 				Double omega = 0.0E0;
-				hgp_os_eri(LCode,inp2_,jnp2_,INTEGRAL_THRESH,pmax,omega,
+				hgp_os_eri(LCode,inp2_,jnp2_,pmax,omega,
 						&braCoePair.front(),&iexp2.front(),&fbra.front(),&P.front(),A,B, 
 						&ketCoePair.front(),&jexp2.front(),&fket.front(),&Q.front(),C,D, 
 						&result.front(),scr);
 
-				// clear the scr
-				scr.reset();
+				// the integral function should release all of scr memory it used
+				crash(scr.mark() != 0, "the scr memory is not released by the integral function");
 
 				// now let's directly calculate the eri
 				Int nCarBas1 = getCartBas(iLmin,iLmax);
@@ -407,13 +431,13 @@ void eritest::eri_test(const Int& maxL, const Int& auxMaxL, const Int& workType,
 					vector<Double> result(nBra1Bas*nBra2Bas*nKet1Bas*nKet2Bas);
 					Double pmax = 1.0E0;
 					Double omega = 0.0E0;
-					hgp_os_eri(LCode,inp2,jnp2,INTEGRAL_THRESH,pmax,omega,
+					hgp_os_eri(LCode,inp2,jnp2,pmax,omega,
 							&braCoePair.front(),&iexp2.front(),&fbra.front(),&P.front(),A,B, 
 							&ketCoePair.front(),&jexp2.front(),&fket.front(),&Q.front(),C,D, 
 							&result.front(),scr);
 
-					// clear the scr
-					scr.reset();
+					// the integral function should release all of scr memory it used
+					crash(scr.mark() != 0, "the scr memory is not released by the integral function");
 
 					// now let's directly calculate the eri
 					Int nCarBas1 = getCartBas(iLmin,iLmax);
@@ -556,13 +580,13 @@ void eritest::eri_test(const Int& maxL, const Int& auxMaxL, const Int& workType,
 				// now call hgp here
 				Double pmax = 1.0E0;
 				Double omega = 0.0E0;
-				hgp_os_eri(LCode,inp2,jnp2,INTEGRAL_THRESH,pmax,omega,
+				hgp_os_eri(LCode,inp2,jnp2,pmax,omega,
 						&braCoePair.front(),&iexp2.front(),&fbra.front(),&P.front(),A,B, 
 						&ketCoePair.front(),&jexp2.front(),&fket.front(),&Q.front(),C,D, 
 						&result.front(),scr);
 
-				// clear the scr
-				scr.reset();
+				// the integral function should release all of scr memory it used
+				crash(scr.mark() != 0, "the scr memory is not released by the integral function");
 
 				// now let's directly calculate the eri
 				Int nCarBas1 = getCartBas(iLmin,iLmax);
@@ -644,3 +668,152 @@ void eritest::eri_test(const Int& maxL, const Int& auxMaxL, const Int& workType,
 }
 
 
+
+void eritest::eri_reentrancy_test(const Int& maxL, const Int& nThreads, const Int& nRounds,
+		const Int& inp, const vector<Double>& icoe, const vector<Double>& iexp, const Double* A, 
+		const Int& jnp, const vector<Double>& jcoe, const vector<Double>& jexp, const Double* B, 
+		const Int& knp, const vector<Double>& kcoe, const vector<Double>& kexp, const Double* C, 
+		const Int& lnp, const vector<Double>& lcoe, const vector<Double>& lexp, const Double* D)
+{
+	//
+	// form the shell pair data, this is same with the eri_test
+	//
+	Double AB2 = (A[0]-B[0])*(A[0]-B[0])+(A[1]-B[1])*(A[1]-B[1])+(A[2]-B[2])*(A[2]-B[2]);
+	UInt inp2 = inp*jnp;
+	vector<Double> iexp2(inp2,ZERO);
+	vector<Double> fbra(inp2,ZERO);
+	vector<Double> P(3*inp2,ZERO);
+	Int count = 0;
+	for(Int jp=0; jp<jnp; jp++) {
+		for(Int ip=0; ip<inp; ip++) {
+			Double ia    = iexp[ip];
+			Double ja    = jexp[jp];
+			Double alpla = ia+ja; 
+			Double ab    = -ia*ja/alpla;
+			iexp2[count] = ONE/alpla;
+			fbra[count]  = exp(ab*AB2)*pow(PI/alpla,1.5E0);
+			for(Int i=0; i<3; i++) {
+				P[3*count+i] = (A[i]*ia + B[i]*ja)/alpla;
+			}
+			count++;
+		}
+	}
+	Double CD2 = (C[0]-D[0])*(C[0]-D[0])+(C[1]-D[1])*(C[1]-D[1])+(C[2]-D[2])*(C[2]-D[2]);
+	UInt jnp2 = knp*lnp;
+	vector<Double> jexp2(jnp2,ZERO);
+	vector<Double> fket(jnp2,ZERO);
+	vector<Double> Q(3*jnp2,ZERO);
+	count = 0;
+	for(Int lp=0; lp<lnp; lp++) {
+		for(Int kp=0; kp<knp; kp++) {
+			Double ia    = kexp[kp];
+			Double ja    = lexp[lp];
+			Double alpla = ia+ja; 
+			Double ab    = -ia*ja/alpla;
+			jexp2[count] = ONE/alpla;
+			fket[count]  = exp(ab*CD2)*pow(PI/alpla,1.5E0);
+			for(Int i=0; i<3; i++) {
+				Q[3*count+i] = (C[i]*ia + D[i]*ja)/alpla;
+			}
+			count++;
+		}
+	}
+
+	//
+	// collect all of shell quartets, the coefficients are 
+	// simply set to the input ones since we only compare
+	// the hgp results between threads
+	//
+	vector<LInt> LCodeList;
+	vector<vector<Double> > braCoeList;
+	vector<vector<Double> > ketCoeList;
+	vector<vector<Double> > refList;
+	for(Int n2=0; n2<MAX_SHELL_PAIR_NUMBER; n2++) {
+		for(Int n1=n2; n1<MAX_SHELL_PAIR_NUMBER; n1++) {
+			Int iLmin, iLmax, jLmin, jLmax;
+			Int kLmin, kLmax, lLmin, lLmax;
+			decodeSQ(SHELL_PAIR_ORDER_ARRAY[n1],iLmin,iLmax,jLmin,jLmax);
+			decodeSQ(SHELL_PAIR_ORDER_ARRAY[n2],kLmin,kLmax,lLmin,lLmax);
+			if (iLmax>maxL || jLmax>maxL || kLmax>maxL || lLmax>maxL) continue;
+			Int L1 = codeL(iLmin,iLmax);
+			Int L2 = codeL(jLmin,jLmax);
+			Int L3 = codeL(kLmin,kLmax);
+			Int L4 = codeL(lLmin,lLmax);
+			if (! doTheIntegral(L1,L2,L3,L4)) continue;
+			LCodeList.push_back(codeSQ(L1,L2,L3,L4));
+
+			// coefficients for each sub-shell
+			Int nLBra = (iLmax-iLmin+1)*(jLmax-jLmin+1);
+			Int nLKet = (kLmax-kLmin+1)*(lLmax-lLmin+1);
+			vector<Double> braCoe(nLBra*inp2);
+			for(UInt i=0; i<braCoe.size(); i++) braCoe[i] = icoe[i%inp]*jcoe[(i/inp)%jnp];
+			vector<Double> ketCoe(nLKet*jnp2);
+			for(UInt i=0; i<ketCoe.size(); i++) ketCoe[i] = kcoe[i%knp]*lcoe[(i/knp)%lnp];
+			braCoeList.push_back(braCoe);
+			ketCoeList.push_back(ketCoe);
+			Int nBas = getCartBas(iLmin,iLmax)*getCartBas(jLmin,jLmax)*
+				getCartBas(kLmin,kLmax)*getCartBas(lLmin,lLmax);
+			refList.push_back(vector<Double>(nBas,ZERO));
+		}
+	}
+
+	//
+	// the arena is sized by the largest scr length of the ERI 
+	// functions tested, so it's reserved once for each thread and
+	// never re-created in the real work
+	// the reference result is calculated in this thread
+	//
+	UInt scrLen = 0;
+	for(UInt iSQ=0; iSQ<LCodeList.size(); iSQ++) {
+		UInt len = hgp_os_eri_scr_len(LCodeList[iSQ]);
+		if (len>scrLen) scrLen = len;
+	}
+	Double pmax  = 1.0E0;
+	Double omega = 0.0E0;
+	LocalMemScr& scr = threadLocalMemScr(scrLen);
+	for(UInt iSQ=0; iSQ<LCodeList.size(); iSQ++) {
+		hgp_os_eri(LCodeList[iSQ],inp2,jnp2,pmax,omega,
+				&braCoeList[iSQ].front(),&iexp2.front(),&fbra.front(),&P.front(),A,B, 
+				&ketCoeList[iSQ].front(),&jexp2.front(),&fket.front(),&Q.front(),C,D, 
+				&refList[iSQ].front(),scr);
+	}
+
+	//
+	// now each thread repeats the work with its own arena
+	// the result must be exactly same with the reference one
+	//
+	cout << "**************************************************************" << endl;
+	cout << "ERI reentrancy test with " << nThreads << " threads:" << endl;
+	cout << "**************************************************************" << endl;
+	vector<Int> nFailed(nThreads,0);
+	vector<std::thread> threads;
+	for(Int iThread=0; iThread<nThreads; iThread++) {
+		threads.push_back(std::thread([&,iThread]() {
+			LocalMemScr& threadScr = threadLocalMemScr(scrLen);
+			for(Int iRound=0; iRound<nRounds; iRound++) {
+				for(UInt iSQ=0; iSQ<LCodeList.size(); iSQ++) {
+					vector<Double> result(refList[iSQ].size(),ZERO);
+					hgp_os_eri(LCodeList[iSQ],inp2,jnp2,pmax,omega,
+							&braCoeList[iSQ].front(),&iexp2.front(),&fbra.front(),&P.front(),A,B, 
+							&ketCoeList[iSQ].front(),&jexp2.front(),&fket.front(),&Q.front(),C,D, 
+							&result.front(),threadScr);
+					if (threadScr.mark() != 0 || result != refList[iSQ]) {
+						nFailed[iThread]++;
+					}
+				}
+			}
+		}));
+	}
+	for(Int iThread=0; iThread<nThreads; iThread++) {
+		threads[iThread].join();
+	}
+
+	// now report the result
+	Int nTotalFailed = 0;
+	for(Int iThread=0; iThread<nThreads; iThread++) {
+		nTotalFailed += nFailed[iThread];
+	}
+	cout << "number of shell quartets calculated in each thread: " << nRounds*LCodeList.size() << endl;
+	cout << "number of shell quartets not matching the serial result: " << nTotalFailed << endl;
+	crash(nTotalFailed>0, "the ERI functions are not reentrant");
+}
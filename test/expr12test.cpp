@@ -6,6 +6,9 @@
 #include "localmemscr.h"
 #include "tov.h"
 #include "expr12test.h"
+#ifdef WITH_KERNEL_REGISTRY
+#include "hgp_os_expr12_gem.h"
+#endif
 using namespace shellprop;
 using namespace functions;
 using namespace norm;
@@ -13,10 +16,25 @@ using namespace tov;
 using namespace localmemscr;
 using namespace expr12test;
 
-extern void hgp_os_expr12(const LInt& LCode, const UInt& inp2, const UInt& jnp2, const Double& thresh, 
-		const Double& omega, const Double* icoe, const Double* iexp, const Double* ifac, const Double* P, 
+#ifdef WITH_THREAD_LOCAL_SCR
+// generated with scr_source = thread_local, see the eritest.cpp
+extern void hgp_os_expr12(const LInt& LCode, const UInt& inp2, const UInt& jnp2, const Double& omega, 
+		const Double* icoe, const Double* iexp, const Double* ifac, const Double* P, 
+		const Double* A, const Double* B, const Double* jcoe, const Double* jexp, const Double* jfac, 
+		const Double* Q, const Double* C, const Double* D, Double* abcd);
+inline void hgp_os_expr12(const LInt& LCode, const UInt& inp2, const UInt& jnp2, const Double& omega, 
+		const Double* icoe, const Double* iexp, const Double* ifac, const Double* P, 
+		const Double* A, const Double* B, const Double* jcoe, const Double* jexp, const Double* jfac, 
+		const Double* Q, const Double* C, const Double* D, Double* abcd, LocalMemScr& scr)
+{
+	hgp_os_expr12(LCode,inp2,jnp2,omega,icoe,iexp,ifac,P,A,B,jcoe,jexp,jfac,Q,C,D,abcd);
+}
+#else
+extern void hgp_os_expr12(const LInt& LCode, const UInt& inp2, const UInt& jnp2, const Double& omega, 
+		const Double* icoe, const Double* iexp, const Double* ifac, const Double* P, 
 		const Double* A, const Double* B, const Double* jcoe, const Double* jexp, const Double* jfac, 
 		const Double* Q, const Double* C, const Double* D, Double* abcd, LocalMemScr& scr);
+#endif
 
 void expr12test::expr12_test(const Int& maxL, 
 		const Int& inp, const vector<Double>& icoe, const vector<Double>& iexp, const Double* A, 
@@ -180,7 +198,7 @@ void expr12test::expr12_test(const Int& maxL,
 			Int nKet2Bas = getCartBas(lLmin,lLmax);
 			vector<Double> result(nBra1Bas*nBra2Bas*nKet1Bas*nKet2Bas);
 			Double omega = 1000000.0E0;
-			hgp_os_expr12(LCode,inp2,jnp2,INTEGRAL_THRESH,omega,
+			hgp_os_expr12(LCode,inp2,jnp2,omega,
 					&braCoePair.front(),&iexp2.front(),&fbra.front(),&P.front(),A,B, 
 					&ketCoePair.front(),&jexp2.front(),&fket.front(),&Q.front(),C,D, 
 					&result.front(),scr);
@@ -251,3 +269,147 @@ void expr12test::expr12_test(const Int& maxL,
 }
 
 
+
+#ifdef WITH_KERNEL_REGISTRY
+
+// the scr argument of the geminal functions, see the registrytest.cpp
+#ifdef WITH_THREAD_LOCAL_SCR
+#define KERNEL_SCR
+#else
+#define KERNEL_SCR ,scr
+#endif
+
+/**
+ * form the primitive pair data for the shell pair (i,j)
+ */
+static void formPairData(const Int& inp, const vector<Double>& iexp, const Double* A,
+		const Int& jnp, const vector<Double>& jexp, const Double* B,
+		vector<Double>& iexp2, vector<Double>& fac, vector<Double>& P)
+{
+	Double AB2 = (A[0]-B[0])*(A[0]-B[0])+(A[1]-B[1])*(A[1]-B[1])+(A[2]-B[2])*(A[2]-B[2]);
+	iexp2.assign(inp*jnp,ZERO);
+	fac.assign(inp*jnp,ZERO);
+	P.assign(3*inp*jnp,ZERO);
+	Int count = 0;
+	for(Int jp=0; jp<jnp; jp++) {
+		for(Int ip=0; ip<inp; ip++) {
+			Double ia    = iexp[ip];
+			Double ja    = jexp[jp];
+			Double alpla = ia+ja; 
+			Double ab    = -ia*ja/alpla;
+			iexp2[count] = ONE/alpla;
+			fac[count]   = exp(ab*AB2)*pow(PI/alpla,1.5E0);
+			for(Int i=0; i<3; i++) {
+				P[3*count+i] = (A[i]*ia + B[i]*ja)/alpla;
+			}
+			count++;
+		}
+	}
+}
+
+void expr12test::expr12_geminal_test(const Int& maxL, 
+		const Int& inp, const vector<Double>& icoe, const vector<Double>& iexp, const Double* A, 
+		const Int& jnp, const vector<Double>& jcoe, const vector<Double>& jexp, const Double* B, 
+		const Int& knp, const vector<Double>& kcoe, const vector<Double>& kexp, const Double* C, 
+		const Int& lnp, const vector<Double>& lcoe, const vector<Double>& lexp, const Double* D) 
+{
+	// pair data
+	Int inp2 = inp*jnp;
+	Int jnp2 = knp*lnp;
+	vector<Double> iexp2, fbra, P;
+	vector<Double> jexp2, fket, Q;
+	formPairData(inp,iexp,A,jnp,jexp,B,iexp2,fbra,P);
+	formPairData(knp,kexp,C,lnp,lexp,D,jexp2,fket,Q);
+
+	// the geminal, the exponents are used as omega in the single term calls
+	const UInt nGem = 3;
+	const Double gemCoe[] = {0.3E0, -0.5E0, 1.2E0};
+	const Double gemExp[] = {0.2E0, 1.1E0, 3.5E0};
+
+	// see the expr12_test for the scr length
+	LocalMemScr scr(1944810);
+
+	cout << "**************************************************************" << endl;
+	cout << "* four body geminal sum_k c_k*exp(-omega_k*r12^2) integral test:" << endl;
+	cout << "* compared with the sum of single term calculation " << endl;
+	cout << "**************************************************************" << endl;
+	Int nTested = 0;
+	Int nFailed = 0;
+	for(Int n2=0; n2<MAX_SHELL_PAIR_NUMBER; n2++) {
+		for(Int n1=n2; n1<MAX_SHELL_PAIR_NUMBER; n1++) {
+			Int iLmin, iLmax, jLmin, jLmax;
+			Int kLmin, kLmax, lLmin, lLmax;
+			decodeSQ(SHELL_PAIR_ORDER_ARRAY[n1],iLmin,iLmax,jLmin,jLmax);
+			decodeSQ(SHELL_PAIR_ORDER_ARRAY[n2],kLmin,kLmax,lLmin,lLmax);
+			if (iLmax>maxL || jLmax>maxL || kLmax>maxL || lLmax>maxL) continue;
+			Int L1 = codeL(iLmin,iLmax);
+			Int L2 = codeL(jLmin,jLmax);
+			Int L3 = codeL(kLmin,kLmax);
+			Int L4 = codeL(lLmin,lLmax);
+			if (! doTheIntegral(L1,L2,L3,L4)) continue;
+			LInt LCode = codeSQ(L1,L2,L3,L4);
+
+			// the function may not be generated
+			UInt index = hgp_os_expr12_gem_index(LCode);
+			if (index >= HGP_OS_EXPR12_GEM_REGISTRY_SIZE) continue;
+			const hgp_os_expr12_gem_entry& gem = hgp_os_expr12_gem_registry[index];
+			if (gem.func == NULL) continue;
+
+			// normalize the coefficient array
+			vector<Double> bra1Coe((iLmax-iLmin+1)*inp);
+			vector<Double> bra2Coe((jLmax-jLmin+1)*jnp);
+			vector<Double> ket1Coe((kLmax-kLmin+1)*knp);
+			vector<Double> ket2Coe((lLmax-lLmin+1)*lnp);
+			normCoe(iLmin, iLmax, iexp, icoe, bra1Coe);
+			normCoe(jLmin, jLmax, jexp, jcoe, bra2Coe);
+			normCoe(kLmin, kLmax, kexp, kcoe, ket1Coe);
+			normCoe(lLmin, lLmax, lexp, lcoe, ket2Coe);
+			vector<Double> braCoePair(bra1Coe.size()*bra2Coe.size());
+			makeC2(iLmin,iLmax,jLmin,jLmax,inp,jnp,bra1Coe,bra2Coe,braCoePair);
+			vector<Double> ketCoePair(ket1Coe.size()*ket2Coe.size());
+			makeC2(kLmin,kLmax,lLmin,lLmax,knp,lnp,ket1Coe,ket2Coe,ketCoePair);
+
+			// the geminal function
+			vector<Double> result(gem.nInts,ZERO);
+			gem.func(inp2,jnp2,nGem,gemCoe,gemExp,
+					&braCoePair.front(),&iexp2.front(),&fbra.front(),&P.front(),A,B, 
+					&ketCoePair.front(),&jexp2.front(),&fket.front(),&Q.front(),C,D, 
+					&result.front() KERNEL_SCR);
+			scr.reset();
+
+			// the sum of single term calls
+			vector<Double> ref(gem.nInts,ZERO);
+			for(UInt k=0; k<nGem; k++) {
+				vector<Double> abcd(gem.nInts,ZERO);
+				hgp_os_expr12(LCode,inp2,jnp2,gemExp[k],
+						&braCoePair.front(),&iexp2.front(),&fbra.front(),&P.front(),A,B, 
+						&ketCoePair.front(),&jexp2.front(),&fket.front(),&Q.front(),C,D, 
+						&abcd.front(),scr);
+				scr.reset();
+				for(UInt i=0; i<gem.nInts; i++) ref[i] += gemCoe[k]*abcd[i];
+			}
+
+			// now it's comparison
+			nTested++;
+			for(UInt i=0; i<gem.nInts; i++) {
+				if (fabs(ref[i]-result[i])>THRESH) {
+					cout << "Bra1's L: " << iLmin << " " << iLmax << endl;
+					cout << "Bra2's L: " << jLmin << " " << jLmax << endl;
+					cout << "Ket1's L: " << kLmin << " " << kLmax << endl;
+					cout << "Ket2's L: " << lLmin << " " << lLmax << endl;
+					cout << "result did not match for integral " << i << endl;
+					printf("difference     : %-16.10f\n", fabs(ref[i]-result[i]));
+					printf("geminal value  : %-16.10f\n", result[i]);
+					printf("sum of singles : %-16.10f\n", ref[i]);
+					nFailed++;
+					break;
+				}
+			}
+		}
+	}
+	cout << "number of shell quartets calculated: " << nTested << endl;
+	cout << "number of shell quartets not matching the single terms: " << nFailed << endl;
+	crash(nFailed>0, "the geminal functions do not match the sum of single terms");
+}
+
+#endif
@@ -85,6 +85,26 @@ namespace eritest {
 			const Int& jnp,const vector<Double>& jcoe,const vector<Double>& jexp, const Double* B,
 			const Int& knp,const vector<Double>& kcoe,const vector<Double>& kexp, const Double* C, 
 			const Int& lnp,const vector<Double>& lcoe,const vector<Double>& lexp, const Double* D);
+
+	/**
+	 * test the reentrancy of the ERI functions
+	 * all of normal ERI shell quartets up to maxL are calculated 
+	 * serially first, then nThreads threads calculate them concurrently
+	 * with the thread local memory pool (see threadLocalMemScr in
+	 * the localmemscr.h). The results must be exactly the same
+	 * the arena is sized by hgp_os_eri_scr_len() from the entry file;
+	 * build with "make SCR_SOURCE=thread_local" to test the codes 
+	 * generated with scr_source = thread_local
+	 * \param maxl     : the maximum angular momentum for testing
+	 * \param nThreads : the number of threads running concurrently
+	 * \param nRounds  : how many times each thread repeats the work
+	 * the rest of parameters are same with eri_test
+	 */
+	void eri_reentrancy_test(const Int& maxL, const Int& nThreads, const Int& nRounds,
+			const Int& inp,const vector<Double>& icoe,const vector<Double>& iexp, const Double* A, 
+			const Int& jnp,const vector<Double>& jcoe,const vector<Double>& jexp, const Double* B,
+			const Int& knp,const vector<Double>& kcoe,const vector<Double>& kexp, const Double* C, 
+			const Int& lnp,const vector<Double>& lcoe,const vector<Double>& lexp, const Double* D);
 }
 
 #endif
@@ -39,6 +39,39 @@ namespace expr12test {
 		const Int& jnp, const vector<Double>& jcoe, const vector<Double>& jexp, const Double* B, 
 		const Int& knp, const vector<Double>& kcoe, const vector<Double>& kexp, const Double* C);
 
+#ifdef WITH_KERNEL_REGISTRY
+	/**
+	 * test the geminal functions (geminal_kernels), the geminal is 
+	 * sum_k c_k*exp(-omega_k*r12^2) with three terms; and the result is
+	 * compared with the sum of c_k times the single term function with
+	 * omega_k. All of normal shell quartets up to maxL are tested, the
+	 * ones not generated are skipped
+	 *
+	 * \param maxl : the maximum angular momentum for testing
+	 * \param inp  : contraction degree for shell i
+	 * \param icoe : coefficient array for shell  i
+	 * \param iexp : exponetial factors for shell i
+	 * \param A    : center for shell i
+	 * \param jnp  : contraction degree for shell j
+	 * \param jcoe : coefficient array for shell  j
+	 * \param jexp : exponetial factors for shell j
+	 * \param B    : center for shell j
+	 * \param knp  : contraction degree for shell k
+	 * \param kcoe : coefficient array for shell  k
+	 * \param kexp : exponetial factors for shell k
+	 * \param C    : center for shell k
+	 * \param lnp  : contraction degree for shell l
+	 * \param lcoe : coefficient array for shell  l
+	 * \param lexp : exponetial factors for shell l
+	 * \param D    : center for shell l
+	 */
+	void expr12_geminal_test(const Int& maxL, 
+		const Int& inp, const vector<Double>& icoe, const vector<Double>& iexp, const Double* A, 
+		const Int& jnp, const vector<Double>& jcoe, const vector<Double>& jexp, const Double* B, 
+		const Int& knp, const vector<Double>& kcoe, const vector<Double>& kexp, const Double* C, 
+		const Int& lnp, const vector<Double>& lcoe, const vector<Double>& lexp, const Double* D);
+#endif
+
 }
 
 
@@ -0,0 +1,79 @@
+/**
+ * \file    gcontract.h
+ * \author  Fenglai Liu and Jing Kong
+ */
+#ifndef GCONTRACT_H
+#define GCONTRACT_H
+#include <cstddef>
+#include "localmemscr.h"
+
+namespace gcontract {
+
+	/**
+	 * the work space of the general contraction variants (name_gc), the
+	 * n Doubles are taken from a LocalMemScr arena kept for each thread,
+	 * so the memory is only allocated when a larger one is required. It's
+	 * not the arena of threadLocalMemScr(), which may be in use by the 
+	 * integral function itself. 
+	 *
+	 * The block is valid until the next call in the same thread, and it's
+	 * not initialized; the integral function clears the part accumulated
+	 */
+	inline Double* workSpace(const UInt& n) {
+		static thread_local localmemscr::ThreadLocalMemScr holder;
+		UInt len = localmemscr::LocalMemScr::alignedLength(n);
+		if (holder.scr == NULL || holder.scr->getLength()<len) {
+			delete holder.scr;
+			holder.scr = new localmemscr::LocalMemScr(len);
+		}
+		holder.scr->reset();
+		return holder.scr->getRawMemPos(n);
+	};
+
+	/**
+	 * the contraction on the ket side for one primitive pair.
+	 *
+	 * The general contraction variant computes the N VRR results of the
+	 * primitive pair (ip2,jp2) without any coefficients, and the contracted
+	 * results for all of the contracted functions are
+	 *
+	 * cont[k][l][n] = sum_{ip2,jp2} icoe[ip2+k*inp2]*jcoe[jp2+l*jnp2]*vrr[n]
+	 *
+	 * which is a small matrix product over the primitives. It's done in two
+	 * steps, so the VRR is done once for all of contracted functions. Here
+	 * the results are added into ket[l*N+n] with the jcoe column l (jc is
+	 * jcoe+jp2), the zero coefficients are skipped
+	 */
+	template<size_t N, typename T>
+	inline void ketContract(const T* jc, const size_t& jnp2, const size_t& nKetCont,
+			const T* vrr, T* ket) {
+		for(size_t l=0; l<nKetCont; l++) {
+			const T c = jc[l*jnp2];
+			if (c == T(0)) continue;
+			T* x = &ket[l*N];
+			for(size_t n=0; n<N; n++) x[n] += c*vrr[n];
+		}
+	};
+
+	/**
+	 * the contraction on the bra side, it's done after the loop over the
+	 * ket primitives: cont[(k*nKetCont+l)*N+n] += ic[k*inp2]*ket[l*N+n],
+	 * where ic is icoe+ip2. The ket array is cleared for the next bra
+	 * primitive
+	 */
+	template<size_t N, typename T>
+	inline void braContract(const T* ic, const size_t& inp2, const size_t& nBraCont,
+			const size_t& nKetCont, T* ket, T* cont) {
+		const size_t len = nKetCont*N;
+		for(size_t k=0; k<nBraCont; k++) {
+			const T c = ic[k*inp2];
+			if (c == T(0)) continue;
+			T* x = &cont[k*len];
+			for(size_t i=0; i<len; i++) x[i] += c*ket[i];
+		}
+		for(size_t i=0; i<len; i++) ket[i] = T(0);
+	};
+
+}
+
+#endif
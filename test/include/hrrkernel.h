@@ -0,0 +1,342 @@
+/**
+ * \file    hrrkernel.h
+ * \author  Fenglai Liu and Jing Kong
+ */
+#ifndef HRRKERNEL_H
+#define HRRKERNEL_H
+#include <cstddef>
+#include <vector>
+
+/**
+ * the side of HRR, used as the template parameter of hrrkernel::hrr
+ */
+#define HRR_BRA      1
+#define HRR_KET      2
+
+/**
+ * number of integrals processed together in the HRR steps, the inner
+ * loops of the kernel run over them
+ */
+#define HRR_KERNEL_BATCH   8
+
+namespace hrrkernel {
+
+	/**
+	 * number of Cartesian functions for the given L
+	 */
+	constexpr int nCart(int L) { return (L+1)*(L+2)/2; };
+
+	/**
+	 * the offset of the (e,S| block in the list of e = L1, L1+1 ...
+	 */
+	constexpr int blockOffset(int L1, int e) {
+		return e <= L1 ? 0 : blockOffset(L1,e-1)+nCart(e-1);
+	};
+
+	/**
+	 * number of integrals on the HRR level b, namely (a,b| for
+	 * a = L1 to L1+L2-b
+	 */
+	constexpr int levelLength(int L1, int L2, int b) {
+		return (blockOffset(L1,L1+L2-b+1))*nCart(b);
+	};
+
+	/**
+	 * the max of levelLength for b = 0 to L2
+	 */
+	constexpr int maxLevelLength(int L1, int L2, int b = 0) {
+		return b > L2 ? 0 : (levelLength(L1,L2,b) > maxLevelLength(L1,L2,b+1) ?
+				levelLength(L1,L2,b) : maxLevelLength(L1,L2,b+1));
+	};
+
+	/**
+	 * the index of Cartesian function (lx,ly,lz) in the shell of
+	 * L = lx+ly+lz. The order is same with the generated code,
+	 * e.g. for D it's D2x, Dxy, Dxz, D2y, Dyz, D2z
+	 */
+	inline int cartIndex(int lx, int lz, int L) {
+		int i = L-lx;
+		return i*(i+1)/2+lz;
+	};
+
+	/**
+	 * binomial coefficient
+	 */
+	constexpr int binomial(int n, int k) {
+		return (k == 0 || k == n) ? 1 : binomial(n-1,k-1)+binomial(n-1,k);
+	};
+
+	/**
+	 * number of non-zero elements in the HRR transfer matrix from the
+	 * (e,S| to (L1,L2|; for each Cartesian function of L2 it's
+	 * (bx+1)*(by+1)*(bz+1), and the sum over them is C(L2+5,5)
+	 */
+	constexpr int transferSize(int L1, int L2) {
+		return nCart(L1)*binomial(L2+5,5);
+	};
+
+	/**
+	 * \class HRRTransfer
+	 *
+	 * the pattern of the HRR transfer matrix from (e,S| for e = L1 to
+	 * L1+L2 to the (L1,L2|. Applying the HRR L2 times gives:
+	 *
+	 * (a,b| = sum_{i,j,k} C(bx,i)C(by,j)C(bz,k) X^{bx-i}Y^{by-j}Z^{bz-k} (a+(i,j,k),S|
+	 *
+	 * so each row (a,b) has (bx+1)*(by+1)*(bz+1) non-zero elements. The
+	 * pattern (column, binomial factor and the powers of X, Y, Z) only
+	 * depends on L1 and L2, it's formed once for each of them; in the
+	 * kernel the values are formed with the given AB/CD. The rows are in
+	 * the order of a+b*nCart(L1), the matrix is kept in the compressed 
+	 * row form.
+	 */
+	class HRRTransfer {
+
+		public:
+
+			std::vector<int> rowPtr;   ///< the starting position of each row
+			std::vector<int> cols;     ///< the column (position in the (e,S| list)
+			std::vector<int> factors;  ///< the binomial factors
+			std::vector<int> powers;   ///< the powers of X, Y, Z for each element
+
+			HRRTransfer(int L1, int L2) {
+				int nc1 = nCart(L1);
+				rowPtr.assign(nc1*nCart(L2)+1,0);
+				int row = 0;
+				for(int bx=L2; bx>=0; bx--) {
+					for(int by=L2-bx; by>=0; by--) {
+						int bz = L2-bx-by;
+						for(int ax=L1; ax>=0; ax--) {
+							for(int ay=L1-ax; ay>=0; ay--, row++) {
+								int az = L1-ax-ay;
+								for(int i=0; i<=bx; i++) {
+									for(int j=0; j<=by; j++) {
+										for(int k=0; k<=bz; k++) {
+											int e = L1+i+j+k;
+											cols.push_back(blockOffset(L1,e)+cartIndex(ax+i,az+k,e));
+											factors.push_back(binomial(bx,i)*binomial(by,j)*binomial(bz,k));
+											powers.push_back(bx-i);
+											powers.push_back(by-j);
+											powers.push_back(bz-k);
+										}
+									}
+								}
+								rowPtr[row+1] = cols.size();
+							}
+						}
+					}
+				}
+			};
+	};
+
+	/**
+	 * the transfer pattern for the given L1 and L2, formed on the
+	 * first use
+	 */
+	template<int L1, int L2>
+	inline const HRRTransfer& getHRRTransfer() {
+		static const HRRTransfer transfer(L1,L2);
+		return transfer;
+	};
+
+	/**
+	 * do the HRR for one batch of w (w<=W) integrals, from the
+	 * (e,S| for e = L1 to L1+L2 to the (L1,L2|. The input integral
+	 * (p,k) is in[p*inStride+k*inBatchStride], here p is the position
+	 * in the list of all (e,S| Cartesian functions and k is in the
+	 * batch; the output integral (a,b,k) is written to
+	 * out[(a+b*nCart(L1))*outStride+k*outBatchStride].
+	 *
+	 * The levels (a,b| are kept in local arrays with the batch as the
+	 * fastest dimension. On level b, the Cartesian direction of b
+	 * reduced is the first non-zero one in x, y, z order:
+	 *
+	 * (a,b| = (a+1_i,b-1_i| + X_i(a,b-1_i|
+	 */
+	template<int L1, int L2, int W, typename T>
+	inline void hrrBatch(const T* X, const T* in, size_t inStride, size_t inBatchStride,
+			T* out, size_t outStride, size_t outBatchStride, int w) {
+
+		// we need at least one element in the array
+		const int len = maxLevelLength(L1,L2) > 0 ? maxLevelLength(L1,L2) : 1;
+		T buf0[len*W];
+		T buf1[len*W];
+		T* cur = buf0;
+		T* nxt = buf1;
+
+		// level 0, the input
+		const int nIn = levelLength(L1,L2,0);
+		if (L2 == 0) {
+			for(int p=0; p<nIn; p++) {
+				for(int k=0; k<w; k++) out[p*outStride+k*outBatchStride] = in[p*inStride+k*inBatchStride];
+			}
+			return;
+		}
+		for(int p=0; p<nIn; p++) {
+			for(int k=0; k<w; k++) cur[p*W+k] = in[p*inStride+k*inBatchStride];
+			for(int k=w; k<W; k++) cur[p*W+k] = T(0);
+		}
+
+		// now the levels
+		for(int b=1; b<=L2; b++) {
+			int nb  = nCart(b);
+			int nb1 = nCart(b-1);
+			bool lastLevel = (b == L2);
+			int offset = 0;
+			for(int a=L1; a<=L1+L2-b; a++) {
+
+				// the offsets of (a,b-1| and (a+1,b-1| on the previous level
+				int na   = nCart(a);
+				int na1  = nCart(a+1);
+				int off0 = blockOffset(L1,a)*nb1;
+				int off1 = blockOffset(L1,a+1)*nb1;
+
+				// loop over the Cartesian functions of b
+				int bi = 0;
+				for(int bx=b; bx>=0; bx--) {
+					for(int by=b-bx; by>=0; by--, bi++) {
+						int bz  = b-bx-by;
+						int dir = bx > 0 ? 0 : (by > 0 ? 1 : 2);
+						int bmx = dir == 0 ? bx-1 : bx;
+						int bmz = dir == 2 ? bz-1 : bz;
+						int bmi = cartIndex(bmx,bmz,b-1);
+						const T Xi = X[dir];
+
+						// loop over the Cartesian functions of a
+						int ai = 0;
+						for(int ax=a; ax>=0; ax--) {
+							for(int ay=a-ax; ay>=0; ay--, ai++) {
+								int az  = a-ax-ay;
+								int api = cartIndex(dir == 0 ? ax+1 : ax, dir == 2 ? az+1 : az, a+1);
+								const T* r1 = &cur[(off1+api+na1*bmi)*W];
+								const T* r0 = &cur[(off0+ai+na*bmi)*W];
+								if (lastLevel) {
+									T* o = &out[(ai+na*bi)*outStride];
+									for(int k=0; k<w; k++) o[k*outBatchStride] = r1[k]+Xi*r0[k];
+								}else{
+									T* l = &nxt[(offset+ai+na*bi)*W];
+									for(int k=0; k<W; k++) l[k] = r1[k]+Xi*r0[k];
+								}
+							}
+						}
+					}
+				}
+				offset += na*nb;
+			}
+
+			// swap the levels
+			T* tmp = cur;
+			cur = nxt;
+			nxt = tmp;
+		}
+	};
+
+	/**
+	 * template kernel of the HRR on one side of the shell quartet.
+	 *
+	 * The generated integral function (hrr_template = true) gathers the
+	 * contracted VRR results into an array and calls this kernel rather
+	 * than printing each HRR step, so all of the shell quartets with the
+	 * same (L1,L2) on the given side share one copy of the code.
+	 *
+	 * For the HRR_BRA side, X1/X2 are the centers A/B; the input holds
+	 * (e,S| for e = L1 to L1+L2 for each of the n ket integrals, that is
+	 * in[k*nE+p] where nE is the total number of (e,S| Cartesian
+	 * functions; the output is (L1,L2| in the order of bra1 fastest,
+	 * out[k*nCart(L1)*nCart(L2)+a+b*nCart(L1)].
+	 *
+	 * For the HRR_KET side, X1/X2 are the centers C/D; the input holds
+	 * |f,S) for f = L1 to L1+L2 with the n bra integrals the fastest,
+	 * in[p*n+k]; the output is out[(c+d*nCart(L1))*n+k].
+	 *
+	 * Therefore the integral order of the final result is same with the
+	 * generated code (bra1, bra2, ket1, ket2 from fastest to slowest), and
+	 * the output of one side is directly the input of the other side.
+	 */
+	template<int SIDE, int L1, int L2, typename T>
+	inline void hrr(const T* X1, const T* X2, const T* in, T* out, const size_t& n) {
+
+		// the AB/CD
+		const T X[3] = {X1[0]-X2[0], X1[1]-X2[1], X1[2]-X2[2]};
+		const int W  = HRR_KERNEL_BATCH;
+		const size_t nE   = blockOffset(L1,L1+L2+1);
+		const size_t nOut = nCart(L1)*nCart(L2);
+
+		// each batch is a group of W integrals on the other side
+		for(size_t k=0; k<n; k+=W) {
+			int w = n-k < (size_t)W ? n-k : W;
+			if (SIDE == HRR_BRA) {
+				hrrBatch<L1,L2,W,T>(X,&in[k*nE],1,nE,&out[k*nOut],1,nOut,w);
+			}else{
+				hrrBatch<L1,L2,W,T>(X,&in[k],n,1,&out[k],n,1,w);
+			}
+		}
+	};
+
+	/**
+	 * the HRR done as the transfer matrix product, it has the same
+	 * arguments and the data layout with hrr() above.
+	 *
+	 * The values of the transfer matrix are formed once with the
+	 * given AB/CD, then for each batch of W integrals on the other
+	 * side the input is loaded into a local block (the batch is the 
+	 * fastest dimension) and each result row is the sum of the non-zero
+	 * elements times the input rows. The number of operations is not 
+	 * more than the recursive form for high L, and there's no 
+	 * intermediate level to store.
+	 */
+	template<int SIDE, int L1, int L2, typename T>
+	inline void hrrMatrix(const T* X1, const T* X2, const T* in, T* out, const size_t& n) {
+
+		// the AB/CD and their powers
+		const T X[3] = {X1[0]-X2[0], X1[1]-X2[1], X1[2]-X2[2]};
+		T pw[3][L2+1];
+		for(int i=0; i<3; i++) {
+			pw[i][0] = T(1);
+			for(int p=1; p<=L2; p++) pw[i][p] = pw[i][p-1]*X[i];
+		}
+
+		// now form the matrix values
+		const HRRTransfer& transfer = getHRRTransfer<L1,L2>();
+		const int nnz = transferSize(L1,L2);
+		T values[nnz];
+		for(int i=0; i<nnz; i++) {
+			const int* p = &transfer.powers[3*i];
+			values[i] = transfer.factors[i]*pw[0][p[0]]*pw[1][p[1]]*pw[2][p[2]];
+		}
+
+		// the strides of data
+		const int W = HRR_KERNEL_BATCH;
+		const int nE    = blockOffset(L1,L1+L2+1);
+		const int nRows = nCart(L1)*nCart(L2);
+		size_t inStride  = SIDE == HRR_BRA ? 1  : n;
+		size_t inBatch   = SIDE == HRR_BRA ? nE : 1;
+		size_t outStride = SIDE == HRR_BRA ? 1  : n;
+		size_t outBatch  = SIDE == HRR_BRA ? nRows : 1;
+
+		// loop over the batches
+		T buf[nE*W];
+		for(size_t k0=0; k0<n; k0+=W) {
+			int w = n-k0 < (size_t)W ? n-k0 : W;
+			const T* src = &in[k0*inBatch];
+			T* dst = &out[k0*outBatch];
+			for(int p=0; p<nE; p++) {
+				for(int k=0; k<w; k++) buf[p*W+k] = src[p*inStride+k*inBatch];
+				for(int k=w; k<W; k++) buf[p*W+k] = T(0);
+			}
+			for(int r=0; r<nRows; r++) {
+				T acc[W];
+				for(int k=0; k<W; k++) acc[k] = T(0);
+				for(int i=transfer.rowPtr[r]; i<transfer.rowPtr[r+1]; i++) {
+					const T v = values[i];
+					const T* b = &buf[transfer.cols[i]*W];
+					for(int k=0; k<W; k++) acc[k] += v*b[k];
+				}
+				for(int k=0; k<w; k++) dst[r*outStride+k*outBatch] = acc[k];
+			}
+		}
+	};
+
+}
+
+#endif
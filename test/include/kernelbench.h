@@ -0,0 +1,291 @@
+/**
+ * \file    kernelbench.h
+ * \author  Fenglai Liu and Jing Kong
+ */
+#ifndef KERNELBENCH_H
+#define KERNELBENCH_H
+#include "libgen.h"
+#include <chrono>
+#include <sstream>
+#include <random>
+typedef std::vector<Double>   DoubleVec;
+typedef std::vector<UInt>     UIntVec;
+
+namespace kernelbench {
+
+	/**
+	 * \class   KernelBenchOptions
+	 * \brief   the options of the benchmark driver generated with the registry
+	 *
+	 * the options are given in the command line in form of key=value:
+	 * nprim   - number of primitives for each shell (default 3)
+	 * screen  - the fraction of bra primitive pairs which are screened
+	 *           out by the significance test in the integral function (0.0)
+	 * sets    - number of random geometries the calls cycle through (16)
+	 * atoms   - number of atoms for NAI type of integrals (1)
+	 * grids   - number of grid points for ESP type of integrals (1)
+	 * omega   - the omega for the erf(omega*r12)/r12 operator (0.0)
+	 * time    - the minimum time (in seconds) spent on each function (0.1)
+	 * seed    - the seed of random number generator (1)
+	 * json    - the output file, in default the report goes to screen
+	 * only    - only benchmark the functions whose name contains it
+	 */
+	class KernelBenchOptions {
+
+		public:
+
+			UInt nPrim;            ///< number of primitives for each shell
+			Double screen;         ///< fraction of the bra primitive pairs screened out
+			UInt nSets;            ///< number of random geometries
+			UInt nAtoms;           ///< number of atoms for NAI
+			UInt nGrids;           ///< number of grid points for ESP
+			Double omega;          ///< omega for the erf(omega*r12)/r12 operator
+			Double minTime;        ///< minimum time spent on each function
+			UInt seed;             ///< seed of the random number generator
+			string json;           ///< output file of the report
+			string only;           ///< pattern of function name to benchmark
+
+			KernelBenchOptions(int argc, char* argv[]):nPrim(3),screen(ZERO),nSets(16),
+			nAtoms(1),nGrids(1),omega(ZERO),minTime(0.1E0),seed(1) {
+				for(int i=1; i<argc; i++) {
+					string arg = argv[i];
+					size_t pos = arg.find("=");
+					if (pos == string::npos) {
+						crash(true,"the benchmark option should be in form of key=value: " + arg);
+					}
+					string key   = arg.substr(0,pos);
+					string value = arg.substr(pos+1);
+					if (key == "nprim") {
+						nPrim = atoi(value.c_str());
+					}else if (key == "screen") {
+						screen = atof(value.c_str());
+					}else if (key == "sets") {
+						nSets = atoi(value.c_str());
+					}else if (key == "atoms") {
+						nAtoms = atoi(value.c_str());
+					}else if (key == "grids") {
+						nGrids = atoi(value.c_str());
+					}else if (key == "omega") {
+						omega = atof(value.c_str());
+					}else if (key == "time") {
+						minTime = atof(value.c_str());
+					}else if (key == "seed") {
+						seed = atoi(value.c_str());
+					}else if (key == "json") {
+						json = value;
+					}else if (key == "only") {
+						only = value;
+					}else{
+						crash(true,"unknown benchmark option: " + key);
+					}
+				}
+				if (nPrim == 0 || nSets == 0 || nAtoms == 0 || nGrids == 0) {
+					crash(true,"the benchmark dimension options must be positive");
+				}
+				if (screen < ZERO || screen >= ONE) {
+					crash(true,"the screen ratio must be in [0,1)");
+				}
+			};
+	};
+
+	/**
+	 * \class   KernelBenchData
+	 * \brief   the input of integral function for one random geometry
+	 *
+	 * The data members use the same names with the arguments of the
+	 * generated integral functions, so the benchmark driver simply calls
+	 * the function with d.inp2, d.icoe etc. Centers are random in a box
+	 * of 6 bohr, exponents are random between 0.05 and 50 in log scale.
+	 * The bra/ket pair data are formed in the same way as the test
+	 * codes do (see eritest.cpp). For the screened bra pairs the
+	 * prefactor is zero, therefore the integral function skips them.
+	 *
+	 * The coefficient arrays are long enough for the composite shells.
+	 * For the strided result layout all of strides are one, so the
+	 * results stay in the first nInts*nGrids elements of abcd
+	 */
+	class KernelBenchData {
+
+		private:
+
+			DoubleVec braData;     ///< holding memory for the bra side
+			DoubleVec ketData;     ///< holding memory for the ket side
+			DoubleVec centers;     ///< A, B, C, D
+			DoubleVec points;      ///< atom coordinates and grid points
+			UIntVec   charges;     ///< atom charges
+			UIntVec   strides;     ///< strides of the result layout
+
+			KernelBenchData(const KernelBenchData& d);
+			KernelBenchData& operator=(const KernelBenchData& d);
+
+			/**
+			 * form the pair data, return the number of significant pairs
+			 */
+			static UInt formPairs(std::mt19937& gen, UInt nPrim, Double screen,
+					const Double* X, const Double* Y, DoubleVec& data) {
+				std::uniform_real_distribution<Double> logExp(log(0.05E0),log(50.0E0));
+				std::uniform_real_distribution<Double> coef(0.1E0,ONE);
+				std::uniform_real_distribution<Double> uni(ZERO,ONE);
+				UInt np2 = nPrim*nPrim;
+				data.assign(11*np2,ZERO);
+				Double* coe  = &data[0];
+				Double* expo = &data[4*np2];
+				Double* diff = &data[5*np2];
+				Double* fac  = &data[6*np2];
+				Double* P    = &data[7*np2];
+				DoubleVec e1(nPrim), e2(nPrim);
+				for(UInt i=0; i<nPrim; i++) e1[i] = exp(logExp(gen));
+				for(UInt i=0; i<nPrim; i++) e2[i] = exp(logExp(gen));
+				Double XY2 = (X[0]-Y[0])*(X[0]-Y[0])+(X[1]-Y[1])*(X[1]-Y[1])+(X[2]-Y[2])*(X[2]-Y[2]);
+				UInt nSig = 0;
+				for(UInt j=0; j<nPrim; j++) {
+					for(UInt i=0; i<nPrim; i++) {
+						UInt k = i+j*nPrim;
+						Double alpha = e1[i]+e2[j];
+						for(UInt c=0; c<4; c++) coe[k+c*np2] = coef(gen);
+						expo[k] = ONE/alpha;
+						diff[k] = e1[i]-e2[j];
+						fac[k]  = exp(-e1[i]*e2[j]/alpha*XY2)*pow(PI/alpha,1.5E0);
+						for(UInt x=0; x<3; x++) P[3*k+x] = (e1[i]*X[x]+e2[j]*Y[x])/alpha;
+						if (uni(gen) < screen) {
+							fac[k] = ZERO;
+						}else{
+							nSig++;
+						}
+					}
+				}
+				return nSig;
+			};
+
+		public:
+
+			UInt inp2;             ///< number of bra primitive pairs
+			UInt jnp2;             ///< number of ket primitive pairs
+			UInt nAtoms;           ///< number of atoms
+			UInt nGrids;           ///< number of grid points
+			UInt nSigPairs;        ///< number of significant bra primitive pairs
+			Double pMax;           ///< density matrix bound
+			Double omega;          ///< omega for the erf(omega*r12)/r12 operator
+			Double abcdScale;      ///< scale of the strided result
+			const Double* icoe;    ///< bra coefficients
+			const Double* iexp;    ///< 1/(alpha+beta)
+			const Double* iexpdiff;///< alpha-beta
+			const Double* ifac;    ///< bra prefactors
+			const Double* P;       ///< bra centers
+			const Double* jcoe;    ///< ket coefficients
+			const Double* jexp;    ///< 1/(gamma+delta)
+			const Double* jexpdiff;///< gamma-delta
+			const Double* jfac;    ///< ket prefactors
+			const Double* Q;       ///< ket centers
+			const Double* A;       ///< center of bra1
+			const Double* B;       ///< center of bra2
+			const Double* C;       ///< center of ket1
+			const Double* D;       ///< center of ket2
+			const Double* N;       ///< atom coordinates
+			const UInt* Z;         ///< atom charges
+			const Double* R;       ///< grid points
+			const UInt* abcdStride;///< strides of the result
+			Double* abcd;          ///< the result
+
+			KernelBenchData(std::mt19937& gen, const KernelBenchOptions& opt, Double* result):
+			centers(12),points(3*(opt.nAtoms+opt.nGrids)),charges(opt.nAtoms),strides(6,1),
+			inp2(opt.nPrim*opt.nPrim),jnp2(opt.nPrim*opt.nPrim),nAtoms(opt.nAtoms),nGrids(opt.nGrids),
+			nSigPairs(0),pMax(ONE),omega(opt.omega),abcdScale(ONE),abcd(result) {
+				std::uniform_real_distribution<Double> box(-3.0E0,3.0E0);
+				for(UInt i=0; i<centers.size(); i++) centers[i] = box(gen);
+				for(UInt i=0; i<points.size(); i++) points[i] = box(gen);
+				for(UInt i=0; i<charges.size(); i++) charges[i] = 1+i%8;
+				A = &centers[0];
+				B = &centers[3];
+				C = &centers[6];
+				D = &centers[9];
+				N = &points[0];
+				R = &points[3*nAtoms];
+				Z = &charges[0];
+				abcdStride = &strides[0];
+				nSigPairs = formPairs(gen,opt.nPrim,opt.screen,A,B,braData);
+				formPairs(gen,opt.nPrim,ZERO,C,D,ketData);
+				icoe     = &braData[0];
+				iexp     = &braData[4*inp2];
+				iexpdiff = &braData[5*inp2];
+				ifac     = &braData[6*inp2];
+				P        = &braData[7*inp2];
+				jcoe     = &ketData[0];
+				jexp     = &ketData[4*jnp2];
+				jexpdiff = &ketData[5*jnp2];
+				jfac     = &ketData[6*jnp2];
+				Q        = &ketData[7*jnp2];
+			};
+
+			~KernelBenchData() { };
+	};
+
+	/**
+	 * \class   KernelBenchReport
+	 * \brief   collect the timing of integral functions and print it as JSON
+	 *
+	 * one call of the integral function computes one shell quartet (or
+	 * shell pair, shell triple for the less body integrals), so the
+	 * ns/quartet is the time per call. The GFLOP/s is based on the FLOP
+	 * estimation in the registry, the primitive part is multiplied by
+	 * the number of significant primitive loops
+	 */
+	class KernelBenchReport {
+
+		private:
+
+			const KernelBenchOptions& opt;   ///< the options
+			string name;                     ///< the entry function name
+			std::ostringstream records;      ///< records of the functions
+			UInt nRecords;                   ///< number of records
+
+		public:
+
+			KernelBenchReport(const KernelBenchOptions& opt0, const string& name0):
+			opt(opt0),name(name0),nRecords(0) { };
+
+			/**
+			 * add in the timing of one integral function
+			 */
+			void add(const string& func, const LInt& LCode, const UInt& nInts,
+					const UInt& nCalls, const Double& seconds, const Double& flopsPerCall) {
+				Double ns = seconds*1.0E9/nCalls;
+				if (nRecords > 0) records << ",\n";
+				records << "    {\"kernel\": \"" << func << "\", \"lcode\": " << LCode
+					<< ", \"n_ints\": " << nInts << ", \"calls\": " << nCalls
+					<< ", \"ns_per_quartet\": " << ns << ", \"quartets_per_s\": " << 1.0E9/ns
+					<< ", \"gflops\": " << flopsPerCall/ns << "}";
+				nRecords++;
+			};
+
+			/**
+			 * print the report
+			 */
+			void print() const {
+				std::ostringstream out;
+				out << "{\n  \"name\": \"" << name << "\", \"nprim\": " << opt.nPrim
+					<< ", \"screen\": " << opt.screen << ", \"sets\": " << opt.nSets
+					<< ", \"atoms\": " << opt.nAtoms << ", \"grids\": " << opt.nGrids
+					<< ", \"omega\": " << opt.omega << ", \"seed\": " << opt.seed
+					<< ",\n  \"kernels\": [\n" << records.str() << "\n  ]\n}\n";
+				if (opt.json.size() == 0) {
+					cout << out.str();
+					return;
+				}
+				ofstream file(opt.json.c_str());
+				if (! file) crash(true,"can not open the benchmark report file " + opt.json);
+				file << out.str();
+			};
+	};
+
+	/**
+	 * the wall time in seconds
+	 */
+	inline Double benchTime() {
+		typedef std::chrono::steady_clock Clock;
+		return std::chrono::duration<Double>(Clock::now().time_since_epoch()).count();
+	};
+
+}
+
+#endif
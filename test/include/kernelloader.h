@@ -0,0 +1,65 @@
+/**
+ * \file    kernelloader.h
+ * \author  Fenglai Liu and Jing Kong
+ */
+#ifndef KERNELLOADER_H
+#define KERNELLOADER_H
+#include "libgen.h"
+#include <cstdlib>
+#include <dlfcn.h>
+
+/**
+ * the environment variable giving the folder of the integral shared
+ * objects, if it's not set the dynamic linker searches the library
+ * in its own way (LD_LIBRARY_PATH, rpath etc.)
+ */
+#define KERNEL_LIB_PATH_ENV   "CPPINTS_KERNEL_PATH"
+
+namespace kernelloader {
+
+	/**
+	 * load the group of integral functions from the shared object
+	 *
+	 * With kernel_package = shared_by_l the integral functions are packaged
+	 * into one shared object for each L sum (e.g. libhgp_os_eri_l4.so),
+	 * and each shared object exports the function table of the group with
+	 * C linkage (e.g. hgp_os_eri_l4_funcs). The generated entry function
+	 * calls this loader the first time a group is used (guarded by
+	 * std::call_once), so only the groups really used by the basis set are
+	 * mapped into the process.
+	 *
+	 * The shared object is never closed, the function table stays valid
+	 * until the process ends. If the library or the table can not be
+	 * found we crash with the message from dlerror()
+	 */
+	inline void* loadKernelGroup(const string& lib, const string& symbol) {
+
+		// form the library path
+		string file = lib;
+		const char* dir = getenv(KERNEL_LIB_PATH_ENV);
+		if (dir != NULL && dir[0] != '\0') {
+			file = string(dir) + "/" + lib;
+		}
+
+		// open it, all of symbols are resolved now so that the
+		// error shows up here rather than in the integral calculation
+		void* handle = dlopen(file.c_str(),RTLD_NOW|RTLD_LOCAL);
+		if (handle == NULL) {
+			crash(true,"loadKernelGroup failed to open " + file + ": " + string(dlerror()));
+		}
+
+		// now get the function table
+		dlerror();
+		void* table = dlsym(handle,symbol.c_str());
+		const char* error = dlerror();
+		if (error != NULL || table == NULL) {
+			string msg = "loadKernelGroup failed to find " + symbol + " in " + file;
+			if (error != NULL) msg = msg + ": " + string(error);
+			crash(true,msg);
+		}
+		return table;
+	};
+
+}
+
+#endif
@@ -6,42 +6,79 @@
 #define LOCALMEMSCR_H
 #include "libgen.h"
 #include<vector>
+#include<cstring>
 typedef std::vector<Double>   DoubleVec;
 typedef std::vector<UInt>     UIntVec;
 typedef std::vector<Int>      IntVec;
 
-namespace localmemscr {
+/**
+ * the alignment (in bytes) for every memory block given out by LocalMemScr
+ */
+#define LOCAL_MEM_SCR_ALIGNMENT   64
 
+namespace localmemscr {
 
 	/**
 	 * \class   LocalMemScr
-	 * \brief   manipulating local memory for single thread
+	 * \brief   scope based local memory arena for single thread
 	 *
 	 * Currently the local memory scratch is only for double type of data
 	 *
-	 * The implementation of this class is very simple. However, it's not 
-	 * flexible; for example; if you have a lot of places which need 
-	 * memory, and these places are totally independent with each other;
-	 * such class will cause memory waste since it will always hold the 
-	 * memory until reset is called.
+	 * The memory is handed out as a stack. Each block returned by
+	 * getNewMemPos is aligned on LOCAL_MEM_SCR_ALIGNMENT bytes. The user
+	 * takes a mark of the current stack top by mark(), and release all
+	 * of blocks obtained after the mark by rewind(mark). LocalMemScope
+	 * below does the mark/rewind pair automatically for a code scope.
+	 *
+	 * The holding memory is never zero filled as a whole. Only the block
+	 * returned by getNewMemPos is cleared, since the generated integral
+	 * codes accumulate into it. For the block which is fully written
+	 * before reading, getRawMemPos could be used.
 	 *
-	 * Use it with your caution!
+	 * reset() simply rewinds to the beginning of the memory, so it's
+	 * cheap to call it after each integral function call.
+	 *
+	 * The class is not thread safe, each thread should have its own
+	 * object (see threadLocalMemScr below).
 	 */
 	class LocalMemScr {
 
 		private:
 
-			UInt lastMemUser;      ///< the last memory user position
-			UInt lastMemLen;       ///< for the last memory user, it's required mem length
+			UInt top;              ///< current stack top position (in unit of Double)
+			UInt maxTop;           ///< the highest stack top ever reached
+			UInt len;              ///< the usable length of memory
+			Double* mem;           ///< aligned starting position of memory
 			DoubleVec memHolder;   ///< holding memory for the scratch
 
+			/**
+			 * the alignment in unit of Double
+			 */
+			static UInt alignUnit() {
+				return LOCAL_MEM_SCR_ALIGNMENT/sizeof(Double);
+			};
+
+			/**
+			 * we do not allow copy of the memory arena
+			 */
+			LocalMemScr(const LocalMemScr& scr);
+			LocalMemScr& operator=(const LocalMemScr& scr);
+
 		public:
 
 			/**
 			 * initilize the local memory sratch
+			 * we allocate additional space so that the starting
+			 * position could be aligned
 			 */
-			LocalMemScr(const UInt& len):lastMemUser(0),lastMemLen(0),
-			memHolder(len,ZERO) { };
+			LocalMemScr(const UInt& len0):top(0),maxTop(0),len(len0),mem(NULL),
+			memHolder(len0+alignUnit()) {
+				UInt addr = reinterpret_cast<UInt>(&memHolder[0]);
+				UInt mis  = addr%LOCAL_MEM_SCR_ALIGNMENT;
+				UInt skip = 0;
+				if (mis>0) skip = (LOCAL_MEM_SCR_ALIGNMENT-mis)/sizeof(Double);
+				mem = &memHolder[skip];
+			};
 
 			/**
 			 * destructor
@@ -49,48 +86,156 @@ namespace localmemscr {
 			~LocalMemScr() { };
 
 			/**
-			 * return a new memory position according to the length
-			 * it required
+			 * the length of memory (in unit of Double) really taken
+			 * by a block of n Doubles, the block is aligned. The 
+			 * scr length functions and the registry table in the 
+			 * generated code use it, so it's a constant expression
 			 */
-			Double* getNewMemPos(const UInt& len) {
-
-				// firstly check that whether there's no memory usr
-				// if in this case, things is very simple
-				if (lastMemLen == 0) {
+			static constexpr UInt alignedLength(const UInt n) {
+				return ((n+LOCAL_MEM_SCR_ALIGNMENT/sizeof(Double)-1)/
+						(LOCAL_MEM_SCR_ALIGNMENT/sizeof(Double)))*(LOCAL_MEM_SCR_ALIGNMENT/sizeof(Double));
+			};
 
-					// check that whether the length is less than the 
-					// whole memory length
-					if (len>memHolder.size()) {
-						crash(true,"localMemScr required memory is larger than what we have in total");
-					}
+			/**
+			 * return a new memory position according to the length it
+			 * required, the memory content is not initialized
+			 */
+			Double* getRawMemPos(const UInt& n) {
 
-					// now it's safe to do the work
-					lastMemLen = len;
-					return &memHolder[0];
+				// round the length to the alignment
+				UInt total = alignedLength(n);
+				if (top+total>len) {
+					crash(true,"localMemScr required memory is larger than what we have in total");
 				}
 
-				// secondly, let's go to see that wether we can
-				// append a new memory position to the memory user
-				UInt lastPos    = lastMemUser;
-				UInt lastLen    = lastMemLen;
-				UInt newPos     = lastPos+lastLen;
-				if (newPos>=memHolder.size() || newPos+len>=memHolder.size()) {
-					crash(true, "in getNewMemPos vector overflow");
+				// now it's safe to do the work
+				Double* pos = mem+top;
+				top += total;
+				if (top>maxTop) maxTop = top;
+				return pos;
+			};
+
+			/**
+			 * return a new memory position according to the length
+			 * it required, the block is zero initialized
+			 */
+			Double* getNewMemPos(const UInt& n) {
+				Double* pos = getRawMemPos(n);
+				memset(pos,0,n*sizeof(Double));
+				return pos;
+			};
+
+			/**
+			 * return the current stack top, so that all of memory
+			 * blocks obtained after it could be released by rewind
+			 */
+			UInt mark() const { return top; };
+
+			/**
+			 * release all of memory blocks obtained after the given mark
+			 */
+			void rewind(const UInt& pos) {
+				if (pos>top) {
+					crash(true,"in LocalMemScr::rewind the mark is beyond the stack top");
 				}
-				lastMemUser = newPos;
-				lastMemLen  = len;
-				return &memHolder[newPos];
+				top = pos;
 			};
 
 			/**
 			 * reset the local memory scratch
 			 * to erase all of memory users information
 			 */
-			void reset() {
-				lastMemUser = 0;
-				lastMemLen  = 0;
-				memHolder.assign(memHolder.size(),ZERO);
-			};
+			void reset() { top = 0; };
+
+			/**
+			 * return the total length of the memory
+			 */
+			UInt getLength() const { return len; };
+
+			/**
+			 * return the highest memory usage (in unit of Double)
+			 * this could be used to size the memory arena
+			 */
+			UInt getMaxMemUsed() const { return maxTop; };
+	};
+
+	/**
+	 * \class   LocalMemScope
+	 * \brief   release the memory obtained in the current scope
+	 *
+	 * the generated integral functions create this object on the top
+	 * of the function body (or the grid loop body), therefore all of
+	 * arrays obtained from the scr are released at the end of it
+	 */
+	class LocalMemScope {
+
+		private:
+
+			LocalMemScr& scr;      ///< the memory arena
+			UInt pos;              ///< the mark when we enter the scope
+
+			/**
+			 * we do not allow copy of the scope
+			 */
+			LocalMemScope(const LocalMemScope& scope);
+			LocalMemScope& operator=(const LocalMemScope& scope);
+
+		public:
+
+			LocalMemScope(LocalMemScr& scr0):scr(scr0),pos(scr0.mark()) { };
+
+			~LocalMemScope() { scr.rewind(pos); };
+	};
+
+	/**
+	 * \class   ThreadLocalMemScr
+	 * \brief   holder of the memory arena for each thread
+	 */
+	class ThreadLocalMemScr {
+
+		public:
+
+			LocalMemScr* scr;      ///< the arena for this thread
+
+			ThreadLocalMemScr():scr(NULL) { };
+
+			~ThreadLocalMemScr() { delete scr; };
+	};
+
+	/**
+	 * return the memory arena for the calling thread, this is the 
+	 * thread local memory pool for the integral functions
+	 *
+	 * The arena is created in the first call with the given length; 
+	 * later calls in the same thread return the same arena, so there's
+	 * no heap allocation (and no allocator contention between threads)
+	 * after the first call. The length could be given by the scr length
+	 * function generated together with each integral function, e.g.
+	 * hgp_os_eri_d_d_p_s_scr_len(); to avoid re-creating the arena the
+	 * caller could reserve it with the largest length before the real work.
+	 *
+	 * If a larger length is required later, the arena is re-created. This
+	 * is only allowed when none of memory in the arena is in use, else the
+	 * blocks held by the caller would be lost
+	 *
+	 * Reentrancy of the integral functions: the generated functions have 
+	 * no static or global data which is written. All of the working 
+	 * arrays come from the scr (or the stack, see vector_form = STACK), 
+	 * and they are released on return by LocalMemScope. Therefore the 
+	 * functions could be called concurrently as long as each thread uses 
+	 * its own arena, which is what threadLocalMemScr gives (generated 
+	 * with scr_source = thread_local the function fetches it by itself)
+	 */
+	inline LocalMemScr& threadLocalMemScr(const UInt& len) {
+		static thread_local ThreadLocalMemScr holder;
+		if (holder.scr == NULL || holder.scr->getLength()<len) {
+			if (holder.scr != NULL && holder.scr->mark()>0) {
+				crash(true,"threadLocalMemScr can not grow the arena while its memory is still in use");
+			}
+			delete holder.scr;
+			holder.scr = new LocalMemScr(len);
+		}
+		return *holder.scr;
 	};
 
 }
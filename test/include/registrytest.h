@@ -0,0 +1,288 @@
+#ifndef REGISTRYTEST_H
+#define REGISTRYTEST_H
+#include "libgen.h"
+
+//
+// The tests here work on the codes generated with kernel_registry = true,
+// build the test with "make KERNEL_REGISTRY=true". The variant kernels
+// (same center, general contraction etc.) are compared with the plain
+// integral functions in the same registry, which are already tested by
+// the eritest against the direct calculation. So the variants are only
+// tested for their own work, the two results must be same within THRESH.
+//
+// The coefficients are not normalized, since both sides take the same
+// shell data. The shell quartets are all of normal ERI ones up to maxL,
+// the ones not in the registry (NULL function) are skipped.
+//
+
+namespace registrytest {
+
+	/**
+	 * test the ERI variants for the same centers (same_center_kernels)
+	 * the shell quartets are calculated through the registry entry
+	 * function with A==B, C==D and both, so the entry picks up the
+	 * variant; the result is compared with the plain function taken
+	 * from the registry table directly
+	 * \param maxl : the maximum angular momentum for testing
+	 * \param inp  : contraction degree for shell i
+	 * \param icoe : coefficient array  for shell i
+	 * \param iexp : exponetial factors for shell i
+	 * \param A    : center for shell i
+	 * \param jnp  : contraction degree for shell j
+	 * \param jcoe : coefficient array  for shell j
+	 * \param jexp : exponetial factors for shell j
+	 * \param B    : center for shell j
+	 * \param knp  : contraction degree for shell k
+	 * \param kcoe : coefficient array  for shell k
+	 * \param kexp : exponetial factors for shell k
+	 * \param C    : center for shell k
+	 * \param lnp  : contraction degree for shell l
+	 * \param lcoe : coefficient array  for shell l
+	 * \param lexp : exponetial factors for shell l
+	 * \param D    : center for shell l
+	 */
+	void same_center_test(const Int& maxL,
+			const Int& inp,const vector<Double>& icoe,const vector<Double>& iexp, const Double* A,
+			const Int& jnp,const vector<Double>& jcoe,const vector<Double>& jexp, const Double* B,
+			const Int& knp,const vector<Double>& kcoe,const vector<Double>& kexp, const Double* C,
+			const Int& lnp,const vector<Double>& lcoe,const vector<Double>& lexp, const Double* D);
+
+	/**
+	 * test the ERI variants for the permutational symmetry (symmetry_kernels)
+	 * the identical shells are formed by taking the same shell data twice,
+	 * for (aa|aa), (aa|cc), (ab|ab), (aa|cd) and (ab|cc); the result of the
+	 * registry entry function is compared with the plain function
+	 * \param maxl : the maximum angular momentum for testing
+	 * \param inp  : contraction degree for shell i
+	 * \param icoe : coefficient array  for shell i
+	 * \param iexp : exponetial factors for shell i
+	 * \param A    : center for shell i
+	 * \param jnp  : contraction degree for shell j
+	 * \param jcoe : coefficient array  for shell j
+	 * \param jexp : exponetial factors for shell j
+	 * \param B    : center for shell j
+	 * \param knp  : contraction degree for shell k
+	 * \param kcoe : coefficient array  for shell k
+	 * \param kexp : exponetial factors for shell k
+	 * \param C    : center for shell k
+	 * \param lnp  : contraction degree for shell l
+	 * \param lcoe : coefficient array  for shell l
+	 * \param lexp : exponetial factors for shell l
+	 * \param D    : center for shell l
+	 */
+	void symmetry_test(const Int& maxL,
+			const Int& inp,const vector<Double>& icoe,const vector<Double>& iexp, const Double* A,
+			const Int& jnp,const vector<Double>& jcoe,const vector<Double>& jexp, const Double* B,
+			const Int& knp,const vector<Double>& kcoe,const vector<Double>& kexp, const Double* C,
+			const Int& lnp,const vector<Double>& lcoe,const vector<Double>& lexp, const Double* D);
+
+	/**
+	 * test the ERI variants for the general contraction (gc_kernels)
+	 * the shell pairs carry 2 contracted functions on bra and 3 on ket,
+	 * the block (k,l) of the variant result is compared with the plain
+	 * function taking the coefficient column k on bra and l on ket
+		 * \param maxl : the maximum angular momentum for testing
+		 * \param inp  : contraction degree for shell i
+	 * \param icoe : coefficient array  for shell i
+	 * \param iexp : exponetial factors for shell i
+	 * \param A    : center for shell i
+	 * \param jnp  : contraction degree for shell j
+	 * \param jcoe : coefficient array  for shell j
+	 * \param jexp : exponetial factors for shell j
+	 * \param B    : center for shell j
+	 * \param knp  : contraction degree for shell k
+	 * \param kcoe : coefficient array  for shell k
+	 * \param kexp : exponetial factors for shell k
+	 * \param C    : center for shell k
+	 * \param lnp  : contraction degree for shell l
+	 * \param lcoe : coefficient array  for shell l
+	 * \param lexp : exponetial factors for shell l
+	 * \param D    : center for shell l
+	 */
+	void gc_test(const Int& maxL,
+			const Int& inp,const vector<Double>& icoe,const vector<Double>& iexp, const Double* A,
+			const Int& jnp,const vector<Double>& jcoe,const vector<Double>& jexp, const Double* B,
+			const Int& knp,const vector<Double>& kcoe,const vector<Double>& kexp, const Double* C,
+			const Int& lnp,const vector<Double>& lcoe,const vector<Double>& lexp, const Double* D);
+
+	/**
+	 * test the ERI variants with the significant pair lists (sig_kernels)
+	 * with the full lists the result is compared with the plain function;
+	 * with the partial lists, which drop a pair on bra and ket, it is compared
+	 * with the plain function where the dropped pairs have zero coefficients
+		 * \param maxl : the maximum angular momentum for testing
+		 * \param inp  : contraction degree for shell i
+	 * \param icoe : coefficient array  for shell i
+	 * \param iexp : exponetial factors for shell i
+	 * \param A    : center for shell i
+	 * \param jnp  : contraction degree for shell j
+	 * \param jcoe : coefficient array  for shell j
+	 * \param jexp : exponetial factors for shell j
+	 * \param B    : center for shell j
+	 * \param knp  : contraction degree for shell k
+	 * \param kcoe : coefficient array  for shell k
+	 * \param kexp : exponetial factors for shell k
+	 * \param C    : center for shell k
+	 * \param lnp  : contraction degree for shell l
+	 * \param lcoe : coefficient array  for shell l
+	 * \param lexp : exponetial factors for shell l
+	 * \param D    : center for shell l
+	 */
+	void sig_test(const Int& maxL,
+			const Int& inp,const vector<Double>& icoe,const vector<Double>& iexp, const Double* A,
+			const Int& jnp,const vector<Double>& jcoe,const vector<Double>& jexp, const Double* B,
+			const Int& knp,const vector<Double>& kcoe,const vector<Double>& kexp, const Double* C,
+			const Int& lnp,const vector<Double>& lcoe,const vector<Double>& lexp, const Double* D);
+
+	/**
+	 * test the shell pair records and the ERI variants taking them (pair_kernels)
+	 * the records formed by ShellPair::build are checked against the pair data
+	 * of the plain functions, and the result of the variant taking the records
+	 * is compared with the plain function
+		 * \param maxl : the maximum angular momentum for testing
+		 * \param inp  : contraction degree for shell i
+	 * \param icoe : coefficient array  for shell i
+	 * \param iexp : exponetial factors for shell i
+	 * \param A    : center for shell i
+	 * \param jnp  : contraction degree for shell j
+	 * \param jcoe : coefficient array  for shell j
+	 * \param jexp : exponetial factors for shell j
+	 * \param B    : center for shell j
+	 * \param knp  : contraction degree for shell k
+	 * \param kcoe : coefficient array  for shell k
+	 * \param kexp : exponetial factors for shell k
+	 * \param C    : center for shell k
+	 * \param lnp  : contraction degree for shell l
+	 * \param lcoe : coefficient array  for shell l
+	 * \param lexp : exponetial factors for shell l
+	 * \param D    : center for shell l
+	 */
+	void pair_test(const Int& maxL,
+			const Int& inp,const vector<Double>& icoe,const vector<Double>& iexp, const Double* A,
+			const Int& jnp,const vector<Double>& jcoe,const vector<Double>& jexp, const Double* B,
+			const Int& knp,const vector<Double>& kcoe,const vector<Double>& kexp, const Double* C,
+			const Int& lnp,const vector<Double>& lcoe,const vector<Double>& lexp, const Double* D);
+
+	/**
+	 * test the ERI variants for a list of kets (kets_kernels)
+	 * one bra is calculated with three kets on different centers and with
+	 * different shell data, the block abcdKets+i*nInts is compared with the
+	 * plain function for the ket i
+		 * \param maxl : the maximum angular momentum for testing
+		 * \param inp  : contraction degree for shell i
+	 * \param icoe : coefficient array  for shell i
+	 * \param iexp : exponetial factors for shell i
+	 * \param A    : center for shell i
+	 * \param jnp  : contraction degree for shell j
+	 * \param jcoe : coefficient array  for shell j
+	 * \param jexp : exponetial factors for shell j
+	 * \param B    : center for shell j
+	 * \param knp  : contraction degree for shell k
+	 * \param kcoe : coefficient array  for shell k
+	 * \param kexp : exponetial factors for shell k
+	 * \param C    : center for shell k
+	 * \param lnp  : contraction degree for shell l
+	 * \param lcoe : coefficient array  for shell l
+	 * \param lexp : exponetial factors for shell l
+	 * \param D    : center for shell l
+	 */
+	void kets_test(const Int& maxL,
+			const Int& inp,const vector<Double>& icoe,const vector<Double>& iexp, const Double* A,
+			const Int& jnp,const vector<Double>& jcoe,const vector<Double>& jexp, const Double* B,
+			const Int& knp,const vector<Double>& kcoe,const vector<Double>& kexp, const Double* C,
+			const Int& lnp,const vector<Double>& lcoe,const vector<Double>& lexp, const Double* D);
+
+	/**
+	 * test the ERI variants for the operator erf(omega*r12)/r12 (erf_kernels)
+	 * the shell quartets are calculated through the registry entry function
+	 * with the given omega, so the entry picks up the variant; the result is
+	 * compared with the significant pair list variant with full lists, which
+	 * takes omega at run time
+		 * \param maxl : the maximum angular momentum for testing
+	 * \param omega: the range separation parameter
+		 * \param inp  : contraction degree for shell i
+	 * \param icoe : coefficient array  for shell i
+	 * \param iexp : exponetial factors for shell i
+	 * \param A    : center for shell i
+	 * \param jnp  : contraction degree for shell j
+	 * \param jcoe : coefficient array  for shell j
+	 * \param jexp : exponetial factors for shell j
+	 * \param B    : center for shell j
+	 * \param knp  : contraction degree for shell k
+	 * \param kcoe : coefficient array  for shell k
+	 * \param kexp : exponetial factors for shell k
+	 * \param C    : center for shell k
+	 * \param lnp  : contraction degree for shell l
+	 * \param lcoe : coefficient array  for shell l
+	 * \param lexp : exponetial factors for shell l
+	 * \param D    : center for shell l
+	 */
+	void erf_test(const Int& maxL, const Double& omega,
+			const Int& inp,const vector<Double>& icoe,const vector<Double>& iexp, const Double* A,
+			const Int& jnp,const vector<Double>& jcoe,const vector<Double>& jexp, const Double* B,
+			const Int& knp,const vector<Double>& kcoe,const vector<Double>& kexp, const Double* C,
+			const Int& lnp,const vector<Double>& lcoe,const vector<Double>& lexp, const Double* D);
+
+	/**
+	 * test the range separated ERI variants (rs_kernels)
+	 * the variant is called with (coulFac,erfFac) = (1,0), (0,1) and (1,-1),
+	 * and compared with the same combination of the 1/r12 and the
+	 * erf(omega*r12)/r12 results from the registry entry function
+		 * \param maxl : the maximum angular momentum for testing
+	 * \param omega: the range separation parameter
+		 * \param inp  : contraction degree for shell i
+	 * \param icoe : coefficient array  for shell i
+	 * \param iexp : exponetial factors for shell i
+	 * \param A    : center for shell i
+	 * \param jnp  : contraction degree for shell j
+	 * \param jcoe : coefficient array  for shell j
+	 * \param jexp : exponetial factors for shell j
+	 * \param B    : center for shell j
+	 * \param knp  : contraction degree for shell k
+	 * \param kcoe : coefficient array  for shell k
+	 * \param kexp : exponetial factors for shell k
+	 * \param C    : center for shell k
+	 * \param lnp  : contraction degree for shell l
+	 * \param lcoe : coefficient array  for shell l
+	 * \param lexp : exponetial factors for shell l
+	 * \param D    : center for shell l
+	 */
+	void rs_test(const Int& maxL, const Double& omega,
+			const Int& inp,const vector<Double>& icoe,const vector<Double>& iexp, const Double* A,
+			const Int& jnp,const vector<Double>& jcoe,const vector<Double>& jexp, const Double* B,
+			const Int& knp,const vector<Double>& kcoe,const vector<Double>& kexp, const Double* C,
+			const Int& lnp,const vector<Double>& lcoe,const vector<Double>& lexp, const Double* D);
+
+	/**
+	 * test the RR bytecode interpreter (rr_bytecode = true, see rrinterp.h)
+	 * for the shell quartets without composite shells, the program loaded by
+	 * getRRProgram is compared with the compiled function for 1/r12, and
+	 * with the registry entry function for erf(omega*r12)/r12. The bytecode
+	 * files are searched in the directory given by CPPINTS_RRB_PATH
+		 * \param maxl : the maximum angular momentum for testing
+	 * \param omega: the range separation parameter
+		 * \param inp  : contraction degree for shell i
+	 * \param icoe : coefficient array  for shell i
+	 * \param iexp : exponetial factors for shell i
+	 * \param A    : center for shell i
+	 * \param jnp  : contraction degree for shell j
+	 * \param jcoe : coefficient array  for shell j
+	 * \param jexp : exponetial factors for shell j
+	 * \param B    : center for shell j
+	 * \param knp  : contraction degree for shell k
+	 * \param kcoe : coefficient array  for shell k
+	 * \param kexp : exponetial factors for shell k
+	 * \param C    : center for shell k
+	 * \param lnp  : contraction degree for shell l
+	 * \param lcoe : coefficient array  for shell l
+	 * \param lexp : exponetial factors for shell l
+	 * \param D    : center for shell l
+	 */
+	void rrinterp_test(const Int& maxL, const Double& omega,
+			const Int& inp,const vector<Double>& icoe,const vector<Double>& iexp, const Double* A,
+			const Int& jnp,const vector<Double>& jcoe,const vector<Double>& jexp, const Double* B,
+			const Int& knp,const vector<Double>& kcoe,const vector<Double>& kexp, const Double* C,
+			const Int& lnp,const vector<Double>& lcoe,const vector<Double>& lexp, const Double* D);
+}
+
+#endif
@@ -0,0 +1,367 @@
+/**
+ * \file    rrinterp.h
+ * \author  Fenglai Liu and Jing Kong
+ */
+#ifndef RRINTERP_H
+#define RRINTERP_H
+#include "libgen.h"
+#include "constants.h"
+#include <map>
+#include <mutex>
+#include <stdint.h>
+
+/**
+ * the environment variable giving the folder of the bytecode files
+ * (rr_bytecode = true in generation), if it's not set the files are
+ * searched in the current folder
+ */
+#define RR_BYTECODE_PATH_ENV   "CPPINTS_RRB_PATH"
+
+/**
+ * the layout of bytecode, must be same with src/include/rrbytecode.h
+ */
+#define RR_BYTECODE_MAGIC      0x43425252
+#define RR_BYTECODE_VERSION    1
+
+/**
+ * number of primitive quartets processed together in the VRR, the
+ * inner loops of the interpreter run over them
+ */
+#define RR_INTERP_BATCH        8
+
+namespace rrinterp {
+
+	/**
+	 * the symbols of RR coefficients, the position in the list is the
+	 * symbol code in the bytecode (see RR_SYMBOLS in src/rrbytecode.cpp)
+	 */
+	enum RRSymbol {
+		SYM_ONE,
+		SYM_PAX, SYM_PAY, SYM_PAZ, SYM_PBX, SYM_PBY, SYM_PBZ,
+		SYM_QCX, SYM_QCY, SYM_QCZ, SYM_QDX, SYM_QDY, SYM_QDZ,
+		SYM_WPX, SYM_WPY, SYM_WPZ, SYM_WQX, SYM_WQY, SYM_WQZ,
+		SYM_ONED2Z, SYM_ONED2E, SYM_ONED2K, SYM_RHOD2ZSQ, SYM_RHOD2ESQ,
+		SYM_ABX, SYM_ABY, SYM_ABZ, SYM_CDX, SYM_CDY, SYM_CDZ,
+		N_RR_SYMBOLS
+	};
+
+	/**
+	 * \class   RRProgram
+	 * \brief   run the RR program of one ERI shell quartet from its bytecode
+	 *
+	 * The bytecode is written by the generator with rr_bytecode = true,
+	 * one .rrb file next to each integral function. It records the
+	 * planned bottom integrals, VRR steps, contraction, HRR steps and
+	 * the output positions; here we execute them so that the rarely used
+	 * shell quartets do not need to be compiled into the library.
+	 *
+	 * The eri() function takes the same arguments as the generated
+	 * function, and follows the same procedure: the primitive quartets
+	 * failing the significance test are skipped, and if none of them
+	 * is significant the abcd is not touched. For the shell quartets
+	 * without HRR the results are accumulated into abcd, else they are
+	 * assigned.
+	 *
+	 * The significant primitive quartets are processed in batch of
+	 * RR_INTERP_BATCH; each slot keeps its values for the whole batch
+	 * and each RR term is a loop over the batch, which the compiler
+	 * vectorizes. The contraction is summed in the same order as the
+	 * generated code does.
+	 */
+	class RRProgram {
+
+		private:
+
+			string name;               ///< name of the program, for error message
+			Int nInts;                 ///< number of result integrals
+			Int nPrimSlots;            ///< number of primitive slots
+			Int nContSlots;            ///< number of contracted slots
+			Int maxM;                  ///< max M value of bottom integrals
+			vector<int32_t> bottom;    ///< bottom section
+			vector<int32_t> vrr;       ///< VRR section
+			vector<int32_t> cont;      ///< contraction section
+			vector<int32_t> hrr;       ///< HRR section
+			vector<int32_t> output;    ///< output section
+
+			/**
+			 * the Boys function F_m(u) for m = 0 to maxM. Below 1.8
+			 * (or for large M with u not large enough) we use the power
+			 * series for F_{maxM} and down recursion, else the erf
+			 * with up recursion
+			 */
+			void boys(const Double& u, Double* F) const {
+				if (u > 1.8E0 && (maxM <= 10 || u > 2.0E0*maxM)) {
+					Double squ = sqrt(u);
+					Double eu  = exp(-u);
+					F[0] = HALF*sqrt(PI)*erf(squ)/squ;
+					Double oneO2u = HALF/u;
+					for(Int m=1; m<=maxM; m++) {
+						F[m] = oneO2u*((2*m-1)*F[m-1]-eu);
+					}
+					return;
+				}
+				Double eu   = exp(-u);
+				Double u2   = TWO*u;
+				Double term = ONE/(2*maxM+1);
+				Double sum  = term;
+				for(Int k=1; k<1000; k++) {
+					term = term*u2/(2*maxM+2*k+1);
+					sum  = sum+term;
+					if (term < 1.0E-17*sum) break;
+				}
+				F[maxM] = eu*sum;
+				for(Int m=maxM-1; m>=0; m--) {
+					F[m] = (u2*F[m+1]+eu)/(2*m+1);
+				}
+			};
+
+			/**
+			 * run the steps on the registers with the given batch length
+			 * NB; the symbols are in sym[symbol*symStride+b]
+			 */
+			template<UInt NB> static void runSteps(const vector<int32_t>& code,
+					const Double* sym, const UInt& symStride, Double* reg) {
+				UInt pos = 0;
+				while(pos < code.size()) {
+					Double* lhs  = &reg[code[pos]*NB];
+					Int nTerms   = code[pos+1];
+					pos += 2;
+					for(UInt b=0; b<NB; b++) lhs[b] = ZERO;
+					for(Int t=0; t<nTerms; t++, pos+=3) {
+						const Double* s = &sym[code[pos]*symStride];
+						const Double  m = code[pos+1];
+						const Double* r = &reg[code[pos+2]*NB];
+						for(UInt b=0; b<NB; b++) lhs[b] += m*s[b]*r[b];
+					}
+				}
+			};
+
+			RRProgram(const RRProgram& p);
+			RRProgram& operator=(const RRProgram& p);
+
+		public:
+
+			/**
+			 * load the program from the bytecode file
+			 */
+			RRProgram(const string& file):name(file),nInts(0),nPrimSlots(0),
+			nContSlots(0),maxM(0) {
+
+				// read in all of words
+				ifstream in(file.c_str(),std::ios::binary);
+				if (! in) crash(true,"RRProgram can not open the bytecode file " + file);
+				vector<int32_t> words;
+				int32_t w = 0;
+				while(in.read(reinterpret_cast<char*>(&w),sizeof(int32_t))) words.push_back(w);
+				if (words.size() < 11 || words[0] != RR_BYTECODE_MAGIC) {
+					crash(true,"RRProgram: not a valid bytecode file " + file);
+				}
+				if (words[1] != RR_BYTECODE_VERSION) {
+					crash(true,"RRProgram: the bytecode version does not match in " + file);
+				}
+				nInts      = words[2];
+				nPrimSlots = words[3];
+				nContSlots = words[4];
+				maxM       = words[5];
+
+				// now the sections
+				vector<int32_t>* sections[] = {&bottom, &vrr, &cont, &hrr, &output};
+				UInt pos = 6;
+				for(UInt i=0; i<5; i++) {
+					if (pos >= words.size() || pos+1+words[pos] > words.size()) {
+						crash(true,"RRProgram: the bytecode file is truncated " + file);
+					}
+					UInt len = words[pos];
+					sections[i]->assign(words.begin()+pos+1,words.begin()+pos+1+len);
+					pos += 1+len;
+				}
+				if ((Int)bottom.size() != maxM+1 || (Int)output.size() != 2*nInts) {
+					crash(true,"RRProgram: the bytecode file is corrupted " + file);
+				}
+			};
+
+			~RRProgram() { };
+
+			/**
+			 * number of result integrals
+			 */
+			Int getNInts() const { return nInts; };
+
+			/**
+			 * calculate the ERI, the arguments are same with the generated
+			 * integral function (e.g. hgp_os_eri_d_p_p_s)
+			 */
+			void eri(const UInt& inp2, const UInt& jnp2, const Double& pMax, const Double& omega,
+					const Double* icoe, const Double* iexp, const Double* ifac, const Double* P,
+					const Double* A, const Double* B, const Double* jcoe, const Double* jexp,
+					const Double* jfac, const Double* Q, const Double* C, const Double* D,
+					Double* abcd) const {
+
+				const UInt NB = RR_INTERP_BATCH;
+				bool withErfR12 = false;
+				if (fabs(omega)>THRESHOLD_MATH) withErfR12 = true;
+
+				// working space, kept for the thread and only grown. Each
+				// register is written before it's read (the bottom integrals
+				// are assigned, and the VRR/HRR steps clear their lhs), so
+				// they are not initialized here
+				static thread_local vector<Double> sym;
+				static thread_local vector<Double> reg;
+				static thread_local vector<Double> contReg;
+				static thread_local vector<Double> F;
+				static thread_local vector<UInt>   pairs;
+				if (sym.size() < N_RR_SYMBOLS*NB) sym.resize(N_RR_SYMBOLS*NB);
+				if (reg.size() < nPrimSlots*NB) reg.resize(nPrimSlots*NB);
+				if (contReg.size() < (UInt)nContSlots) contReg.resize(nContSlots);
+				if (F.size() < (UInt)maxM+1) F.resize(maxM+1);
+				pairs.clear();
+
+				// the significant primitive quartets, in the same order
+				// as the loops in generated code
+				for(UInt ip2=0; ip2<inp2; ip2++) {
+					for(UInt jp2=0; jp2<jnp2; jp2++) {
+						Double ic2  = icoe[ip2];
+						Double jc2  = jcoe[jp2];
+						Double pref = ifac[ip2]*jfac[jp2];
+						Double test = pref;
+						if (fabs(ic2*jc2)>ONE) test = ic2*jc2*pref;
+						if (fabs(test*pMax)<THRESHOLD_MATH) continue;
+						pairs.push_back(ip2);
+						pairs.push_back(jp2);
+					}
+				}
+				if (pairs.size() == 0) return;
+
+				// only the contracted integrals are accumulated
+				for(UInt i=0; i<cont.size(); i+=2) contReg[cont[i]] = ZERO;
+
+				// the HRR coefficients are same for all of batches
+				Double* s = &sym[0];
+				for(UInt b=0; b<NB; b++) {
+					s[SYM_ONE*NB+b] = ONE;
+					for(UInt x=0; x<3; x++) {
+						s[(SYM_ABX+x)*NB+b] = A[x]-B[x];
+						s[(SYM_CDX+x)*NB+b] = C[x]-D[x];
+					}
+				}
+
+				// now the batches
+				UInt nPairs = pairs.size()/2;
+				for(UInt start=0; start<nPairs; start+=NB) {
+
+					// the tail batch is padded with the last quartet,
+					// it's not added into the contraction
+					UInt nb = nPairs-start < NB ? nPairs-start : NB;
+					for(UInt b=0; b<NB; b++) {
+						UInt k      = b < nb ? start+b : start+nb-1;
+						UInt ip2    = pairs[2*k];
+						UInt jp2    = pairs[2*k+1];
+						Double onedz = iexp[ip2];
+						Double onede = jexp[jp2];
+						Double prefactor = icoe[ip2]*jcoe[jp2]*(ifac[ip2]*jfac[jp2]);
+						const Double* PP = &P[3*ip2];
+						const Double* QQ = &Q[3*jp2];
+						Double rho   = ONE/(onedz+onede);
+						Double sqrho = sqrt(rho);
+						Double PQ2   = (PP[0]-QQ[0])*(PP[0]-QQ[0])+(PP[1]-QQ[1])*(PP[1]-QQ[1])+
+							(PP[2]-QQ[2])*(PP[2]-QQ[2]);
+						Double u     = rho*PQ2;
+						if (withErfR12) u = PQ2/(ONE/(omega*omega)+ONE/rho);
+						for(UInt x=0; x<3; x++) {
+							Double W = rho*(PP[x]*onede+QQ[x]*onedz);
+							s[(SYM_PAX+x)*NB+b] = PP[x]-A[x];
+							s[(SYM_PBX+x)*NB+b] = PP[x]-B[x];
+							s[(SYM_QCX+x)*NB+b] = QQ[x]-C[x];
+							s[(SYM_QDX+x)*NB+b] = QQ[x]-D[x];
+							s[(SYM_WPX+x)*NB+b] = W-PP[x];
+							s[(SYM_WQX+x)*NB+b] = W-QQ[x];
+						}
+						Double oned2z = HALF*onedz;
+						Double oned2e = HALF*onede;
+						s[SYM_ONED2Z*NB+b]   = oned2z;
+						s[SYM_ONED2E*NB+b]   = oned2e;
+						s[SYM_ONED2K*NB+b]   = HALF*rho*onede*onedz;
+						s[SYM_RHOD2ZSQ*NB+b] = rho*oned2z*onedz;
+						s[SYM_RHOD2ESQ*NB+b] = rho*oned2e*onede;
+
+						// bottom integrals
+						boys(u,&F[0]);
+						Double f = TWOOVERSQRTPI*prefactor*sqrho;
+						Double erfp2 = ONE;
+						Double erfPref = ONE;
+						if (withErfR12) {
+							erfp2   = ONE/(ONE+rho/(omega*omega));
+							erfPref = sqrt(erfp2);
+						}
+						for(Int m=0; m<=maxM; m++) {
+							if (bottom[m] >= 0) reg[bottom[m]*NB+b] = f*F[m]*erfPref;
+							erfPref *= erfp2;
+						}
+					}
+
+					// VRR and contraction
+					runSteps<NB>(vrr,&sym[0],NB,&reg[0]);
+					for(UInt i=0; i<cont.size(); i+=2) {
+						const Double* r = &reg[cont[i+1]*NB];
+						Double& c = contReg[cont[i]];
+						for(UInt b=0; b<nb; b++) c += r[b];
+					}
+				}
+
+				// HRR works on the contracted integrals
+				runSteps<1>(hrr,&sym[0],NB,&contReg[0]);
+
+				// output
+				bool withHRR = hrr.size() > 0;
+				for(UInt i=0; i<output.size(); i+=2) {
+					if (withHRR) {
+						abcd[output[i]]  = contReg[output[i+1]];
+					}else{
+						abcd[output[i]] += contReg[output[i+1]];
+					}
+				}
+			};
+	};
+
+	/**
+	 * get the program for the given integral function name, e.g.
+	 * hgp_os_eri_d_p_p_s. The bytecode is loaded the first time it's
+	 * used, from the folder given by CPPINTS_RRB_PATH. The caller decides
+	 * per shell quartet whether to call the native function or this one
+	 */
+	inline const RRProgram& getRRProgram(const string& funcName) {
+
+		// the programs a thread has got are kept in its own map, so the
+		// lock is only taken for the first lookup of each program in a
+		// thread, the later ones are free of lock
+		static thread_local std::map<string,const RRProgram*> threadPrograms;
+		std::map<string,const RRProgram*>::const_iterator pos = threadPrograms.find(funcName);
+		if (pos != threadPrograms.end()) return *(pos->second);
+
+		// now look it up in the programs loaded by all of threads
+		static std::mutex lock;
+		static std::map<string,RRProgram*> programs;
+		const RRProgram* p = NULL;
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			std::map<string,RRProgram*>::const_iterator it = programs.find(funcName);
+			if (it != programs.end()) {
+				p = it->second;
+			}else{
+				string file = funcName + ".rrb";
+				const char* dir = getenv(RR_BYTECODE_PATH_ENV);
+				if (dir != NULL && dir[0] != '\0') {
+					file = string(dir) + "/" + file;
+				}
+				RRProgram* program = new RRProgram(file);
+				programs[funcName] = program;
+				p = program;
+			}
+		}
+		threadPrograms[funcName] = p;
+		return *p;
+	};
+
+}
+
+#endif
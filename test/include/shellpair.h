@@ -0,0 +1,155 @@
+/**
+ * \file    shellpair.h
+ * \author  Fenglai Liu and Jing Kong
+ */
+#ifndef SHELLPAIR_H
+#define SHELLPAIR_H
+#include <cstddef>
+#include <cmath>
+#include <vector>
+#include "constants.h"
+
+namespace shellpair {
+
+	/**
+	 * \class   ShellPair
+	 * \brief   the primitive pair data of a shell pair taken by the name_pair variants
+	 *
+	 * For a shell pair (A,B) with the primitive exponents a_i and b_j, each
+	 * primitive pair is a Gaussian on P with the exponent zeta = a_i+b_j. The
+	 * plain kernels take 1/zeta, the prefactor and P for each pair, and the
+	 * other quantities (PA, PB, 1/(2zeta), alpha and beta etc.) are formed
+	 * again inside the primitive loop on every call. Here all of them are
+	 * computed once and kept in the SoA form, one array for each quantity.
+	 *
+	 * The data only depends on the basis set and the geometry, so the pair
+	 * could be built once and used by all of the integral calls over the
+	 * SCF iterations. Calling build again for a new geometry reuses the
+	 * memory of the arrays.
+	 *
+	 * The pairs are in the same order as the plain kernels take (the ip
+	 * runs faster): the pair of ip and jp is ip+jp*inp
+	 */
+	template<typename T>
+	class ShellPair {
+
+		public:
+
+			size_t n;                ///< number of primitive pairs
+			size_t nCoe;             ///< number of coefficient columns (larger than 1 for composite shells)
+			T A[3];                  ///< the center of the first shell
+			T B[3];                  ///< the center of the second shell
+			std::vector<T> coe;      ///< the pair coefficients, column i is coe[i*n .. (i+1)*n)
+			std::vector<T> alpha;    ///< the exponent of the primitive on A
+			std::vector<T> beta;     ///< the exponent of the primitive on B
+			std::vector<T> zeta;     ///< alpha+beta
+			std::vector<T> oned;     ///< 1/zeta
+			std::vector<T> oned2z;   ///< 1/(2zeta)
+			std::vector<T> fac;      ///< exp(-alpha*beta/zeta*AB2)*(pi/zeta)^{3/2}
+			std::vector<T> PX;       ///< P = (alpha*A+beta*B)/zeta
+			std::vector<T> PY;       ///< P on y
+			std::vector<T> PZ;       ///< P on z
+			std::vector<T> PAX;      ///< P-A on x
+			std::vector<T> PAY;      ///< P-A on y
+			std::vector<T> PAZ;      ///< P-A on z
+			std::vector<T> PBX;      ///< P-B on x
+			std::vector<T> PBY;      ///< P-B on y
+			std::vector<T> PBZ;      ///< P-B on z
+
+			/**
+			 * constructor - the pair is empty until it's built
+			 */
+			ShellPair():n(0),nCoe(0) {
+				for(int i=0; i<3; i++) {
+					A[i] = T(0);
+					B[i] = T(0);
+				}
+			};
+
+			/**
+			 * form the pair data for the shell on A with the exponents
+			 * iexp[0..inp) and the shell on B with jexp[0..jnp). The pair
+			 * coefficients are formed by the caller (nCoe columns of
+			 * inp*jnp, in the same form as the icoe of plain kernels),
+			 * since for the composite shells they depend on the angular
+			 * momentum combination.
+			 *
+			 * Only the exponents are formed pair by pair, the rest is done
+			 * in the loops over all of pairs without branches so that the
+			 * compiler could vectorize them.
+			 */
+			void build(const size_t& inp, const T* iexp, const T* A0,
+					const size_t& jnp, const T* jexp, const T* B0,
+					const size_t& nCoe0, const T* coe0) {
+
+				// the dimension and the centers
+				n    = inp*jnp;
+				nCoe = nCoe0;
+				for(int i=0; i<3; i++) {
+					A[i] = A0[i];
+					B[i] = B0[i];
+				}
+				coe.assign(coe0,coe0+nCoe*n);
+				alpha.resize(n);
+				beta.resize(n);
+				zeta.resize(n);
+				oned.resize(n);
+				oned2z.resize(n);
+				fac.resize(n);
+				PX.resize(n);
+				PY.resize(n);
+				PZ.resize(n);
+				PAX.resize(n);
+				PAY.resize(n);
+				PAZ.resize(n);
+				PBX.resize(n);
+				PBY.resize(n);
+				PBZ.resize(n);
+
+				// exponents
+				for(size_t jp=0; jp<jnp; jp++) {
+					for(size_t ip=0; ip<inp; ip++) {
+						alpha[ip+jp*inp] = iexp[ip];
+						beta[ip+jp*inp]  = jexp[jp];
+					}
+				}
+
+				// the exponent of the pair
+				const T AB2 = (A[0]-B[0])*(A[0]-B[0])+(A[1]-B[1])*(A[1]-B[1])+(A[2]-B[2])*(A[2]-B[2]);
+				for(size_t i=0; i<n; i++) {
+					zeta[i]   = alpha[i]+beta[i];
+					oned[i]   = T(1)/zeta[i];
+					oned2z[i] = T(0.5)*oned[i];
+				}
+
+				// prefactor, (pi/zeta)^{3/2} is formed with sqrt
+				for(size_t i=0; i<n; i++) {
+					T x    = T(PI)*oned[i];
+					fac[i] = std::exp(-alpha[i]*beta[i]*oned[i]*AB2)*x*std::sqrt(x);
+				}
+
+				// the new center and its distance to A and B
+				for(size_t i=0; i<n; i++) {
+					PX[i] = (alpha[i]*A[0]+beta[i]*B[0])*oned[i];
+					PY[i] = (alpha[i]*A[1]+beta[i]*B[1])*oned[i];
+					PZ[i] = (alpha[i]*A[2]+beta[i]*B[2])*oned[i];
+				}
+				for(size_t i=0; i<n; i++) {
+					PAX[i] = PX[i]-A[0];
+					PAY[i] = PY[i]-A[1];
+					PAZ[i] = PZ[i]-A[2];
+					PBX[i] = PX[i]-B[0];
+					PBY[i] = PY[i]-B[1];
+					PBZ[i] = PZ[i]-B[2];
+				}
+			};
+
+			/**
+			 * destructor
+			 */
+			~ShellPair() { };
+	};
+
+}
+
+#endif
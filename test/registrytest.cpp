@@ -0,0 +1,828 @@
+#include <algorithm>
+#include "libgen.h"
+#include "angmomlist.h"
+#include "shellprop.h"
+#include "localmemscr.h"
+#include "rrinterp.h"
+#include "registrytest.h"
+#include "hgp_os_eri.h"
+#include "hgp_os_eri_gc.h"
+#include "hgp_os_eri_sig.h"
+#include "hgp_os_eri_pair.h"
+#include "hgp_os_eri_kets.h"
+#include "hgp_os_eri_rs.h"
+using namespace shellprop;
+using namespace localmemscr;
+using namespace shellpair;
+using namespace rrinterp;
+using namespace registrytest;
+
+// the integral functions generated with scr_source = argument take the
+// scr as the last argument (see the eritest.cpp), with thread_local they
+// take the scr of the calling thread by themselves
+#ifdef WITH_THREAD_LOCAL_SCR
+#define KERNEL_SCR
+#else
+#define KERNEL_SCR ,threadLocalMemScr(1944810)
+#endif
+
+/**
+ * the primitive pair data of a shell pair (i,j), in the form taken by
+ * the plain integral functions; same with the one formed in eritest
+ */
+class PairData {
+
+	public:
+
+		UInt np2;                ///< number of primitive pairs
+		Double A[3];             ///< center of shell i
+		Double B[3];             ///< center of shell j
+		vector<Double> oned;     ///< 1/(alpha+beta) for each pair
+		vector<Double> fac;      ///< the prefactor for each pair
+		vector<Double> P;        ///< the new center for each pair
+
+		PairData(const Int& inp, const vector<Double>& iexp, const Double* A0,
+				const Int& jnp, const vector<Double>& jexp, const Double* B0):np2(inp*jnp),
+		oned(np2,ZERO),fac(np2,ZERO),P(3*np2,ZERO) {
+			for(Int i=0; i<3; i++) {
+				A[i] = A0[i];
+				B[i] = B0[i];
+			}
+			Double AB2 = (A[0]-B[0])*(A[0]-B[0])+(A[1]-B[1])*(A[1]-B[1])+(A[2]-B[2])*(A[2]-B[2]);
+			Int count = 0;
+			for(Int jp=0; jp<jnp; jp++) {
+				for(Int ip=0; ip<inp; ip++) {
+					Double ia    = iexp[ip];
+					Double ja    = jexp[jp];
+					Double alpla = ia+ja;
+					Double ab    = -ia*ja/alpla;
+					oned[count]  = ONE/alpla;
+					fac[count]   = exp(ab*AB2)*pow(PI/alpla,1.5E0);
+					for(Int i=0; i<3; i++) {
+						P[3*count+i] = (A[i]*ia + B[i]*ja)/alpla;
+					}
+					count++;
+				}
+			}
+		};
+
+		~PairData() { };
+};
+
+/**
+ * form the coefficients of shell pair (i,j) for the nL angular momentum
+ * combinations (more than one for the composite shells). Since the two
+ * functions compared take the same data, they are simply formed from
+ * the input ones without normalization
+ */
+static void formPairCoe(const Int& nL, const Int& inp, const vector<Double>& icoe,
+		const Int& jnp, const vector<Double>& jcoe, vector<Double>& coe)
+{
+	coe.assign(nL*inp*jnp,ZERO);
+	for(UInt i=0; i<coe.size(); i++) coe[i] = icoe[i%inp]*jcoe[(i/inp)%jnp];
+}
+
+/**
+ * form the coefficients of shell pair (i,j) for nCont contracted functions
+ * of the general contraction, the column k is coe[k*inp*jnp .. (k+1)*inp*jnp).
+ * The column k takes the two halves of the input coefficients in turn, and
+ * it's scaled by 1/(k+1) so that all of columns are different
+ */
+static void formContCoe(const UInt& nCont, const Int& inp, const vector<Double>& icoe,
+		const Int& jnp, const vector<Double>& jcoe, vector<Double>& coe)
+{
+	UInt np2 = inp*jnp;
+	coe.assign(nCont*np2,ZERO);
+	for(UInt k=0; k<nCont; k++) {
+		UInt half = k%2;
+		for(Int jp=0; jp<jnp; jp++) {
+			for(Int ip=0; ip<inp; ip++) {
+				coe[k*np2+ip+jp*inp] = icoe[half*inp+ip]*jcoe[half*jnp+jp]/(k+1);
+			}
+		}
+	}
+}
+
+/**
+ * all of normal ERI shell quartets up to maxL, in the same order of
+ * eritest; together with the number of angular momentum combinations
+ * on the bra and ket side
+ */
+static void formQuartetList(const Int& maxL, vector<LInt>& LCodeList,
+		vector<Int>& nLBraList, vector<Int>& nLKetList)
+{
+	for(Int n2=0; n2<MAX_SHELL_PAIR_NUMBER; n2++) {
+		for(Int n1=n2; n1<MAX_SHELL_PAIR_NUMBER; n1++) {
+			Int iLmin, iLmax, jLmin, jLmax;
+			Int kLmin, kLmax, lLmin, lLmax;
+			decodeSQ(SHELL_PAIR_ORDER_ARRAY[n1],iLmin,iLmax,jLmin,jLmax);
+			decodeSQ(SHELL_PAIR_ORDER_ARRAY[n2],kLmin,kLmax,lLmin,lLmax);
+			if (iLmax>maxL || jLmax>maxL || kLmax>maxL || lLmax>maxL) continue;
+			Int L1 = codeL(iLmin,iLmax);
+			Int L2 = codeL(jLmin,jLmax);
+			Int L3 = codeL(kLmin,kLmax);
+			Int L4 = codeL(lLmin,lLmax);
+			if (! doTheIntegral(L1,L2,L3,L4)) continue;
+			LCodeList.push_back(codeSQ(L1,L2,L3,L4));
+			nLBraList.push_back((iLmax-iLmin+1)*(jLmax-jLmin+1));
+			nLKetList.push_back((kLmax-kLmin+1)*(lLmax-lLmin+1));
+		}
+	}
+}
+
+/**
+ * the entry of plain ERI registry for the LCode, NULL if the
+ * function is not generated
+ */
+static const hgp_os_eri_entry* eriEntry(const LInt& LCode)
+{
+	UInt index = hgp_os_eri_index(LCode);
+	if (index >= HGP_OS_ERI_REGISTRY_SIZE) return NULL;
+	if (hgp_os_eri_registry[index].func == NULL) return NULL;
+	return &hgp_os_eri_registry[index];
+}
+
+/**
+ * calculate the shell quartet with the given plain function
+ */
+static void plainERI(const hgp_os_eri_func& func, const Double& omega,
+		const PairData& bra, const vector<Double>& braCoe,
+		const PairData& ket, const vector<Double>& ketCoe, vector<Double>& abcd)
+{
+	Double pmax = ONE;
+	func(bra.np2,ket.np2,pmax,omega,
+			&braCoe.front(),&bra.oned.front(),&bra.fac.front(),&bra.P.front(),bra.A,bra.B,
+			&ketCoe.front(),&ket.oned.front(),&ket.fac.front(),&ket.P.front(),ket.A,ket.B,
+			&abcd.front() KERNEL_SCR);
+}
+
+/**
+ * calculate the shell quartet through the registry entry function
+ */
+static void entryERI(const LInt& LCode, const Double& omega,
+		const PairData& bra, const vector<Double>& braCoe,
+		const PairData& ket, const vector<Double>& ketCoe, vector<Double>& abcd)
+{
+	Double pmax = ONE;
+	hgp_os_eri(LCode,bra.np2,ket.np2,pmax,omega,
+			&braCoe.front(),&bra.oned.front(),&bra.fac.front(),&bra.P.front(),bra.A,bra.B,
+			&ketCoe.front(),&ket.oned.front(),&ket.fac.front(),&ket.P.front(),ket.A,ket.B,
+			&abcd.front() KERNEL_SCR);
+}
+
+/**
+ * compare the result of variant with the reference one, the first
+ * integral not matching is printed. Return true if all of them match
+ */
+static bool sameResult(const string& job, const LInt& LCode,
+		const vector<Double>& ref, const vector<Double>& result)
+{
+	for(UInt i=0; i<ref.size(); i++) {
+		if (fabs(ref[i]-result[i])>THRESH) {
+			cout << job << ": result did not match for the LCode " << LCode << endl;
+			cout << "integral index: " << i << endl;
+			printf("difference    : %-16.10f\n", fabs(ref[i]-result[i]));
+			printf("variant value : %-16.10f\n", result[i]);
+			printf("plain value   : %-16.10f\n", ref[i]);
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * print out the summary of the test, crash if any of the shell
+ * quartets does not match
+ */
+static void report(const string& job, const Int& nTested, const Int& nVariant, const Int& nFailed)
+{
+	cout << "number of shell quartets calculated: " << nTested << endl;
+	cout << "number of them done by the variant functions: " << nVariant << endl;
+	cout << "number of shell quartets not matching the plain function: " << nFailed << endl;
+	crash(nFailed>0, "the " + job + " variants do not match the plain functions");
+}
+
+/**
+ * calculate the shell quartet with the operator erf(omega*r12)/r12 by
+ * the significant pair list variant with the full lists. The variants
+ * of other registries test omega at run time even with erf_kernels = true
+ * (then the plain function only does 1/r12), so here it's the reference
+ * for the erf variants. Return false if the function is not generated
+ */
+static bool runtimeOmegaERI(const LInt& LCode, const Double& omega,
+		const PairData& bra, const vector<Double>& braCoe,
+		const PairData& ket, const vector<Double>& ketCoe, vector<Double>& abcd)
+{
+	UInt index = hgp_os_eri_sig_index(LCode);
+	if (index >= HGP_OS_ERI_SIG_REGISTRY_SIZE) return false;
+	const hgp_os_eri_sig_entry& sig = hgp_os_eri_sig_registry[index];
+	if (sig.func == NULL) return false;
+	vector<UInt> iSig(bra.np2);
+	vector<UInt> jSig(ket.np2);
+	for(UInt i=0; i<bra.np2; i++) iSig[i] = i;
+	for(UInt i=0; i<ket.np2; i++) jSig[i] = i;
+	Double pmax = ONE;
+	sig.func(bra.np2,ket.np2,bra.np2,&iSig.front(),ket.np2,&jSig.front(),pmax,omega,
+			&braCoe.front(),&bra.oned.front(),&bra.fac.front(),&bra.P.front(),bra.A,bra.B,
+			&ketCoe.front(),&ket.oned.front(),&ket.fac.front(),&ket.P.front(),ket.A,ket.B,
+			&abcd.front() KERNEL_SCR);
+	return true;
+}
+
+void registrytest::same_center_test(const Int& maxL,
+		const Int& inp, const vector<Double>& icoe, const vector<Double>& iexp, const Double* A,
+		const Int& jnp, const vector<Double>& jcoe, const vector<Double>& jexp, const Double* B,
+		const Int& knp, const vector<Double>& kcoe, const vector<Double>& kexp, const Double* C,
+		const Int& lnp, const vector<Double>& lcoe, const vector<Double>& lexp, const Double* D)
+{
+	cout << "**************************************************************" << endl;
+	cout << "same center ERI variants test:" << endl;
+	cout << "**************************************************************" << endl;
+	vector<LInt> LCodeList;
+	vector<Int> nLBraList;
+	vector<Int> nLKetList;
+	formQuartetList(maxL,LCodeList,nLBraList,nLKetList);
+
+	//
+	// the shell j is moved onto A, and l onto C; each shell keeps
+	// its own exponents so the two shells on one center are different.
+	// the cases are in the order of sameCenter in the registry entry
+	//
+	PairData bra(inp,iexp,A,jnp,jexp,B);
+	PairData ket(knp,kexp,C,lnp,lexp,D);
+	PairData braSame(inp,iexp,A,jnp,jexp,A);
+	PairData ketSame(knp,kexp,C,lnp,lexp,C);
+	const PairData* braList[] = {&braSame, &bra, &braSame};
+	const PairData* ketList[] = {&ket, &ketSame, &ketSame};
+	const string caseList[]   = {"A==B", "C==D", "A==B and C==D"};
+
+	Int nTested  = 0;
+	Int nVariant = 0;
+	Int nFailed  = 0;
+	for(Int iCase=0; iCase<3; iCase++) {
+		for(UInt iSQ=0; iSQ<LCodeList.size(); iSQ++) {
+			LInt LCode = LCodeList[iSQ];
+			const hgp_os_eri_entry* entry = eriEntry(LCode);
+			if (entry == NULL) continue;
+			vector<Double> braCoe;
+			vector<Double> ketCoe;
+			formPairCoe(nLBraList[iSQ],inp,icoe,jnp,jcoe,braCoe);
+			formPairCoe(nLKetList[iSQ],knp,kcoe,lnp,lcoe,ketCoe);
+			vector<Double> ref(entry->nInts,ZERO);
+			vector<Double> result(entry->nInts,ZERO);
+			plainERI(entry->func,ZERO,*braList[iCase],braCoe,*ketList[iCase],ketCoe,ref);
+			entryERI(LCode,ZERO,*braList[iCase],braCoe,*ketList[iCase],ketCoe,result);
+			nTested++;
+			if (entry->sameCenter[iCase] != NULL) nVariant++;
+			if (! sameResult(caseList[iCase],LCode,ref,result)) nFailed++;
+		}
+	}
+	report("same center",nTested,nVariant,nFailed);
+}
+
+void registrytest::symmetry_test(const Int& maxL,
+		const Int& inp, const vector<Double>& icoe, const vector<Double>& iexp, const Double* A,
+		const Int& jnp, const vector<Double>& jcoe, const vector<Double>& jexp, const Double* B,
+		const Int& knp, const vector<Double>& kcoe, const vector<Double>& kexp, const Double* C,
+		const Int& lnp, const vector<Double>& lcoe, const vector<Double>& lexp, const Double* D)
+{
+	cout << "**************************************************************" << endl;
+	cout << "permutational symmetry ERI variants test:" << endl;
+	cout << "**************************************************************" << endl;
+	vector<LInt> LCodeList;
+	vector<Int> nLBraList;
+	vector<Int> nLKetList;
+	formQuartetList(maxL,LCodeList,nLBraList,nLKetList);
+
+	//
+	// the identical shells are formed by taking the same shell twice,
+	// 0 to 3 are the shell i, j, k and l. The cases are in the order 
+	// of symmetry in the registry entry: (aa|aa), (aa|cc), (ab|ab), 
+	// (aa|cd) and (ab|cc)
+	//
+	const Int* npList[]                = {&inp, &jnp, &knp, &lnp};
+	const vector<Double>* coeList[]    = {&icoe, &jcoe, &kcoe, &lcoe};
+	const vector<Double>* expList[]    = {&iexp, &jexp, &kexp, &lexp};
+	const Double* cenList[]            = {A, B, C, D};
+	const Int braShells[5][2]          = {{0,0}, {0,0}, {0,1}, {0,0}, {0,1}};
+	const Int ketShells[5][2]          = {{0,0}, {2,2}, {0,1}, {2,3}, {2,2}};
+	const string caseList[]            = {"(aa|aa)", "(aa|cc)", "(ab|ab)", "(aa|cd)", "(ab|cc)"};
+
+	Int nTested  = 0;
+	Int nVariant = 0;
+	Int nFailed  = 0;
+	for(Int iCase=0; iCase<5; iCase++) {
+		Int i = braShells[iCase][0];
+		Int j = braShells[iCase][1];
+		Int k = ketShells[iCase][0];
+		Int l = ketShells[iCase][1];
+		PairData bra(*npList[i],*expList[i],cenList[i],*npList[j],*expList[j],cenList[j]);
+		PairData ket(*npList[k],*expList[k],cenList[k],*npList[l],*expList[l],cenList[l]);
+		for(UInt iSQ=0; iSQ<LCodeList.size(); iSQ++) {
+			LInt LCode = LCodeList[iSQ];
+			const hgp_os_eri_entry* entry = eriEntry(LCode);
+			if (entry == NULL) continue;
+			vector<Double> braCoe;
+			vector<Double> ketCoe;
+			formPairCoe(nLBraList[iSQ],*npList[i],*coeList[i],*npList[j],*coeList[j],braCoe);
+			formPairCoe(nLKetList[iSQ],*npList[k],*coeList[k],*npList[l],*coeList[l],ketCoe);
+			vector<Double> ref(entry->nInts,ZERO);
+			vector<Double> result(entry->nInts,ZERO);
+			plainERI(entry->func,ZERO,bra,braCoe,ket,ketCoe,ref);
+			entryERI(LCode,ZERO,bra,braCoe,ket,ketCoe,result);
+			nTested++;
+			if (entry->symmetry[iCase] != NULL) nVariant++;
+			if (! sameResult(caseList[iCase],LCode,ref,result)) nFailed++;
+		}
+	}
+	report("symmetry",nTested,nVariant,nFailed);
+}
+
+void registrytest::gc_test(const Int& maxL,
+		const Int& inp, const vector<Double>& icoe, const vector<Double>& iexp, const Double* A,
+		const Int& jnp, const vector<Double>& jcoe, const vector<Double>& jexp, const Double* B,
+		const Int& knp, const vector<Double>& kcoe, const vector<Double>& kexp, const Double* C,
+		const Int& lnp, const vector<Double>& lcoe, const vector<Double>& lexp, const Double* D)
+{
+	cout << "**************************************************************" << endl;
+	cout << "general contraction ERI variants test:" << endl;
+	cout << "**************************************************************" << endl;
+	vector<LInt> LCodeList;
+	vector<Int> nLBraList;
+	vector<Int> nLKetList;
+	formQuartetList(maxL,LCodeList,nLBraList,nLKetList);
+	PairData bra(inp,iexp,A,jnp,jexp,B);
+	PairData ket(knp,kexp,C,lnp,lexp,D);
+
+	//
+	// the number of contracted functions on both sides, they are
+	// different so that the order of blocks is tested, too
+	//
+	const UInt nBraCont = 2;
+	const UInt nKetCont = 3;
+	vector<Double> braCoe;
+	vector<Double> ketCoe;
+	formContCoe(nBraCont,inp,icoe,jnp,jcoe,braCoe);
+	formContCoe(nKetCont,knp,kcoe,lnp,lcoe,ketCoe);
+
+	Int nTested  = 0;
+	Int nFailed  = 0;
+	for(UInt iSQ=0; iSQ<LCodeList.size(); iSQ++) {
+		LInt LCode = LCodeList[iSQ];
+		UInt index = hgp_os_eri_gc_index(LCode);
+		if (index >= HGP_OS_ERI_GC_REGISTRY_SIZE) continue;
+		const hgp_os_eri_gc_entry& gc = hgp_os_eri_gc_registry[index];
+		const hgp_os_eri_entry* entry = eriEntry(LCode);
+		if (gc.func == NULL || entry == NULL) continue;
+
+		// the variant computes all of blocks in one call
+		UInt nInts = gc.nInts;
+		vector<Double> result(nBraCont*nKetCont*nInts,ZERO);
+		Double pmax = ONE;
+		Double omega = ZERO;
+		gc.func(bra.np2,ket.np2,nBraCont,nKetCont,pmax,omega,
+				&braCoe.front(),&bra.oned.front(),&bra.fac.front(),&bra.P.front(),bra.A,bra.B,
+				&ketCoe.front(),&ket.oned.front(),&ket.fac.front(),&ket.P.front(),ket.A,ket.B,
+				&result.front() KERNEL_SCR);
+
+		// the block (k,l) is the plain function with the coefficient
+		// column k on bra and l on ket
+		nTested++;
+		bool failed = false;
+		for(UInt k=0; k<nBraCont; k++) {
+			vector<Double> braCol(braCoe.begin()+k*bra.np2,braCoe.begin()+(k+1)*bra.np2);
+			for(UInt l=0; l<nKetCont; l++) {
+				vector<Double> ketCol(ketCoe.begin()+l*ket.np2,ketCoe.begin()+(l+1)*ket.np2);
+				vector<Double> ref(nInts,ZERO);
+				plainERI(entry->func,ZERO,bra,braCol,ket,ketCol,ref);
+				vector<Double> block(result.begin()+(k*nKetCont+l)*nInts,
+						result.begin()+(k*nKetCont+l+1)*nInts);
+				if (! sameResult("general contraction",LCode,ref,block)) failed = true;
+			}
+		}
+		if (failed) nFailed++;
+	}
+	report("general contraction",nTested,nTested,nFailed);
+}
+
+void registrytest::sig_test(const Int& maxL,
+		const Int& inp, const vector<Double>& icoe, const vector<Double>& iexp, const Double* A,
+		const Int& jnp, const vector<Double>& jcoe, const vector<Double>& jexp, const Double* B,
+		const Int& knp, const vector<Double>& kcoe, const vector<Double>& kexp, const Double* C,
+		const Int& lnp, const vector<Double>& lcoe, const vector<Double>& lexp, const Double* D)
+{
+	cout << "**************************************************************" << endl;
+	cout << "significant pair list ERI variants test:" << endl;
+	cout << "**************************************************************" << endl;
+	vector<LInt> LCodeList;
+	vector<Int> nLBraList;
+	vector<Int> nLKetList;
+	formQuartetList(maxL,LCodeList,nLBraList,nLKetList);
+	PairData bra(inp,iexp,A,jnp,jexp,B);
+	PairData ket(knp,kexp,C,lnp,lexp,D);
+
+	//
+	// the full lists, and the partial lists which drop the second
+	// pair on bra and the last pair on ket
+	//
+	vector<UInt> iFull(bra.np2);
+	vector<UInt> jFull(ket.np2);
+	for(UInt i=0; i<bra.np2; i++) iFull[i] = i;
+	for(UInt i=0; i<ket.np2; i++) jFull[i] = i;
+	UInt iDrop = 1;
+	UInt jDrop = ket.np2-1;
+	vector<UInt> iPart;
+	vector<UInt> jPart;
+	for(UInt i=0; i<bra.np2; i++) {
+		if (i != iDrop) iPart.push_back(i);
+	}
+	for(UInt i=0; i<ket.np2; i++) {
+		if (i != jDrop) jPart.push_back(i);
+	}
+
+	Int nTested  = 0;
+	Int nFailed  = 0;
+	for(UInt iSQ=0; iSQ<LCodeList.size(); iSQ++) {
+		LInt LCode = LCodeList[iSQ];
+		UInt index = hgp_os_eri_sig_index(LCode);
+		if (index >= HGP_OS_ERI_SIG_REGISTRY_SIZE) continue;
+		const hgp_os_eri_sig_entry& sig = hgp_os_eri_sig_registry[index];
+		const hgp_os_eri_entry* entry = eriEntry(LCode);
+		if (sig.func == NULL || entry == NULL) continue;
+		vector<Double> braCoe;
+		vector<Double> ketCoe;
+		formPairCoe(nLBraList[iSQ],inp,icoe,jnp,jcoe,braCoe);
+		formPairCoe(nLKetList[iSQ],knp,kcoe,lnp,lcoe,ketCoe);
+		Double pmax  = ONE;
+		Double omega = ZERO;
+		nTested++;
+
+		// with the full lists it's just the plain function
+		vector<Double> ref(sig.nInts,ZERO);
+		vector<Double> result(sig.nInts,ZERO);
+		plainERI(entry->func,ZERO,bra,braCoe,ket,ketCoe,ref);
+		sig.func(bra.np2,ket.np2,iFull.size(),&iFull.front(),jFull.size(),&jFull.front(),pmax,omega,
+				&braCoe.front(),&bra.oned.front(),&bra.fac.front(),&bra.P.front(),bra.A,bra.B,
+				&ketCoe.front(),&ket.oned.front(),&ket.fac.front(),&ket.P.front(),ket.A,ket.B,
+				&result.front() KERNEL_SCR);
+		bool passed = sameResult("full pair list",LCode,ref,result);
+
+		// for the partial lists, the pairs dropped contribute nothing;
+		// so it's the plain function with their coefficients zeroed
+		// (in all of the columns for the composite shells)
+		vector<Double> braZero(braCoe);
+		vector<Double> ketZero(ketCoe);
+		for(UInt i=iDrop; i<braZero.size(); i+=bra.np2) braZero[i] = ZERO;
+		for(UInt i=jDrop; i<ketZero.size(); i+=ket.np2) ketZero[i] = ZERO;
+		ref.assign(sig.nInts,ZERO);
+		result.assign(sig.nInts,ZERO);
+		plainERI(entry->func,ZERO,bra,braZero,ket,ketZero,ref);
+		sig.func(bra.np2,ket.np2,iPart.size(),&iPart.front(),jPart.size(),&jPart.front(),pmax,omega,
+				&braCoe.front(),&bra.oned.front(),&bra.fac.front(),&bra.P.front(),bra.A,bra.B,
+				&ketCoe.front(),&ket.oned.front(),&ket.fac.front(),&ket.P.front(),ket.A,ket.B,
+				&result.front() KERNEL_SCR);
+		if (! sameResult("partial pair list",LCode,ref,result)) passed = false;
+		if (! passed) nFailed++;
+	}
+	report("significant pair list",nTested,nTested,nFailed);
+}
+
+/**
+ * check the record formed by ShellPair::build against the pair data
+ * taken by the plain functions, return true if they are same
+ */
+static bool checkShellPair(const ShellPair<Double>& pair, const PairData& data,
+		const vector<Double>& coe)
+{
+	if (pair.n != data.np2 || pair.nCoe*pair.n != coe.size() || pair.coe != coe) return false;
+	for(Int i=0; i<3; i++) {
+		if (pair.A[i] != data.A[i] || pair.B[i] != data.B[i]) return false;
+	}
+	for(UInt i=0; i<pair.n; i++) {
+		Double diff = fabs(pair.oned[i]-data.oned[i])+fabs(pair.oned2z[i]-HALF*data.oned[i]);
+		diff += fabs(pair.zeta[i]-(pair.alpha[i]+pair.beta[i]));
+		diff += fabs(pair.fac[i]-data.fac[i]);
+		const Double* P = &data.P[3*i];
+		diff += fabs(pair.PX[i]-P[0])+fabs(pair.PY[i]-P[1])+fabs(pair.PZ[i]-P[2]);
+		diff += fabs(pair.PAX[i]-(P[0]-data.A[0]))+fabs(pair.PAY[i]-(P[1]-data.A[1]))+
+			fabs(pair.PAZ[i]-(P[2]-data.A[2]));
+		diff += fabs(pair.PBX[i]-(P[0]-data.B[0]))+fabs(pair.PBY[i]-(P[1]-data.B[1]))+
+			fabs(pair.PBZ[i]-(P[2]-data.B[2]));
+		if (diff>THRESH) return false;
+	}
+	return true;
+}
+
+void registrytest::pair_test(const Int& maxL,
+		const Int& inp, const vector<Double>& icoe, const vector<Double>& iexp, const Double* A,
+		const Int& jnp, const vector<Double>& jcoe, const vector<Double>& jexp, const Double* B,
+		const Int& knp, const vector<Double>& kcoe, const vector<Double>& kexp, const Double* C,
+		const Int& lnp, const vector<Double>& lcoe, const vector<Double>& lexp, const Double* D)
+{
+	cout << "**************************************************************" << endl;
+	cout << "shell pair record ERI variants test:" << endl;
+	cout << "**************************************************************" << endl;
+	vector<LInt> LCodeList;
+	vector<Int> nLBraList;
+	vector<Int> nLKetList;
+	formQuartetList(maxL,LCodeList,nLBraList,nLKetList);
+	PairData bra(inp,iexp,A,jnp,jexp,B);
+	PairData ket(knp,kexp,C,lnp,lexp,D);
+
+	//
+	// the records are built again for each shell quartet on the same
+	// objects, so that the reuse of memory in build is tested too
+	//
+	ShellPair<Double> braPair;
+	ShellPair<Double> ketPair;
+	Int nTested  = 0;
+	Int nFailed  = 0;
+	for(UInt iSQ=0; iSQ<LCodeList.size(); iSQ++) {
+		LInt LCode = LCodeList[iSQ];
+		UInt index = hgp_os_eri_pair_index(LCode);
+		if (index >= HGP_OS_ERI_PAIR_REGISTRY_SIZE) continue;
+		const hgp_os_eri_pair_entry& pair = hgp_os_eri_pair_registry[index];
+		const hgp_os_eri_entry* entry = eriEntry(LCode);
+		if (pair.func == NULL || entry == NULL) continue;
+		vector<Double> braCoe;
+		vector<Double> ketCoe;
+		formPairCoe(nLBraList[iSQ],inp,icoe,jnp,jcoe,braCoe);
+		formPairCoe(nLKetList[iSQ],knp,kcoe,lnp,lcoe,ketCoe);
+		braPair.build(inp,&iexp.front(),A,jnp,&jexp.front(),B,nLBraList[iSQ],&braCoe.front());
+		ketPair.build(knp,&kexp.front(),C,lnp,&lexp.front(),D,nLKetList[iSQ],&ketCoe.front());
+		nTested++;
+
+		// the records themselves
+		bool passed = true;
+		if (! checkShellPair(braPair,bra,braCoe) || ! checkShellPair(ketPair,ket,ketCoe)) {
+			cout << "the shell pair record does not match the pair data for the LCode " << LCode << endl;
+			passed = false;
+		}
+
+		// now the variant
+		vector<Double> ref(pair.nInts,ZERO);
+		vector<Double> result(pair.nInts,ZERO);
+		Double pmax  = ONE;
+		Double omega = ZERO;
+		plainERI(entry->func,ZERO,bra,braCoe,ket,ketCoe,ref);
+		pair.func(braPair,ketPair,pmax,omega,&result.front() KERNEL_SCR);
+		if (! sameResult("shell pair record",LCode,ref,result)) passed = false;
+		if (! passed) nFailed++;
+	}
+	report("shell pair record",nTested,nTested,nFailed);
+}
+
+void registrytest::kets_test(const Int& maxL,
+		const Int& inp, const vector<Double>& icoe, const vector<Double>& iexp, const Double* A,
+		const Int& jnp, const vector<Double>& jcoe, const vector<Double>& jexp, const Double* B,
+		const Int& knp, const vector<Double>& kcoe, const vector<Double>& kexp, const Double* C,
+		const Int& lnp, const vector<Double>& lcoe, const vector<Double>& lexp, const Double* D)
+{
+	cout << "**************************************************************" << endl;
+	cout << "ket list ERI variants test:" << endl;
+	cout << "**************************************************************" << endl;
+	vector<LInt> LCodeList;
+	vector<Int> nLBraList;
+	vector<Int> nLKetList;
+	formQuartetList(maxL,LCodeList,nLBraList,nLKetList);
+	PairData bra(inp,iexp,A,jnp,jexp,B);
+
+	//
+	// the kets are on different centers, and the last one swaps 
+	// the exponents and coefficients of shell k and l; all of 
+	// them are in the same L class
+	//
+	const UInt nKets = 3;
+	const Int* npList[][2]             = {{&knp,&lnp}, {&knp,&lnp}, {&lnp,&knp}};
+	const vector<Double>* coeList[][2] = {{&kcoe,&lcoe}, {&kcoe,&lcoe}, {&lcoe,&kcoe}};
+	const vector<Double>* expList[][2] = {{&kexp,&lexp}, {&kexp,&lexp}, {&lexp,&kexp}};
+	const Double* cenList[][2]         = {{C,D}, {B,D}, {C,A}};
+	vector<PairData> kets;
+	for(UInt i=0; i<nKets; i++) {
+		kets.push_back(PairData(*npList[i][0],*expList[i][0],cenList[i][0],
+					*npList[i][1],*expList[i][1],cenList[i][1]));
+	}
+
+	ShellPair<Double> braPair;
+	vector<ShellPair<Double> > ketPairs(nKets);
+	Int nTested  = 0;
+	Int nFailed  = 0;
+	for(UInt iSQ=0; iSQ<LCodeList.size(); iSQ++) {
+		LInt LCode = LCodeList[iSQ];
+		UInt index = hgp_os_eri_kets_index(LCode);
+		if (index >= HGP_OS_ERI_KETS_REGISTRY_SIZE) continue;
+		const hgp_os_eri_kets_entry& ketList = hgp_os_eri_kets_registry[index];
+		const hgp_os_eri_entry* entry = eriEntry(LCode);
+		if (ketList.func == NULL || entry == NULL) continue;
+
+		// form the records
+		vector<Double> braCoe;
+		formPairCoe(nLBraList[iSQ],inp,icoe,jnp,jcoe,braCoe);
+		braPair.build(inp,&iexp.front(),A,jnp,&jexp.front(),B,nLBraList[iSQ],&braCoe.front());
+		vector<vector<Double> > ketCoe(nKets);
+		for(UInt i=0; i<nKets; i++) {
+			formPairCoe(nLKetList[iSQ],*npList[i][0],*coeList[i][0],*npList[i][1],*coeList[i][1],ketCoe[i]);
+			ketPairs[i].build(*npList[i][0],&(*expList[i][0]).front(),cenList[i][0],
+					*npList[i][1],&(*expList[i][1]).front(),cenList[i][1],nLKetList[iSQ],&ketCoe[i].front());
+		}
+
+		// the results of ket i are in abcdKets+i*nInts
+		UInt nInts = ketList.nInts;
+		vector<Double> result(nKets*nInts,ZERO);
+		Double pmax  = ONE;
+		Double omega = ZERO;
+		ketList.func(braPair,nKets,&ketPairs.front(),pmax,omega,&result.front() KERNEL_SCR);
+		nTested++;
+		bool passed = true;
+		for(UInt i=0; i<nKets; i++) {
+			vector<Double> ref(nInts,ZERO);
+			plainERI(entry->func,ZERO,bra,braCoe,kets[i],ketCoe[i],ref);
+			vector<Double> block(result.begin()+i*nInts,result.begin()+(i+1)*nInts);
+			if (! sameResult("ket list",LCode,ref,block)) passed = false;
+		}
+		if (! passed) nFailed++;
+	}
+	report("ket list",nTested,nTested,nFailed);
+}
+
+void registrytest::erf_test(const Int& maxL, const Double& omega,
+		const Int& inp, const vector<Double>& icoe, const vector<Double>& iexp, const Double* A,
+		const Int& jnp, const vector<Double>& jcoe, const vector<Double>& jexp, const Double* B,
+		const Int& knp, const vector<Double>& kcoe, const vector<Double>& kexp, const Double* C,
+		const Int& lnp, const vector<Double>& lcoe, const vector<Double>& lexp, const Double* D)
+{
+	cout << "**************************************************************" << endl;
+	cout << "erf(omega*r12)/r12 ERI variants test with omega " << omega << ":" << endl;
+	cout << "**************************************************************" << endl;
+	vector<LInt> LCodeList;
+	vector<Int> nLBraList;
+	vector<Int> nLKetList;
+	formQuartetList(maxL,LCodeList,nLBraList,nLKetList);
+	PairData bra(inp,iexp,A,jnp,jexp,B);
+	PairData ket(knp,kexp,C,lnp,lexp,D);
+
+	Int nTested  = 0;
+	Int nVariant = 0;
+	Int nFailed  = 0;
+	for(UInt iSQ=0; iSQ<LCodeList.size(); iSQ++) {
+		LInt LCode = LCodeList[iSQ];
+		const hgp_os_eri_entry* entry = eriEntry(LCode);
+		if (entry == NULL) continue;
+		vector<Double> braCoe;
+		vector<Double> ketCoe;
+		formPairCoe(nLBraList[iSQ],inp,icoe,jnp,jcoe,braCoe);
+		formPairCoe(nLKetList[iSQ],knp,kcoe,lnp,lcoe,ketCoe);
+		vector<Double> ref(entry->nInts,ZERO);
+		if (! runtimeOmegaERI(LCode,omega,bra,braCoe,ket,ketCoe,ref)) continue;
+
+		// the entry function calls the erf variant for the non-zero omega
+		vector<Double> result(entry->nInts,ZERO);
+		entryERI(LCode,omega,bra,braCoe,ket,ketCoe,result);
+		nTested++;
+		if (entry->erf != NULL) nVariant++;
+		if (! sameResult("erf",LCode,ref,result)) nFailed++;
+	}
+	report("erf",nTested,nVariant,nFailed);
+}
+
+void registrytest::rs_test(const Int& maxL, const Double& omega,
+		const Int& inp, const vector<Double>& icoe, const vector<Double>& iexp, const Double* A,
+		const Int& jnp, const vector<Double>& jcoe, const vector<Double>& jexp, const Double* B,
+		const Int& knp, const vector<Double>& kcoe, const vector<Double>& kexp, const Double* C,
+		const Int& lnp, const vector<Double>& lcoe, const vector<Double>& lexp, const Double* D)
+{
+	cout << "**************************************************************" << endl;
+	cout << "range separated ERI variants test with omega " << omega << ":" << endl;
+	cout << "**************************************************************" << endl;
+	vector<LInt> LCodeList;
+	vector<Int> nLBraList;
+	vector<Int> nLKetList;
+	formQuartetList(maxL,LCodeList,nLBraList,nLKetList);
+	PairData bra(inp,iexp,A,jnp,jexp,B);
+	PairData ket(knp,kexp,C,lnp,lexp,D);
+
+	// the (coulFac,erfFac) pairs: the pure 1/r12, the pure erf(omega*r12)/r12
+	// and the erfc(omega*r12)/r12
+	const Int nFacs = 3;
+	const Double coulFacList[] = {ONE, ZERO, ONE};
+	const Double erfFacList[]  = {ZERO, ONE, MINUS_ONE};
+
+	Int nTested  = 0;
+	Int nFailed  = 0;
+	for(UInt iSQ=0; iSQ<LCodeList.size(); iSQ++) {
+		LInt LCode = LCodeList[iSQ];
+		UInt index = hgp_os_eri_rs_index(LCode);
+		if (index >= HGP_OS_ERI_RS_REGISTRY_SIZE) continue;
+		const hgp_os_eri_rs_entry& rs = hgp_os_eri_rs_registry[index];
+		const hgp_os_eri_entry* entry = eriEntry(LCode);
+		if (rs.func == NULL || entry == NULL) continue;
+		vector<Double> braCoe;
+		vector<Double> ketCoe;
+		formPairCoe(nLBraList[iSQ],inp,icoe,jnp,jcoe,braCoe);
+		formPairCoe(nLKetList[iSQ],knp,kcoe,lnp,lcoe,ketCoe);
+
+		// the two operators are calculated separately through the
+		// entry function, which is tested in the erf job
+		UInt nInts = rs.nInts;
+		vector<Double> coulInts(nInts,ZERO);
+		vector<Double> erfInts(nInts,ZERO);
+		entryERI(LCode,ZERO,bra,braCoe,ket,ketCoe,coulInts);
+		entryERI(LCode,omega,bra,braCoe,ket,ketCoe,erfInts);
+		nTested++;
+		bool passed = true;
+		for(Int iFac=0; iFac<nFacs; iFac++) {
+			vector<Double> ref(nInts,ZERO);
+			for(UInt i=0; i<nInts; i++) {
+				ref[i] = coulFacList[iFac]*coulInts[i]+erfFacList[iFac]*erfInts[i];
+			}
+			vector<Double> result(nInts,ZERO);
+			Double pmax = ONE;
+			rs.func(bra.np2,ket.np2,pmax,omega,coulFacList[iFac],erfFacList[iFac],
+					&braCoe.front(),&bra.oned.front(),&bra.fac.front(),&bra.P.front(),bra.A,bra.B,
+					&ketCoe.front(),&ket.oned.front(),&ket.fac.front(),&ket.P.front(),ket.A,ket.B,
+					&result.front() KERNEL_SCR);
+			if (! sameResult("range separated",LCode,ref,result)) passed = false;
+		}
+		if (! passed) nFailed++;
+	}
+	report("range separated",nTested,nTested,nFailed);
+}
+
+/**
+ * the name of integral function for the shell quartet without composite
+ * shells, e.g. hgp_os_eri_d_p_p_s
+ */
+static string eriFuncName(const LInt& LCode)
+{
+	string name = "hgp_os_eri";
+	LInt units[] = {1, LCODE_UNIT_BRA2, LCODE_UNIT_KET1, LCODE_UNIT_KET2};
+	for(Int i=0; i<4; i++) {
+		Int L = (LCode/units[i])%LCODE_UNIT_BRA2;
+		for(Int iShell=0; iShell<MAX_SHELL_TYPES; iShell++) {
+			if (SHELL_ANG_MOM_CODE[iShell] == L) {
+				string shell = SHELL_NAME_LIST[iShell];
+				std::transform(shell.begin(),shell.end(),shell.begin(),::tolower);
+				name = name + "_" + shell;
+				break;
+			}
+		}
+	}
+	return name;
+}
+
+void registrytest::rrinterp_test(const Int& maxL, const Double& omega,
+		const Int& inp, const vector<Double>& icoe, const vector<Double>& iexp, const Double* A,
+		const Int& jnp, const vector<Double>& jcoe, const vector<Double>& jexp, const Double* B,
+		const Int& knp, const vector<Double>& kcoe, const vector<Double>& kexp, const Double* C,
+		const Int& lnp, const vector<Double>& lcoe, const vector<Double>& lexp, const Double* D)
+{
+	cout << "**************************************************************" << endl;
+	cout << "RR bytecode interpreter test:" << endl;
+	cout << "**************************************************************" << endl;
+	vector<LInt> LCodeList;
+	vector<Int> nLBraList;
+	vector<Int> nLKetList;
+	formQuartetList(maxL,LCodeList,nLBraList,nLKetList);
+	PairData bra(inp,iexp,A,jnp,jexp,B);
+	PairData ket(knp,kexp,C,lnp,lexp,D);
+
+	//
+	// the interpreter is compared with the compiled function for 1/r12,
+	// and with the entry function for the given omega
+	//
+	const Double omegaList[] = {ZERO, omega};
+	Int nTested  = 0;
+	Int nFailed  = 0;
+	for(UInt iSQ=0; iSQ<LCodeList.size(); iSQ++) {
+
+		// the bytecode is only for the shell quartets without composite shells
+		LInt LCode = LCodeList[iSQ];
+		if (nLBraList[iSQ] != 1 || nLKetList[iSQ] != 1) continue;
+		const hgp_os_eri_entry* entry = eriEntry(LCode);
+		if (entry == NULL) continue;
+		vector<Double> braCoe;
+		vector<Double> ketCoe;
+		formPairCoe(1,inp,icoe,jnp,jcoe,braCoe);
+		formPairCoe(1,knp,kcoe,lnp,lcoe,ketCoe);
+		const RRProgram& program = getRRProgram(eriFuncName(LCode));
+		nTested++;
+		bool passed = true;
+		for(Int iOmega=0; iOmega<2; iOmega++) {
+			vector<Double> ref(entry->nInts,ZERO);
+			if (iOmega == 0) {
+				plainERI(entry->func,ZERO,bra,braCoe,ket,ketCoe,ref);
+			}else{
+				entryERI(LCode,omegaList[iOmega],bra,braCoe,ket,ketCoe,ref);
+			}
+			vector<Double> result(entry->nInts,ZERO);
+			Double pmax = ONE;
+			program.eri(bra.np2,ket.np2,pmax,omegaList[iOmega],
+					&braCoe.front(),&bra.oned.front(),&bra.fac.front(),&bra.P.front(),bra.A,bra.B,
+					&ketCoe.front(),&ket.oned.front(),&ket.fac.front(),&ket.P.front(),ket.A,ket.B,
+					&result.front());
+			if (! sameResult("RR interpreter",LCode,ref,result)) passed = false;
+		}
+		if (! passed) nFailed++;
+	}
+	report("RR interpreter",nTested,nTested,nFailed);
+}
@@ -20,6 +20,16 @@
 // value.
 // see the sing.log and double.log for the test results.
 //
+// Oct 19th 2026:
+//
+// the ERI codes generated with hrr_template = true (maxl = 2 and 
+// kernel_registry = true for the entry function) are tested with
+// "./test eri reentrant maxl=2", the test is built with the
+// thread local scr. All of results are below the thresh value.
+// the same for the codes generated with hrr_matrix_min_l = 2 in 
+// addition, so that the (d,s), (p,p), (d,p) and (d,d) sides go through 
+// hrrMatrix and the lower ones through hrr.
+//
 
 #include "libgen.h"
 #include "ov.h"
@@ -30,6 +40,7 @@
 #include "eritest.h"
 #include "mom.h"
 #include "expr12test.h"
+#include "registrytest.h"
 #include <boost/algorithm/string.hpp>   // string handling
 #include <boost/lexical_cast.hpp>
 using namespace ov;
@@ -40,6 +51,7 @@ using namespace nai;
 using namespace eritest;
 using namespace mom;
 using namespace expr12test;
+using namespace registrytest;
 
 Int main(int argc, char* argv[])
 {
@@ -58,6 +70,17 @@ Int main(int argc, char* argv[])
 	bool test2BodyERI = false;
 	bool test3BodyERI = false;
 	bool testEXPR12   = false;
+	bool testReentrancy = false;
+	bool testSameCenter = false;
+	bool testSymmetry = false;
+	bool testGC = false;
+	bool testSig = false;
+	bool testPair = false;
+	bool testKets = false;
+	bool testErf = false;
+	bool testRS = false;
+	bool testRRInterp = false;
+	bool testGeminal = false;
 
 	// settings we need to further processed
 	// here is default value
@@ -65,6 +88,11 @@ Int main(int argc, char* argv[])
 	Int maxL    = 4;
 	Int auxMaxL = 5;
 	Int momL    = 5;
+	Int nThreads = 64;
+	Int nRounds  = 4;
+
+	// omega for the jobs of the erf(omega*r12)/r12 variants
+	Double omega = 0.45E0;
 
 	// parse the input parameter
 	for(Int i=1; i<argc; i++) {
@@ -80,6 +108,20 @@ Int main(int argc, char* argv[])
 		if (com == "2eri" ) test2BodyERI = true;
 		if (com == "3eri" ) test3BodyERI = true;
 		if (com == "expr12") testEXPR12  = true;
+		if (com == "reentrant") testReentrancy = true;
+		if (com == "samecenter") testSameCenter = true;
+		if (com == "symmetry") testSymmetry = true;
+		if (com == "gc") testGC = true;
+		if (com == "sig") testSig = true;
+		if (com == "pair") testPair = true;
+		if (com == "kets") testKets = true;
+		if (com == "erf") testErf = true;
+		if (com == "rs") testRS = true;
+		if (com == "rrinterp") testRRInterp = true;
+		if (com == "geminal") testGeminal = true;
+
+		// the codes generated with smaller maxl could be tested with "maxl=n"
+		if (com.compare(0,5,"maxl=") == 0) maxL = boost::lexical_cast<Int>(com.substr(5));
 	}
 
 	// now print out the input information
@@ -98,6 +140,17 @@ Int main(int argc, char* argv[])
 	if (test3BodyERI) cout << "three body ERI" << endl;
 	if (testMOM) cout << "momentum integrals" << endl;
 	if (testEXPR12) cout << "expr12 integrals" << endl;
+	if (testReentrancy) cout << "ERI reentrancy with " << nThreads << " threads" << endl;
+	if (testSameCenter) cout << "same center ERI variants" << endl;
+	if (testSymmetry) cout << "permutational symmetry ERI variants" << endl;
+	if (testGC) cout << "general contraction ERI variants" << endl;
+	if (testSig) cout << "significant pair list ERI variants" << endl;
+	if (testPair) cout << "shell pair record ERI variants" << endl;
+	if (testKets) cout << "ket list ERI variants" << endl;
+	if (testErf) cout << "erf(omega*r12)/r12 ERI variants" << endl;
+	if (testRS) cout << "range separated ERI variants" << endl;
+	if (testRRInterp) cout << "RR bytecode interpreter" << endl;
+	if (testGeminal) cout << "geminal expr12 integrals" << endl;
 	cout << "********************************" << endl;
 
 	/////////////////////////////////////////////////////////////////////////////
@@ -276,6 +329,91 @@ Int main(int argc, char* argv[])
 				jnp,jcoe,jexp,B,
 				knp,kcoe,kexp,C);
 	}
+	if (testReentrancy) {
+		eri_reentrancy_test(maxL,nThreads,nRounds,
+				inp,icoe,iexp,A,
+				jnp,jcoe,jexp,B,
+				knp,kcoe,kexp,C,
+				lnp,lcoe,lexp,D);
+	}
+
+	// the jobs below test the variant kernels in the registry
+#ifdef WITH_KERNEL_REGISTRY
+	if (testSameCenter) {
+		same_center_test(maxL,
+				inp,icoe,iexp,A,
+				jnp,jcoe,jexp,B,
+				knp,kcoe,kexp,C,
+				lnp,lcoe,lexp,D);
+	}
+	if (testSymmetry) {
+		symmetry_test(maxL,
+				inp,icoe,iexp,A,
+				jnp,jcoe,jexp,B,
+				knp,kcoe,kexp,C,
+				lnp,lcoe,lexp,D);
+	}
+	if (testGC) {
+		gc_test(maxL,
+				inp,icoe,iexp,A,
+				jnp,jcoe,jexp,B,
+				knp,kcoe,kexp,C,
+				lnp,lcoe,lexp,D);
+	}
+	if (testSig) {
+		sig_test(maxL,
+				inp,icoe,iexp,A,
+				jnp,jcoe,jexp,B,
+				knp,kcoe,kexp,C,
+				lnp,lcoe,lexp,D);
+	}
+	if (testPair) {
+		pair_test(maxL,
+				inp,icoe,iexp,A,
+				jnp,jcoe,jexp,B,
+				knp,kcoe,kexp,C,
+				lnp,lcoe,lexp,D);
+	}
+	if (testKets) {
+		kets_test(maxL,
+				inp,icoe,iexp,A,
+				jnp,jcoe,jexp,B,
+				knp,kcoe,kexp,C,
+				lnp,lcoe,lexp,D);
+	}
+	if (testErf) {
+		erf_test(maxL,omega,
+				inp,icoe,iexp,A,
+				jnp,jcoe,jexp,B,
+				knp,kcoe,kexp,C,
+				lnp,lcoe,lexp,D);
+	}
+	if (testRS) {
+		rs_test(maxL,omega,
+				inp,icoe,iexp,A,
+				jnp,jcoe,jexp,B,
+				knp,kcoe,kexp,C,
+				lnp,lcoe,lexp,D);
+	}
+	if (testRRInterp) {
+		rrinterp_test(maxL,omega,
+				inp,icoe,iexp,A,
+				jnp,jcoe,jexp,B,
+				knp,kcoe,kexp,C,
+				lnp,lcoe,lexp,D);
+	}
+	if (testGeminal) {
+		expr12_geminal_test(maxL,
+				inp,icoe,iexp,A,
+				jnp,jcoe,jexp,B,
+				knp,kcoe,kexp,C,
+				lnp,lcoe,lexp,D);
+	}
+#else
+	if (testSameCenter || testSymmetry || testGC || testSig || testPair || testKets || testErf || testRS || testRRInterp || testGeminal) {
+		cout << "the variant jobs require the test built with KERNEL_REGISTRY=true" << endl;
+	}
+#endif
 	cout << "all of jobs finished" << endl;
 
 	return 0;
@@ -13,10 +13,25 @@ using namespace tov;
 using namespace localmemscr;
 using namespace tki;
 
+#ifdef WITH_THREAD_LOCAL_SCR
+// generated with scr_source = thread_local, see the eritest.cpp
+extern void hgp_os_threebodyki(const LInt& LCode, const UInt& inp2, const UInt& jnp2, 
+		const Double* icoe, const Double* iexp, const Double* iexpdiff, 
+		const Double* ifac,  const Double* P, const Double* A, const Double* B, 
+		const Double* jcoe, const Double* jexp, const Double* C, Double* abcd);
+inline void hgp_os_threebodyki(const LInt& LCode, const UInt& inp2, const UInt& jnp2, 
+		const Double* icoe, const Double* iexp, const Double* iexpdiff, 
+		const Double* ifac,  const Double* P, const Double* A, const Double* B, 
+		const Double* jcoe, const Double* jexp, const Double* C, Double* abcd, LocalMemScr& scr)
+{
+	hgp_os_threebodyki(LCode,inp2,jnp2,icoe,iexp,iexpdiff,ifac,P,A,B,jcoe,jexp,C,abcd);
+}
+#else
 extern void hgp_os_threebodyki(const LInt& LCode, const UInt& inp2, const UInt& jnp2, 
 		const Double* icoe, const Double* iexp, const Double* iexpdiff, 
 		const Double* ifac,  const Double* P, const Double* A, const Double* B, 
 		const Double* jcoe, const Double* jexp, const Double* C, Double* abcd, LocalMemScr& scr);
+#endif
 
 Double tki::threeki(const Double& alpha, const Double& beta, const Double& gamma,
 		const Double* A, const Double* B, const Double* C,
@@ -0,0 +1,163 @@
+"""
+this file is used to benchmark the speed of cppints itself. It runs
+the generator for a fixed matrix of jobs (operator, maxl and derivative
+order), and for each of them it records the wall time, the peak memory
+(RSS) and the time spent in each stage of code generation (see the
+stage_timing keyword and stagetimer.h). The result is compared with
+the stored baseline, and the regressions are reported.
+
+usage:
+python genbench.py [options]
+--cppints  path   the cppints program (default ./cppints)
+--jobs     list   operators in the matrix (default "ERI NAI ESP")
+--maxl     list   maxl in the matrix (default "2 3 4 5 6")
+--deriv    list   derivative orders in the matrix (default "0 1 2")
+--workdir  path   folder for running the generator (default genbench_work)
+--output   file   where the result is written (default genbench_result.json)
+--baseline file   the stored baseline (default genbench_baseline.json)
+--tolerance x     the relative slow down treated as regression (default 0.10)
+--min-time x      the time (in seconds) below it is not compared (default 0.5)
+--save            store the result as the new baseline
+
+the program returns 1 if any regression is found, so it could be used
+in a test script.
+"""
+from __future__ import print_function
+__author__  = "Fenglai Liu"
+import sys
+import os
+import time
+import json
+import shutil
+import subprocess
+
+# the stages reported by the generator, see stagetimer.cpp
+stages = ["rrsq_search", "form_rrsq_list", "sub_files", "printing", "assembly", "other"]
+
+def parseArgs(argv):
+    """
+    parse the command line, return the option dict
+    """
+    opt = {"cppints": "./cppints", "jobs": "ERI NAI ESP", "maxl": "2 3 4 5 6",
+            "deriv": "0 1 2", "workdir": "genbench_work", "output": "genbench_result.json",
+            "baseline": "genbench_baseline.json", "tolerance": "0.10", "min-time": "0.5",
+            "save": False}
+    i = 1
+    while i < len(argv):
+        key = argv[i]
+        if not key.startswith("--") or key[2:] not in opt:
+            print("unknown option: ", key)
+            sys.exit(2)
+        key = key[2:]
+        if key == "save":
+            opt[key] = True
+            i = i + 1
+            continue
+        if i+1 >= len(argv):
+            print("missing value for the option: ", key)
+            sys.exit(2)
+        opt[key] = argv[i+1]
+        i = i + 2
+    return opt
+
+def runJob(opt, job, maxl, deriv):
+    """
+    run the generator for one job, return the record of timing
+    """
+    cppints = os.path.abspath(opt["cppints"])
+    work = os.path.join(opt["workdir"], "%s_l%d_d%d" % (job, maxl, deriv))
+    if os.path.exists(work):
+        shutil.rmtree(work)
+    os.makedirs(work)
+    f = open(os.path.join(work, "infor.txt"), "w")
+    f.write("job_list     = %s\n" % job)
+    f.write("maxl         = %d\n" % maxl)
+    f.write("aux_max_l    = %d\n" % maxl)
+    f.write("deriv_order  = %d\n" % deriv)
+    f.write("stage_timing = true\n")
+    f.close()
+
+    # the peak RSS is taken from the rusage of the child process
+    log = open(os.path.join(work, "cppints.log"), "w")
+    start = time.time()
+    p = subprocess.Popen([cppints, "infor.txt"], cwd=work, stdout=log, stderr=subprocess.STDOUT)
+    pid, status, usage = os.wait4(p.pid, 0)
+    wall = time.time() - start
+    log.close()
+    if status != 0:
+        print("cppints failed for %s, see %s" % (work, os.path.join(work, "cppints.log")))
+        sys.exit(2)
+    record = {"wall": wall, "peak_rss_kb": usage.ru_maxrss}
+    timing = json.load(open(os.path.join(work, "stage_timing.json")))
+    for s in stages:
+        record[s] = timing[s]
+
+    # we do not keep the generated code
+    shutil.rmtree(os.path.join(work, "hgp_os"), ignore_errors=True)
+    return record
+
+def compare(result, baseline, tolerance, minTime):
+    """
+    compare the result with baseline, return the list of regressions
+    """
+    regressions = []
+    for name in sorted(result.keys()):
+        if name not in baseline:
+            continue
+        new = result[name]
+        old = baseline[name]
+        for key in ["wall", "peak_rss_kb"] + stages:
+            if key not in old:
+                continue
+            if key != "peak_rss_kb" and old[key] < minTime:
+                continue
+            if new[key] > old[key]*(1.0+tolerance):
+                regressions.append("%-16s %-16s %14.3f -> %14.3f (%+.1f%%)" %
+                        (name, key, old[key], new[key], 100.0*(new[key]/old[key]-1.0)))
+    return regressions
+
+def main():
+    opt = parseArgs(sys.argv)
+    if not os.path.isfile(opt["cppints"]):
+        print("the cppints program is not found: ", opt["cppints"])
+        sys.exit(2)
+
+    # run the matrix of jobs
+    result = {}
+    for job in opt["jobs"].split():
+        for maxl in [int(x) for x in opt["maxl"].split()]:
+            for deriv in [int(x) for x in opt["deriv"].split()]:
+                name = "%s_l%d_d%d" % (job, maxl, deriv)
+                record = runJob(opt, job, maxl, deriv)
+                result[name] = record
+                line = "%-16s wall %10.3f s  peak rss %10d kb" % (name, record["wall"], record["peak_rss_kb"])
+                for s in stages:
+                    line = line + "  %s %.3f" % (s, record[s])
+                print(line)
+                sys.stdout.flush()
+    f = open(opt["output"], "w")
+    json.dump(result, f, indent=2, sort_keys=True)
+    f.close()
+
+    # store the baseline
+    if opt["save"]:
+        shutil.copyfile(opt["output"], opt["baseline"])
+        print("the baseline is stored in ", opt["baseline"])
+        return 0
+
+    # compare with the baseline
+    if not os.path.isfile(opt["baseline"]):
+        print("no baseline found in %s, use --save to store one" % opt["baseline"])
+        return 0
+    baseline = json.load(open(opt["baseline"]))
+    regressions = compare(result, baseline, float(opt["tolerance"]), float(opt["min-time"]))
+    if len(regressions) == 0:
+        print("no regression found against ", opt["baseline"])
+        return 0
+    print("regressions found against %s:" % opt["baseline"])
+    for r in regressions:
+        print(r)
+    return 1
+
+if __name__ == "__main__":
+    sys.exit(main())
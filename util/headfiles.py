@@ -245,6 +245,43 @@ def useLocalMemScrObject(workDir):
     # finally, we get nothing
     return False
 
+def useThreadLocalMemScr(workDir):
+    """
+    whether the cpp files in this project take the scr from the thread
+    local memory pool (scr_source = thread_local), in this case the
+    localmemscr object is not in the argument list
+    """
+    cppfiles = os.listdir(workDir)
+    for i in cppfiles:
+
+        # we will omit the non-main cpp files
+        if not isMainCPPFile(i):
+            continue
+
+        # search the function body
+        workFile = workDir + "/" + i
+        f = open(workFile, "r")
+        content = f.read()
+        f.close()
+        if re.search(r"threadLocalMemScr\(", content) is not None:
+            return True
+
+    # finally, we get nothing
+    return False
+
+def hasSCRLengthFunction(fname, funcName):
+    """
+    whether the given cpp file has the scr length function
+    "UInt funcName_scr_len()" generated together with the integral function
+    """
+    f = open(fname, "r")
+    content = f.read()
+    f.close()
+    line = "UInt " + funcName + "_scr_len()"
+    if content.find(line) >= 0:
+        return True
+    return False
+
 def filesCreation(workDir):
     """
     print out the head files as well as cpp entry files to call the function
@@ -256,6 +293,7 @@ def filesCreation(workDir):
     # firstly, we need to search the whole folder to see that
     # whether we have localmemscr class used in the cpp files
     hasLocalMemScr = useLocalMemScrObject(workDir)
+    hasThreadLocalMemScr = useThreadLocalMemScr(workDir)
 
     # get the project name from the dir
     name = getProjectName(workDir)
@@ -277,7 +315,7 @@ def filesCreation(workDir):
     printCode(head, line)
     line = "#include <cstdio>"
     printCode(head, line)
-    if hasLocalMemScr:
+    if hasLocalMemScr or hasThreadLocalMemScr:
         line = "#include \"localmemscr.h\""
         printCode(head, line)
         line = "using namespace localmemscr;"
@@ -286,7 +324,7 @@ def filesCreation(workDir):
 
     # typedef information
     # only use it when we do not include localmemscr
-    if not hasLocalMemScr:
+    if not hasLocalMemScr and not hasThreadLocalMemScr:
         line = "typedef int             Int; "
         printCode(head, line)
         line = "typedef long long       LInt; "
@@ -361,6 +399,8 @@ def filesCreation(workDir):
     printCode(cpp, line, 2)
 
     # now loop over the dir to get each file name
+    # the functions with scr length function are recorded, too
+    scrLenFuncList = []
     cppfiles = os.listdir(workDir)
     for i in cppfiles:
 
@@ -378,6 +418,10 @@ def filesCreation(workDir):
         fname = flist[0]
         line = returnType + fname + "(" + arglist + ");"
         printCode(head, line)
+        if hasSCRLengthFunction(workFile, fname):
+            line = "UInt " + fname + "_scr_len();"
+            printCode(head, line)
+            scrLenFuncList.append(fname)
         printEmptyLine(head)
 
         # now print the entry cpp file
@@ -393,6 +437,11 @@ def filesCreation(workDir):
         line = "break;"
         printCode(cpp, line, 6)
 
+    # the scr length entry function
+    line = "UInt " + name + "_scr_len(const LInt& LCode);"
+    printCode(head, line)
+    printEmptyLine(head)
+
     # finish the head file printingg
     line = "#endif"
     printCode(head, line)
@@ -416,6 +465,30 @@ def filesCreation(workDir):
     # finish the whole function code
     line = "}"
     printCode(cpp, line)
+
+    # the scr length entry function, it returns the scr length
+    # (in unit of Double) required by the integral function of
+    # the given LCode; for the ones do not use scr it's 0
+    printEmptyLine(cpp)
+    line = "UInt " + name + "_scr_len(const LInt& LCode)"
+    printCode(cpp, line)
+    line = "{"
+    printCode(cpp, line)
+    line = "switch (LCode) {"
+    printCode(cpp, line, 2)
+    for fname in scrLenFuncList:
+        line = "case " + str(getLCode(fname)) + ":"
+        printCode(cpp, line, 4)
+        line = "return " + fname + "_scr_len();"
+        printCode(cpp, line, 6)
+    line = "default:"
+    printCode(cpp, line, 4)
+    line = "return 0;"
+    printCode(cpp, line, 6)
+    line = "}"
+    printCode(cpp, line, 2)
+    line = "}"
+    printCode(cpp, line)
     cpp.close()
 
 ########################################################